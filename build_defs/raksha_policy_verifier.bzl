@@ -29,7 +29,8 @@ def raksha_policy_verifier_library(
         visibility = None,
         policy_verifier_interfaces = ["//src/analysis/souffle:policy_verifier_interface.dl"],
         additional_dl_files = [],
-        additional_souffle_cc_lib_dependencies = []):
+        additional_souffle_cc_lib_dependencies = [],
+        flat_operation_facts = False):
     """Generates corresponding datalog file for each policy.
 
     Args:
@@ -39,6 +40,7 @@ def raksha_policy_verifier_library(
       policy_verifier_interfaces: list; policy verifier interface target.
       additional_dl_files: list; list of additional dl file targets.
       additional_souffle_cc_lib_dependencies: list; list of all souffle cc library dependencies.
+      flat_operation_facts: bool; Whether the verifier takes operations in the flat encoding.
     """
 
     auth_logic_file = "%s_combined_auth_logic" % name
@@ -57,6 +59,7 @@ def raksha_policy_verifier_library(
         policy_verifier_interfaces,
         additional_dl_files,
         additional_souffle_cc_lib_dependencies,
+        flat_operation_facts,
     )
 
 def policy_library(
@@ -65,7 +68,8 @@ def policy_library(
         visibility = None,
         policy_verifier_interfaces = ["//src/analysis/souffle:policy_verifier_interface.dl"],
         additional_dl_files = [],
-        additional_souffle_cc_lib_dependencies = []):
+        additional_souffle_cc_lib_dependencies = [],
+        flat_operation_facts = False):
     """ Generates a cc_library rule for verifying policy compliance.
 
     Args:
@@ -75,6 +79,7 @@ def policy_library(
       policy_verifier_interfaces: list; policy verifier interface target.
       additional_dl_files: list; list of additional dl file targets.
       additional_souffle_cc_lib_dependencies: list; list of all souffle cc library dependencies.
+      flat_operation_facts: bool; Whether the verifier takes operations in the flat encoding.
     """
 
     #TODO (b/232451284) Fix auth_logic_files to be a string. We had to turn auth_logic_files
@@ -121,6 +126,7 @@ def policy_library(
         name = datalog_cxx_source_target_name,
         src = generated_datalog_file_from_policy_verifier_interface_and_auth_logic,
         included_dl_scripts = policy_verifier_include_dl_files + additional_dl_files,
+        flat_operation_facts = flat_operation_facts,
         visibility = visibility,
     )
     souffle_cc_library(
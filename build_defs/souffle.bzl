@@ -14,12 +14,29 @@
 # limitations under the License.
 #-----------------------------------------------------------------------------
 
+# Building with `--config=souffle_parallel` generates Souffle programs that
+# evaluate their rules on several threads. The number of threads is chosen per
+# program instance with `SouffleProgram::setNumThreads`; the generated programs
+# use a single thread unless told otherwise.
+_SOUFFLE_PARALLEL = "//build_defs:souffle_parallel"
+
+_SOUFFLE_PARALLEL_COPTS = select({
+    _SOUFFLE_PARALLEL: ["-fopenmp"],
+    "//conditions:default": [],
+})
+
+_SOUFFLE_PARALLEL_LINKOPTS = select({
+    _SOUFFLE_PARALLEL: ["-fopenmp"],
+    "//conditions:default": [],
+})
+
 def gen_souffle_cxx_code(
         name,
         src,
         all_principals_own_all_tags = False,
         included_dl_scripts = [],
         for_test = False,
+        flat_operation_facts = False,
         visibility = None):
     """Generates a C++ file for the given datalog file.
 
@@ -29,6 +46,7 @@ def gen_souffle_cxx_code(
       all_principals_own_all_tags: allows basically turning off the auth logic aspect.
       included_dl_scripts: List; List of labels indicating datalog files included by src.
       for_test: bool; Whether to prepare the generated code to be used in a test environment or not.
+      flat_operation_facts: bool; Whether the program takes operations as the flat relations of operations_flat.dl instead of isOperation records.
       visibility: List; List of visibilities.
     """
 
@@ -60,6 +78,8 @@ def gen_souffle_cxx_code(
         macro_list.append("TEST=1")
     if all_principals_own_all_tags:
         macro_list.append("ALL_PRINCIPALS_OWN_ALL_TAGS=1")
+    if flat_operation_facts:
+        macro_list.append("FLAT_OPERATION_FACTS=1")
 
     macro_str_prefix = ""
     macro_str_suffix = ""
@@ -75,13 +95,17 @@ def gen_souffle_cxx_code(
         if dl_script not in uniq_included_dl_scripts:
             uniq_included_dl_scripts.append(dl_script)
 
+    souffle_cmd = "$(location @souffle//:souffle_64_bit) {include_str} {macros} {{jobs}} -g $@ $(location {src_rule})".format(include_str = include_opts_str, macros = macro_str, src_rule = src)
+
     native.genrule(
         name = name,
         srcs = [src] + uniq_included_dl_scripts,
         outs = [cc_file],
         testonly = testonly,
-        cmd =
-            "$(location @souffle//:souffle_64_bit) {include_str} {macros} -g $@ $(location {src_rule})".format(include_str = include_opts_str, macros = macro_str, src_rule = src),
+        cmd = select({
+            _SOUFFLE_PARALLEL: souffle_cmd.format(jobs = "--jobs=auto"),
+            "//conditions:default": souffle_cmd.format(jobs = ""),
+        }),
         tools = ["@souffle//:souffle_64_bit"],
         visibility = visibility,
     )
@@ -112,12 +136,13 @@ def souffle_cc_library(
             # We didn't author this C++ file, it is generated by Souffle. We
             # don't care about non-critical issues in it. Turn off warnings.
             "-w",
-        ],
+        ] + _SOUFFLE_PARALLEL_COPTS,
         # Turn off header modules, as Google precompiled headers use
         # -fno-exceptions, and combining a precompiled header with
         # -fno-exceptions with a binary that uses -fexceptions makes Clang
         # upset.
         features = ["-use_header_modules"],
+        linkopts = _SOUFFLE_PARALLEL_LINKOPTS,
         defines = [
             "__EMBEDDED_SOUFFLE__",
         ],
@@ -153,12 +178,13 @@ def souffle_cc_binary(
             # We didn't author this C++ file, it is generated by Souffle. We
             # don't care about non-critical issues in it. Turn off warnings.
             "-w",
-        ],
+        ] + _SOUFFLE_PARALLEL_COPTS,
         # Turn off header modules, as Google precompiled headers use
         # -fno-exceptions, and combining a precompiled header with
         # -fno-exceptions with a binary that uses -fexceptions makes Clang
         # upset.
         features = ["-use_header_modules"],
+        linkopts = _SOUFFLE_PARALLEL_LINKOPTS,
         deps = ["@souffle//:souffle_include_lib"] + additional_deps,
         local_defines = ["RAM_DOMAIN_SIZE=64"],
         visibility = visibility,
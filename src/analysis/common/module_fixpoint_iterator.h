@@ -16,10 +16,23 @@
 #ifndef SRC_ANALYSIS_COMMON_MODULE_FIXPOINT_ITERATOR_H_
 #define SRC_ANALYSIS_COMMON_MODULE_FIXPOINT_ITERATOR_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
 
+#include "absl/algorithm/container.h"
+#include "absl/container/btree_set.h"
 #include "absl/container/flat_hash_map.h"
-#include "absl/container/flat_hash_set.h"
+#include "absl/log/check.h"
+#include "absl/types/span.h"
 #include "src/analysis/common/module_graph.h"
 #include "src/common/utils/map_iter.h"
 #include "src/common/utils/overloaded.h"
@@ -28,6 +41,62 @@
 
 namespace raksha::analysis::common {
 
+// A worklist of the operations of a `ModuleGraph` that always hands out the
+// pending operation that comes first in a given order of the operations.
+class OperationPriorityWorklist {
+ public:
+  using NodeId = ModuleGraph::NodeId;
+
+  // An order of the operations of a graph. It can be shared by any number of
+  // worklists over (parts of) the same graph.
+  class Order {
+   public:
+    // Operations are prioritized by their position in `operations`, which
+    // holds the ids of nodes in a graph with `number_of_nodes` nodes.
+    Order(std::vector<NodeId> operations, size_t number_of_nodes)
+        : operations_(std::move(operations)),
+          priorities_(number_of_nodes, kNoPriority) {
+      for (size_t priority = 0; priority < operations_.size(); ++priority) {
+        priorities_[operations_[priority]] = priority;
+      }
+    }
+
+   private:
+    friend class OperationPriorityWorklist;
+
+    static constexpr size_t kNoPriority = std::numeric_limits<size_t>::max();
+
+    std::vector<NodeId> operations_;
+    // The priority of each node, indexed by node id.
+    std::vector<size_t> priorities_;
+  };
+
+  // Creates an empty worklist. The order must outlive the worklist.
+  explicit OperationPriorityWorklist(const Order& order) : order_(order) {}
+
+  bool empty() const { return pending_.empty(); }
+
+  // Adds the operation to the worklist unless it is already pending.
+  void Push(NodeId operation) {
+    CHECK(operation < order_.priorities_.size() &&
+          order_.priorities_[operation] != Order::kNoPriority)
+        << "Operation has no priority in the worklist.";
+    pending_.insert(order_.priorities_[operation]);
+  }
+
+  // Removes and returns the pending operation with the highest priority.
+  NodeId Pop() {
+    CHECK(!pending_.empty()) << "Pop from an empty worklist.";
+    size_t priority = *pending_.begin();
+    pending_.erase(pending_.begin());
+    return order_.operations_[priority];
+  }
+
+ private:
+  const Order& order_;
+  absl::btree_set<size_t> pending_;
+};
+
 template <typename AbstractSemantics>
 class ModuleFixpointIterator {
  public:
@@ -40,58 +109,212 @@ class ModuleFixpointIterator {
   ValueStateMap ComputeFixpoint(const ir::Module& module,
                                 SemanticsMaker semantics_maker) const {
     ModuleGraph module_graph(&module);
+    // Process operations in reverse postorder so that, outside of loops, an
+    // operation is only evaluated once all of its inputs are known.
+    OperationPriorityWorklist::Order order(
+        module_graph.GetOperationIdsInReversePostOrder(),
+        module_graph.NumberOfNodes());
+    NodeStates node_states(module_graph.NumberOfNodes());
+    std::vector<NodeId> nodes(module_graph.NumberOfNodes());
+    std::iota(nodes.begin(), nodes.end(), 0);
+
     AbstractSemantics semantics = semantics_maker(module);
-    ValueStateMap value_states;
-    // TODO(b/264415551): We should use a priority-based worklist
-    absl::flat_hash_set<const ir::Operation*> worklist;
+    ComputeFixpointOfNodes(module_graph, order, semantics, nodes, node_states);
+    return ToValueStateMap(module_graph, std::move(node_states));
+  }
+
+  // Computes the same fixpoint as `ComputeFixpoint`, but solves the weakly
+  // connected components of the module on up to `num_threads` threads.
+  //
+  // `semantics_maker` is called once per thread. The semantics instances and
+  // the states that they create must not share mutable state, and the
+  // semantics must not depend on the order in which the components are
+  // solved.
+  template <typename SemanticsMaker>
+  ValueStateMap ComputeFixpointInParallel(const ir::Module& module,
+                                          SemanticsMaker semantics_maker,
+                                          size_t num_threads) const {
+    ModuleGraph module_graph(&module);
+    OperationPriorityWorklist::Order order(
+        module_graph.GetOperationIdsInReversePostOrder(),
+        module_graph.NumberOfNodes());
+    // Each component only reads and writes the states of its own nodes, so
+    // the components can share this vector.
+    NodeStates node_states(module_graph.NumberOfNodes());
+    std::vector<std::vector<NodeId>> components =
+        module_graph.GetWeaklyConnectedComponents();
+
+    std::atomic<size_t> next_component = 0;
+    auto solve_components = [&]() {
+      AbstractSemantics semantics = semantics_maker(module);
+      for (size_t component = next_component++; component < components.size();
+           component = next_component++) {
+        ComputeFixpointOfNodes(module_graph, order, semantics,
+                               components[component], node_states);
+      }
+    };
+    // The calling thread is one of the threads.
+    num_threads = std::max<size_t>(1, std::min(num_threads, components.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back(solve_components);
+    }
+    solve_components();
+    for (std::thread& thread : threads) thread.join();
+
+    return ToValueStateMap(module_graph, std::move(node_states));
+  }
+
+  // Computes the fixpoint of a module that has been derived from an earlier
+  // version by adding or changing `changed_operations`. `previous_states`
+  // must be the fixpoint of the earlier version.
+  //
+  // The states of all values that do not depend on the changed operations are
+  // taken from `previous_states`. Only values that are reachable from the
+  // changed operations, or from values that have no previous state, are
+  // recomputed. The result is the same as that of `ComputeFixpoint`.
+  template <typename SemanticsMaker>
+  ValueStateMap ComputeFixpointIncrementally(
+      const ir::Module& module, SemanticsMaker semantics_maker,
+      const ValueStateMap& previous_states,
+      absl::Span<const ir::Operation* const> changed_operations) const {
+    ModuleGraph module_graph(&module);
+    OperationPriorityWorklist::Order order(
+        module_graph.GetOperationIdsInReversePostOrder(),
+        module_graph.NumberOfNodes());
+
+    // The changed operations and the entry values without a previous state
+    // invalidate the states of everything that is reachable from them.
+    std::vector<NodeId> changed_nodes;
+    for (const ir::Operation* operation : changed_operations) {
+      changed_nodes.push_back(module_graph.GetNodeId(operation));
+    }
+    for (NodeId node_id = 0; node_id < module_graph.NumberOfNodes();
+         ++node_id) {
+      const auto* value =
+          std::get_if<ir::Value>(&module_graph.GetNode(node_id));
+      if (value != nullptr &&
+          value->If<ir::value::OperationResult>() == nullptr &&
+          !previous_states.contains(*value)) {
+        changed_nodes.push_back(node_id);
+      }
+    }
+    std::vector<bool> affected =
+        GetReachableNodes(module_graph, std::move(changed_nodes));
+
+    NodeStates node_states(module_graph.NumberOfNodes());
+    for (NodeId node_id = 0; node_id < module_graph.NumberOfNodes();
+         ++node_id) {
+      if (affected[node_id]) continue;
+      const auto* value =
+          std::get_if<ir::Value>(&module_graph.GetNode(node_id));
+      if (value == nullptr) continue;
+      auto find_result = previous_states.find(*value);
+      if (find_result != previous_states.end()) {
+        node_states[node_id] = find_result->second;
+      }
+    }
+
+    AbstractSemantics semantics = semantics_maker(module);
+    OperationPriorityWorklist worklist(order);
+    for (NodeId node_id = 0; node_id < module_graph.NumberOfNodes();
+         ++node_id) {
+      if (!affected[node_id]) continue;
+      SeedNode(module_graph, semantics, node_id, worklist, node_states);
+      // An affected operation also has to be evaluated if one of its inputs
+      // keeps its previous state, as no other operation will push it.
+      if (std::holds_alternative<const ir::Operation*>(
+              module_graph.GetNode(node_id)) &&
+          absl::c_any_of(module_graph.GetInputIds(node_id),
+                         [&node_states, &affected](NodeId input) {
+                           return !affected[input] &&
+                                  node_states[input].has_value();
+                         })) {
+        worklist.Push(node_id);
+      }
+    }
+    RunWorklist(module_graph, semantics, worklist, node_states);
+    return ToValueStateMap(module_graph, std::move(node_states));
+  }
+
+ private:
+  using NodeId = ModuleGraph::NodeId;
+  // The state of each node, indexed by node id. During iteration, all nodes
+  // are referred to by their id, so that no hashing is involved.
+  using NodeStates = std::vector<std::optional<AbstractState>>;
 
+  // Computes the fixpoint for the given nodes, which must be closed under the
+  // edges of the graph in both directions.
+  static void ComputeFixpointOfNodes(
+      const ModuleGraph& module_graph,
+      const OperationPriorityWorklist::Order& order,
+      AbstractSemantics& semantics, absl::Span<const NodeId> nodes,
+      NodeStates& node_states) {
+    OperationPriorityWorklist worklist(order);
     // Initialize worklist and get values of entry nodes.
-    for (const auto& node : module_graph.GetNodes()) {
-      std::visit(
-          utils::overloaded{
-              [&value_states, &module_graph, &worklist,
-               &semantics](const ir::Value& value) {
-                // If this is an operation result, nothing needs to be done.
-                // The result for the value will be computed during iteration.
-                if (value.If<ir::value::OperationResult>() != nullptr) return;
-
-                // If this is not an operation result, get the initial value.
-                auto [_, success] = value_states.insert(
-                    {value, semantics.GetInitialState(value)});
-                CHECK(success)
-                    << "Duplicate entry nodes during fixpoint iteration.";
-                // Add all operations that use this value to the worklist.
-                for (const auto [index, operation] :
-                     module_graph.GetUses(value)) {
-                  worklist.insert(operation);
-                }
-              },
-              [&worklist](const ir::Operation* operation_node) {
-                // If an operation has no inputs add it to the initial worklist.
-                const ir::Operation& operation =
-                    *ABSL_DIE_IF_NULL(operation_node);
-                if (operation.inputs().empty()) worklist.insert(&operation);
-              }},
-          node);
+    for (NodeId node_id : nodes) {
+      SeedNode(module_graph, semantics, node_id, worklist, node_states);
     }
+    RunWorklist(module_graph, semantics, worklist, node_states);
+  }
+
+  // Adds the node to the initial worklist if it is an entry node. That is, an
+  // operation without inputs or a value that is not an operation result, which
+  // gets its initial state.
+  static void SeedNode(const ModuleGraph& module_graph,
+                       AbstractSemantics& semantics, NodeId node_id,
+                       OperationPriorityWorklist& worklist,
+                       NodeStates& node_states) {
+    std::visit(
+        utils::overloaded{
+            [&node_states, &module_graph, &worklist, &semantics,
+             node_id](const ir::Value& value) {
+              // If this is an operation result, nothing needs to be done.
+              // The result for the value will be computed during iteration.
+              if (value.If<ir::value::OperationResult>() != nullptr) return;
+
+              // If this is not an operation result, get the initial value.
+              node_states[node_id] = semantics.GetInitialState(value);
+              // Add all operations that use this value to the worklist.
+              for (const auto [index, operation] :
+                   module_graph.GetOutEdgeIds(node_id)) {
+                worklist.Push(operation);
+              }
+            },
+            [&worklist, node_id](const ir::Operation* operation_node) {
+              // If an operation has no inputs add it to the initial worklist.
+              const ir::Operation& operation =
+                  *ABSL_DIE_IF_NULL(operation_node);
+              if (operation.inputs().empty()) worklist.Push(node_id);
+            }},
+        module_graph.GetNode(node_id));
+  }
+
+  // Processes the worklist until no states change anymore.
+  static void RunWorklist(const ModuleGraph& module_graph,
+                          AbstractSemantics& semantics,
+                          OperationPriorityWorklist& worklist,
+                          NodeStates& node_states) {
     // A local lambda to get the current state during fixpoint iteration.
-    auto get_current_state = [&value_states](const ir::Value& value) {
-      auto find_result = value_states.find(value);
-      bool first_visit = (find_result == value_states.end());
+    auto get_current_state = [&node_states](NodeId value) {
+      const std::optional<AbstractState>& state = node_states[value];
+      bool first_visit = !state.has_value();
       return std::make_pair(
-          (first_visit ? AbstractState::Bottom() : find_result->second),
-          first_visit);
+          (first_visit ? AbstractState::Bottom() : *state), first_visit);
     };
 
     while (!worklist.empty()) {
       // Select and remove a node from the worklist.
-      const ir::Operation& operation = *ABSL_DIE_IF_NULL(*worklist.begin());
-      worklist.erase(worklist.begin());
+      NodeId operation_id = worklist.Pop();
+      const ir::Operation& operation = *std::get<const ir::Operation*>(
+          module_graph.GetNode(operation_id));
 
       // Prepare a vector of states corresponding to inputs of the operation.
       std::vector<AbstractState> operation_inputs =
           utils::MapIter<AbstractState>(
-              operation.inputs(), [&get_current_state](const ir::Value& value) {
+              module_graph.GetInputIds(operation_id),
+              [&get_current_state](NodeId value) {
                 return get_current_state(value).first;
               });
 
@@ -102,7 +325,8 @@ class ModuleFixpointIterator {
           << "Transformer for an operation returns insufficient outputs.";
 
       // Push the computed outputs to the corresponding results.
-      for (const auto& [index, target] : module_graph.GetResults(&operation)) {
+      for (const auto& [index, target] :
+           module_graph.GetOutEdgeIds(operation_id)) {
         CHECK(index >= 0 && index < operation_outputs.size())
             << "Edge index in module graph is out of bounds.";
         const AbstractState& edge_out = operation_outputs[index];
@@ -114,14 +338,50 @@ class ModuleFixpointIterator {
 
         if (first_visit ||
             !target_new_state_in.IsEquivalentTo(target_old_state_in)) {
-          value_states.insert_or_assign(target, target_new_state_in);
+          node_states[target] = target_new_state_in;
           // Add all operations that use this value to the worklist.
-          for (const auto& [index, operation] : module_graph.GetUses(target)) {
-            worklist.insert(operation);
+          for (const auto& [index, operation] :
+               module_graph.GetOutEdgeIds(target)) {
+            worklist.Push(operation);
           }
         }
       }
     }
+  }
+
+  // Returns which nodes are reachable from `roots`, indexed by node id.
+  static std::vector<bool> GetReachableNodes(const ModuleGraph& module_graph,
+                                             std::vector<NodeId> roots) {
+    std::vector<bool> reachable(module_graph.NumberOfNodes(), false);
+    std::vector<NodeId> stack;
+    for (NodeId root : roots) {
+      if (reachable[root]) continue;
+      reachable[root] = true;
+      stack.push_back(root);
+    }
+    while (!stack.empty()) {
+      NodeId node_id = stack.back();
+      stack.pop_back();
+      for (const auto [index, target] : module_graph.GetOutEdgeIds(node_id)) {
+        if (reachable[target]) continue;
+        reachable[target] = true;
+        stack.push_back(target);
+      }
+    }
+    return reachable;
+  }
+
+  static ValueStateMap ToValueStateMap(const ModuleGraph& module_graph,
+                                       NodeStates node_states) {
+    ValueStateMap value_states;
+    for (NodeId node_id = 0; node_id < module_graph.NumberOfNodes();
+         ++node_id) {
+      std::optional<AbstractState>& state = node_states[node_id];
+      if (!state.has_value()) continue;
+      value_states.insert(
+          {std::get<ir::Value>(module_graph.GetNode(node_id)),
+           *std::move(state)});
+    }
     return value_states;
   }
 };
@@ -145,6 +145,53 @@ TEST_P(ModuleFixpointIteratorTest, ComputesFixpoint) {
                                          expected_operations));
 }
 
+TEST_P(ModuleFixpointIteratorTest, ComputesFixpointInParallel) {
+  ReachingOperationsAnalysis solver;
+  const auto& [_test_name, module_text, expected_operations] = GetParam();
+  IrProgramParserResult parse_result = ParseProgram(module_text);
+  const ir::Module& module = *ABSL_DIE_IF_NULL(parse_result.module);
+  ir::SsaNames* ssa_names = ABSL_DIE_IF_NULL(parse_result.ssa_names.get());
+  auto result = solver.ComputeFixpointInParallel(
+      module,
+      /*semantics_maker=*/
+      [ssa_names](const ir::Module& module) {
+        return ReachingOperationsSemantics(ssa_names);
+      },
+      /*num_threads=*/4);
+
+  EXPECT_THAT(result, UnorderedPointwise(ValueFixpointEq(ssa_names),
+                                         expected_operations));
+}
+
+TEST_P(ModuleFixpointIteratorTest, ComputesFixpointIncrementally) {
+  ReachingOperationsAnalysis solver;
+  const auto& [_test_name, module_text, expected_operations] = GetParam();
+  IrProgramParserResult parse_result = ParseProgram(module_text);
+  const ir::Module& module = *ABSL_DIE_IF_NULL(parse_result.module);
+  ir::SsaNames* ssa_names = ABSL_DIE_IF_NULL(parse_result.ssa_names.get());
+  auto semantics_maker = [ssa_names](const ir::Module& module) {
+    return ReachingOperationsSemantics(ssa_names);
+  };
+  // Starting from nothing and treating every operation as changed has to
+  // recompute everything.
+  std::vector<const ir::Operation*> operations;
+  for (const auto& block : module.blocks()) {
+    for (const auto& operation : block->operations()) {
+      operations.push_back(operation.get());
+    }
+  }
+  auto result = solver.ComputeFixpointIncrementally(
+      module, semantics_maker, /*previous_states=*/{}, operations);
+  EXPECT_THAT(result, UnorderedPointwise(ValueFixpointEq(ssa_names),
+                                         expected_operations));
+
+  // Starting from the fixpoint with nothing changed keeps the fixpoint.
+  auto unchanged_result = solver.ComputeFixpointIncrementally(
+      module, semantics_maker, result, /*changed_operations=*/{});
+  EXPECT_THAT(unchanged_result, UnorderedPointwise(ValueFixpointEq(ssa_names),
+                                                   expected_operations));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ModuleFixpointIteratorTests, ModuleFixpointIteratorTest,
     testing::ValuesIn<ModuleTestCase>(
@@ -247,5 +294,102 @@ INSTANTIATE_TEST_SUITE_P(
     [](const testing::TestParamInfo<ModuleFixpointIteratorTest::ParamType>&
            info) { return info.param.test_name; });
 
+// Wraps `ReachingOperationsSemantics` to count the applications of transfer
+// functions.
+class CountingReachingOperationsSemantics : public ReachingOperationsSemantics {
+ public:
+  CountingReachingOperationsSemantics(ir::SsaNames* ssa_names,
+                                      size_t* transformer_applications)
+      : ReachingOperationsSemantics(ssa_names),
+        transformer_applications_(transformer_applications) {}
+
+  std::vector<AbstractState> ApplyOperationTransformer(
+      const ir::Operation& operation,
+      const std::vector<AbstractState>& input_states) const {
+    ++*transformer_applications_;
+    return ReachingOperationsSemantics::ApplyOperationTransformer(
+        operation, input_states);
+  }
+
+ private:
+  size_t* transformer_applications_;
+};
+
+TEST(ModuleFixpointIteratorOrderTest, AcyclicModuleVisitsEachOperationOnce) {
+  // The operations are deliberately listed out of dependency order.
+  IrProgramParserResult parse_result = ParseProgram(R"(
+    module m0 {
+      block b0 {
+        %10 = core.output [](%9)
+        %9 = core.triple [](%7, %8, %6)
+        %8 = core.copy [](%6)
+        %7 = core.pair [](%4, %5)
+        %4, %5, %6 = core.split [](%3)
+        %3 = core.transform [](%2)
+        %2 = core.choose [](%0, %1)
+        %1 = core.string_constant [value: "hello"]()
+        %0 = core.int_constant [value: 2]()
+      }
+    })");
+  ir::SsaNames* ssa_names = ABSL_DIE_IF_NULL(parse_result.ssa_names.get());
+  size_t transformer_applications = 0;
+  ModuleFixpointIterator<CountingReachingOperationsSemantics> solver;
+  solver.ComputeFixpoint(
+      *ABSL_DIE_IF_NULL(parse_result.module),
+      /*semantics_maker=*/[&](const ir::Module& module) {
+        return CountingReachingOperationsSemantics(ssa_names,
+                                                   &transformer_applications);
+      });
+  EXPECT_EQ(transformer_applications, 9);
+}
+
+TEST(ModuleFixpointIteratorIncrementalTest, OnlyAffectedOperationsAreVisited) {
+  IrProgramParserResult parse_result = ParseProgram(R"(
+    module m0 {
+      block b0 {
+        %0 = core.int_constant [value: 2]()
+        %1 = core.copy [](%0)
+        %2 = core.copy [](%1)
+        %3 = core.string_constant [value: "hello"]()
+        %4 = core.copy [](%3)
+        %5 = core.pair [](%2, %4)
+      }
+    })");
+  const ir::Module& module = *ABSL_DIE_IF_NULL(parse_result.module);
+  ir::SsaNames* ssa_names = ABSL_DIE_IF_NULL(parse_result.ssa_names.get());
+  size_t transformer_applications = 0;
+  auto semantics_maker = [&](const ir::Module& module) {
+    return CountingReachingOperationsSemantics(ssa_names,
+                                               &transformer_applications);
+  };
+  ModuleFixpointIterator<CountingReachingOperationsSemantics> solver;
+  auto fixpoint = solver.ComputeFixpoint(module, semantics_maker);
+  EXPECT_EQ(transformer_applications, 6);
+
+  // Pretend that the operation defining `%4` has changed. Its previous result
+  // and the results depending on it are wrong and have to be recomputed.
+  const ir::Operation* changed_operation = nullptr;
+  auto previous_fixpoint = fixpoint;
+  for (auto& [value, state] : previous_fixpoint) {
+    std::string name = ir::ValueToString(value, *ssa_names);
+    if (name == "%4") {
+      changed_operation =
+          &value.If<ir::value::OperationResult>()->operation();
+    }
+    if (name == "%4" || name == "%5") state = AbstractState::Bottom();
+  }
+  ASSERT_NE(changed_operation, nullptr);
+
+  transformer_applications = 0;
+  auto result = solver.ComputeFixpointIncrementally(
+      module, semantics_maker, previous_fixpoint, {changed_operation});
+  // Only the changed operation and `%5 = core.pair ...` are evaluated.
+  EXPECT_EQ(transformer_applications, 2);
+  ASSERT_EQ(result.size(), fixpoint.size());
+  for (const auto& [value, state] : fixpoint) {
+    EXPECT_TRUE(result.at(value).IsEquivalentTo(state));
+  }
+}
+
 }  // namespace
 }  // namespace raksha::analysis::common
@@ -15,63 +15,114 @@
 //----------------------------------------------------------------------------
 #include "src/analysis/common/module_graph.h"
 
-#include "absl/strings/string_view.h"
-#include "src/ir/ir_traversing_visitor.h"
-#include "src/ir/value.h"
+#include <numeric>
+#include <variant>
+#include <vector>
 
-namespace raksha::analysis::common {
+#include "absl/log/die_if_null.h"
+#include "absl/types/span.h"
+#include "src/ir/module.h"
+#include "src/ir/use_def_index.h"
 
-namespace {
+namespace raksha::analysis::common {
 
-class AdjacencyListComputingVisitor
-    : public ir::IRTraversingVisitor<AdjacencyListComputingVisitor> {
- public:
-  static ModuleGraph::AdjacencyList ComputeAdjacencyList(
-      const ir::Module& module) {
-    AdjacencyListComputingVisitor visitor;
-    module.Accept(visitor);
-    return std::move(visitor.adjacency_list_);
-  }
+using NodeId = ModuleGraph::NodeId;
 
- private:
-  Unit PreVisit(const ir::Operation& operation) override {
-    // Add an entry in the adjacency list for the operation.
-    adjacency_list_.insert({ModuleGraph::Node(&operation), {}});
+ModuleGraph::ModuleGraph(const ir::Module* module)
+    : index_(ir::UseDefIndex::Get(*ABSL_DIE_IF_NULL(module))) {}
 
-    // Add an entry in the adjacency list for every input of the operation.
-    size_t input_index = 0;
-    // Add edge: input --index--> operation)
-    for (const auto& input : operation.inputs()) {
-      auto [input_entry, input_insert_result] =
-          adjacency_list_.insert({ModuleGraph::Node(input), {}});
-      input_entry->second.insert(
-          std::make_pair(input_index, ModuleGraph::Node(&operation)));
-      ++input_index;
+std::vector<NodeId> ModuleGraph::GetOperationIdsInReversePostOrder() const {
+  // An iterative depth-first traversal from each operation in module order
+  // (which is also the order of the node ids of operations) that records
+  // operations in postorder. Successors are visited in the order of the out
+  // edges, which is the order in which they appear in the module.
+  std::vector<NodeId> postorder;
+  std::vector<bool> visited(NumberOfNodes(), false);
+  struct Frame {
+    NodeId operation;
+    // The results of the operation and the position of the next use of the
+    // current result to visit.
+    absl::Span<const IndexedNodeId> results;
+    size_t next_result;
+    size_t next_use;
+  };
+  std::vector<Frame> stack;
+  for (NodeId root = 0; root < NumberOfNodes(); ++root) {
+    if (visited[root] ||
+        !std::holds_alternative<const ir::Operation*>(GetNode(root))) {
+      continue;
     }
-
-    // Add edge: operation --index--> output
-    for (uint64_t output_index = 0; output_index < operation.NumberOfOutputs();
-         ++output_index) {
-      // Mark the output value as a node in the graph.
-      auto output_node =
-          ModuleGraph::Node(operation.GetOutputValue(output_index));
-      adjacency_list_.insert({output_node, {}});
-      // Add the edge.
-      auto [output_entry, output_insert_result] =
-          adjacency_list_.insert({ModuleGraph::Node(&operation), {}});
-      output_entry->second.insert(std::make_pair(output_index, output_node));
+    visited[root] = true;
+    stack.push_back({root, GetOutEdgeIds(root), 0, 0});
+    while (!stack.empty()) {
+      Frame& frame = stack.back();
+      if (frame.next_result == frame.results.size()) {
+        postorder.push_back(frame.operation);
+        stack.pop_back();
+        continue;
+      }
+      absl::Span<const IndexedNodeId> uses =
+          GetOutEdgeIds(frame.results[frame.next_result].node);
+      if (frame.next_use == uses.size()) {
+        ++frame.next_result;
+        frame.next_use = 0;
+        continue;
+      }
+      NodeId successor = uses[frame.next_use++].node;
+      if (visited[successor]) continue;
+      visited[successor] = true;
+      // Note that `frame` is invalidated by this.
+      stack.push_back({successor, GetOutEdgeIds(successor), 0, 0});
     }
-    return Unit();
   }
+  return std::vector<NodeId>(postorder.rbegin(), postorder.rend());
+}
 
-  ModuleGraph::AdjacencyList adjacency_list_;
-};
+std::vector<const ir::Operation*> ModuleGraph::GetOperationsInReversePostOrder()
+    const {
+  std::vector<const ir::Operation*> result;
+  for (NodeId id : GetOperationIdsInReversePostOrder()) {
+    result.push_back(std::get<const ir::Operation*>(GetNode(id)));
+  }
+  return result;
+}
 
-}  // namespace
+std::vector<std::vector<NodeId>> ModuleGraph::GetWeaklyConnectedComponents()
+    const {
+  // A union-find over node ids in which the root of a set is its smallest id.
+  std::vector<NodeId> parents(NumberOfNodes());
+  std::iota(parents.begin(), parents.end(), 0);
+  auto find_root = [&parents](NodeId node) {
+    while (parents[node] != node) {
+      parents[node] = parents[parents[node]];
+      node = parents[node];
+    }
+    return node;
+  };
+  for (NodeId source = 0; source < NumberOfNodes(); ++source) {
+    for (const auto [index, target] : GetOutEdgeIds(source)) {
+      NodeId source_root = find_root(source);
+      NodeId target_root = find_root(target);
+      if (source_root == target_root) continue;
+      if (source_root < target_root) {
+        parents[target_root] = source_root;
+      } else {
+        parents[source_root] = target_root;
+      }
+    }
+  }
 
-ModuleGraph::ModuleGraph(const ir::Module* module)
-    : module_(*ABSL_DIE_IF_NULL(module)),
-      adjacency_list_(
-          AdjacencyListComputingVisitor::ComputeAdjacencyList(module_)) {}
+  std::vector<std::vector<NodeId>> components;
+  std::vector<size_t> component_of_root(NumberOfNodes());
+  for (NodeId node = 0; node < NumberOfNodes(); ++node) {
+    NodeId root = find_root(node);
+    if (root == node) {
+      component_of_root[root] = components.size();
+      components.emplace_back();
+    }
+    components[component_of_root[root]].push_back(node);
+  }
+  return components;
+}
 
 }  // namespace raksha::analysis::common
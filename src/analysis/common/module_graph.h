@@ -18,89 +18,147 @@
 
 #include <cstddef>
 #include <iterator>
+#include <memory>
 #include <tuple>
+#include <utility>
 #include <variant>
+#include <vector>
 
-#include "absl/container/flat_hash_map.h"
-#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
-#include "absl/log/die_if_null.h"
+#include "absl/types/span.h"
 #include "src/common/utils/iterator_adapter.h"
 #include "src/common/utils/ranges.h"
 #include "src/ir/module.h"
+#include "src/ir/use_def_index.h"
 #include "src/ir/value.h"
 
 namespace raksha::analysis::common {
 
+// The dataflow graph of a module: the nodes are the operations and values of
+// the module, and there is an edge from each input value to the operation
+// using it and from each operation to its results.
+//
+// The graph is a view of the `ir::UseDefIndex` of the module, which the module
+// keeps until it changes. Graphs of the same module, such as the ones built by
+// the successive analyses of the module, therefore share the work of indexing
+// it. The nodes are numbered densely in the order they are first encountered
+// in the module, and the edges are stored in compressed sparse row (CSR) form,
+// so that clients that work with `NodeId`s can traverse the graph without any
+// hashing. The `Node`-based API is layered on top of that and only needs a
+// lookup to translate the queried node.
 class ModuleGraph {
  public:
-  using EdgeIndex = size_t;
-  using Node = std::variant<ir::Value, const ir::Operation*>;
-  using IndexedNodeSet = absl::flat_hash_set<std::pair<EdgeIndex, Node>>;
+  using EdgeIndex = ir::UseDefIndex::EdgeIndex;
+  using NodeId = ir::UseDefIndex::NodeId;
+  using Node = ir::UseDefIndex::Node;
   struct Edge {
     Node source;
     EdgeIndex index;
     Node target;
   };
-  using AdjacencyList = absl::flat_hash_map<Node, IndexedNodeSet>;
+  // The target of an edge along with the index of the edge.
+  using IndexedNodeId = ir::UseDefIndex::IndexedNodeId;
 
-  // Returns an edge constructed from the given source and indexed target.
+  // Returns an edge constructed from the given target and (graph, source).
   struct EdgeMaterializer {
-    Edge operator()(const std::pair<EdgeIndex, Node>& target,
-                    const Node& source) {
-      return {.source = source, .index = target.first, .target = target.second};
+    Edge operator()(const IndexedNodeId& target,
+                    const std::pair<const ModuleGraph*, NodeId>& context) {
+      const auto& [graph, source] = context;
+      return {.source = graph->GetNode(source),
+              .index = target.index,
+              .target = graph->GetNode(target.node)};
     }
   };
 
   template <typename T>
   struct TargetMaterializer {
-    std::pair<EdgeIndex, T> operator()(
-        const std::pair<EdgeIndex, Node>& target) {
-      CHECK(std::holds_alternative<T>(target.second))
+    std::pair<EdgeIndex, T> operator()(const IndexedNodeId& target,
+                                       const ModuleGraph* graph) {
+      const Node& node = graph->GetNode(target.node);
+      CHECK(std::holds_alternative<T>(node))
           << "ModuleGraph has an unexpected edge.";
-      return std::make_pair(target.first, std::get<T>(target.second));
+      return std::make_pair(target.index, std::get<T>(node));
     }
   };
 
   explicit ModuleGraph(const ir::Module* module);
 
   // Returns all the nodes in the graph.
-  auto GetNodes() const { return utils::ranges::keys(adjacency_list_); }
+  auto GetNodes() const { return utils::ranges::all(index_->nodes()); }
 
   // Returns the out edges of the given source.
   auto GetOutEdges(const Node& source) const {
-    return utils::make_adapted_range<EdgeMaterializer>(GetAdjacentNodes(source),
-                                                       source);
+    NodeId source_id = GetNodeId(source);
+    return utils::make_adapted_range<EdgeMaterializer>(
+        index_->GetOutEdgesBegin(source_id), index_->GetOutEdgesEnd(source_id),
+        std::make_pair(this, source_id));
   }
 
   // Returns the uses of the given value as (index, Operation) pairs.
   auto GetUses(const ir::Value& value) const {
+    NodeId value_id = GetNodeId(value);
     return utils::make_adapted_range<TargetMaterializer<const ir::Operation*>>(
-        GetAdjacentNodes(value));
+        index_->GetOutEdgesBegin(value_id), index_->GetOutEdgesEnd(value_id),
+        this);
   }
 
   // Returns the results of the given operation as (index, Value) pairs.
   auto GetResults(const ir::Operation* operation) const {
+    NodeId operation_id = GetNodeId(operation);
     return utils::make_adapted_range<TargetMaterializer<ir::Value>>(
-        GetAdjacentNodes(operation));
+        index_->GetOutEdgesBegin(operation_id),
+        index_->GetOutEdgesEnd(operation_id), this);
   }
 
+  // Returns all operations of the module in reverse postorder of a depth-first
+  // traversal that follows the edges of the graph. Ignoring the back edges of
+  // loops, every operation comes after the operations whose results it uses,
+  // so a fixpoint iteration that prefers earlier operations sees the inputs of
+  // an operation settle before the operation itself is evaluated. The order
+  // only depends on the structure of the module.
+  std::vector<const ir::Operation*> GetOperationsInReversePostOrder() const;
+
   // Returns the source node of an edge.
   const Node& GetEdgeSource(const Edge& edge) const { return edge.source; }
 
   // Returns the target node of an edge.
   const Node& GetEdgeTarget(const Edge& edge) const { return edge.target; }
 
- private:
-  const AdjacencyList::mapped_type& GetAdjacentNodes(const Node& source) const {
-    auto find_result = adjacency_list_.find(source);
-    CHECK(find_result != adjacency_list_.end())
-        << "GetOutEdges: source not found in graph.";
-    return find_result->second;
+  // The `NodeId`-based API. Node ids range from 0 to `NumberOfNodes() - 1`.
+
+  size_t NumberOfNodes() const { return index_->NumberOfNodes(); }
+
+  // Returns the node with the given id.
+  const Node& GetNode(NodeId id) const { return index_->GetNode(id); }
+
+  // Returns the id of the given node, which must be part of the graph.
+  NodeId GetNodeId(const Node& node) const { return index_->GetNodeId(node); }
+
+  // Returns the targets of the out edges of the given node. For a value,
+  // these are the operations using it; for an operation, its results.
+  absl::Span<const IndexedNodeId> GetOutEdgeIds(NodeId source) const {
+    return index_->GetOutEdgeIds(source);
+  }
+
+  // Returns the ids of the inputs of the given operation, in the order of
+  // the operands. The result is empty for values.
+  absl::Span<const NodeId> GetInputIds(NodeId operation) const {
+    return index_->GetInputIds(operation);
   }
 
-  const ir::Module& module_;
-  AdjacencyList adjacency_list_;
+  // Returns the ids of all operations in the order described in
+  // `GetOperationsInReversePostOrder`.
+  std::vector<NodeId> GetOperationIdsInReversePostOrder() const;
+
+  // Returns the weakly connected components of the graph, i.e., the sets of
+  // nodes that are connected when the direction of edges is ignored. No
+  // information flows between different components, so they can be analyzed
+  // independently. Components are ordered by their smallest node id, and the
+  // ids within a component are in increasing order.
+  std::vector<std::vector<NodeId>> GetWeaklyConnectedComponents() const;
+
+ private:
+  std::shared_ptr<const ir::UseDefIndex> index_;
 };
 
 }  // namespace raksha::analysis::common
@@ -3,6 +3,7 @@
 #include <string>
 #include <tuple>
 
+#include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_cat.h"
@@ -159,6 +160,41 @@ TEST_P(ModuleGraphTest, GetEdgeTargetAndGetEdgeSourceBehavesCorrectly) {
   }
 }
 
+TEST_P(ModuleGraphTest, DenseNodeIdsAgreeWithNodes) {
+  const ModuleGraph& test_graph = graph();
+  ASSERT_EQ(test_graph.NumberOfNodes(), GetParam().expected_nodes.size());
+  for (ModuleGraph::NodeId id = 0; id < test_graph.NumberOfNodes(); ++id) {
+    const ModuleGraph::Node& node = test_graph.GetNode(id);
+    EXPECT_EQ(test_graph.GetNodeId(node), id);
+
+    std::vector<std::pair<ModuleGraph::EdgeIndex, ModuleGraph::Node>>
+        out_edges;
+    for (const auto [index, target] : test_graph.GetOutEdgeIds(id)) {
+      out_edges.push_back({index, test_graph.GetNode(target)});
+    }
+    std::vector<std::pair<ModuleGraph::EdgeIndex, ModuleGraph::Node>>
+        expected_out_edges;
+    for (const auto& [source, index, target] : test_graph.GetOutEdges(node)) {
+      expected_out_edges.push_back({index, target});
+    }
+    EXPECT_EQ(out_edges, expected_out_edges);
+
+    // Inputs of an operation are in the order of its operands.
+    const auto* operation = std::get_if<const ir::Operation*>(&node);
+    if (operation == nullptr) {
+      EXPECT_TRUE(test_graph.GetInputIds(id).empty());
+      continue;
+    }
+    std::vector<ModuleGraph::Node> inputs;
+    for (ModuleGraph::NodeId input : test_graph.GetInputIds(id)) {
+      inputs.push_back(test_graph.GetNode(input));
+    }
+    std::vector<ModuleGraph::Node> expected_inputs(
+        (*operation)->inputs().begin(), (*operation)->inputs().end());
+    EXPECT_EQ(inputs, expected_inputs);
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ModuleGraphTests, ModuleGraphTest,
     testing::ValuesIn<ModuleGraphTestCase>(
@@ -357,5 +393,80 @@ ModuleGraphTest::ModuleGraphTest()
                                    *parse_result_.ssa_names)),
       id_to_node_(BuildIdToNodeMap(node_to_id_)) {}
 
+TEST(ModuleGraphReversePostOrderTest, OperationsComeAfterTheirProducers) {
+  IrProgramParserResult parse_result = ParseProgram(R"(
+    module m0 {
+      block b0 {
+        %0 = core.int_constant [value: 2]()
+        %1 = core.string_constant [value: "hello"]()
+        %2 = core.choose [](%0, %1)
+        %4, %5, %6 = core.split [](%3)
+        %3 = core.transform [](%2)
+        %7 = core.pair [](%4, %5)
+        %9 = core.triple [](%7, %8, %6)
+        %8 = core.copy [](%6)
+        %10 = core.output [](%9)
+      }
+    })");
+  ModuleGraph graph(parse_result.module.get());
+  std::vector<const ir::Operation*> order =
+      graph.GetOperationsInReversePostOrder();
+  ASSERT_EQ(order.size(), 9);
+
+  absl::flat_hash_map<const ir::Operation*, size_t> positions;
+  for (size_t position = 0; position < order.size(); ++position) {
+    positions.insert({order[position], position});
+  }
+  ASSERT_EQ(positions.size(), order.size());
+  for (const ir::Operation* operation : order) {
+    for (const ir::Value& input : operation->inputs()) {
+      const auto* result = input.If<ir::value::OperationResult>();
+      if (result == nullptr) continue;
+      EXPECT_LT(positions.at(&result->operation()), positions.at(operation));
+    }
+  }
+  // The order does not depend on the addresses of the operations.
+  EXPECT_EQ(ModuleGraph(parse_result.module.get())
+                .GetOperationsInReversePostOrder(),
+            order);
+}
+
+TEST(ModuleGraphComponentsTest, IndependentComputationsAreSeparated) {
+  IrProgramParserResult parse_result = ParseProgram(R"(
+    module m0 {
+      block b0 {
+        %0 = core.int_constant [value: 2]()
+        %1 = core.string_constant [value: "hello"]()
+        %2 = core.copy [](%1)
+        %3 = core.choose [](%0, %2)
+        %4 = core.int_constant [value: 3]()
+        %5 = core.output [](%4)
+      }
+    })");
+  ModuleGraph graph(parse_result.module.get());
+  std::vector<std::vector<ModuleGraph::NodeId>> components =
+      graph.GetWeaklyConnectedComponents();
+  ASSERT_EQ(components.size(), 2);
+
+  // Every node is in exactly one component, and no edge crosses components.
+  absl::flat_hash_map<ModuleGraph::NodeId, size_t> component_of_node;
+  for (size_t component = 0; component < components.size(); ++component) {
+    EXPECT_TRUE(absl::c_is_sorted(components[component]));
+    for (ModuleGraph::NodeId node : components[component]) {
+      EXPECT_TRUE(component_of_node.insert({node, component}).second);
+    }
+  }
+  EXPECT_EQ(component_of_node.size(), graph.NumberOfNodes());
+  for (ModuleGraph::NodeId node = 0; node < graph.NumberOfNodes(); ++node) {
+    for (const auto [index, target] : graph.GetOutEdgeIds(node)) {
+      EXPECT_EQ(component_of_node.at(node), component_of_node.at(target));
+    }
+  }
+  // The operations `%0 = ...` to `%3 = ...` and their results form the first
+  // component; `%4 = ...`, `%5 = ...` and their results the second one.
+  EXPECT_EQ(components[0].size(), 8);
+  EXPECT_EQ(components[1].size(), 4);
+}
+
 }  // namespace
 }  // namespace raksha::analysis::common
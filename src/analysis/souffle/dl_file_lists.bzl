@@ -21,6 +21,7 @@ core_dl_files_except_taint_local = [
     "check_predicate.dl",
     "dataflow_graph.dl",
     "operations.dl",
+    "operations_flat.dl",
     "tags.dl",
 ]
 
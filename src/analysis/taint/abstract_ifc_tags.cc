@@ -15,7 +15,6 @@
 //-----------------------------------------------------------------------------
 #include "src/analysis/taint/abstract_ifc_tags.h"
 
-#include "absl/algorithm/container.h"
 #include "src/common/utils/ref_counted.h"
 
 namespace raksha::analysis::taint {
@@ -33,6 +32,12 @@ bool AbstractIfcTags::IsBottom() const { return tags_ == nullptr; }
 bool AbstractIfcTags::IsEquivalentTo(const AbstractIfcTags& other) const {
   if (this->IsBottom()) return other.IsBottom();
   if (other.IsBottom()) return false;
+  if (tags_ == other.tags_) return true;
+  // Distinct instances of the same interner hold distinct tag states.
+  if (tags_->interner() != nullptr &&
+      tags_->interner() == other.tags_->interner()) {
+    return false;
+  }
   return tags_->integrity_tags() == other.tags_->integrity_tags() &&
          tags_->secrecy_tags() == other.tags_->secrecy_tags();
 }
@@ -40,52 +45,64 @@ bool AbstractIfcTags::IsEquivalentTo(const AbstractIfcTags& other) const {
 AbstractIfcTags AbstractIfcTags::Join(const AbstractIfcTags& other) const {
   if (this->IsBottom()) return other;
   if (other.IsBottom()) return *this;
-
-  // Compute union of secrecy tags
-  TagIdSet new_secrecy_tags = tags_->secrecy_tags();
-  absl::c_copy(other.tags_->secrecy_tags(),
-               std::inserter(new_secrecy_tags, new_secrecy_tags.end()));
-
-  // Compute interserction of integrity tags.
-  TagIdSet new_integrity_tags;
-  const TagIdSet& other_integrity_tags = other.tags_->integrity_tags();
-  for (const TagId& tag : tags_->integrity_tags()) {
-    if (other_integrity_tags.contains(tag)) new_integrity_tags.insert(tag);
+  if (tags_ == other.tags_) return *this;
+  if (tags_->interner() != nullptr &&
+      tags_->interner() == other.tags_->interner()) {
+    return tags_->interner()->Join(tags_.get(), other.tags_.get());
   }
-  return AbstractIfcTags(std::move(new_secrecy_tags),
-                         std::move(new_integrity_tags));
+
+  // Compute union of secrecy tags and intersection of integrity tags.
+  TagIdSet new_secrecy_tags =
+      tags_->secrecy_tags().Union(other.tags_->secrecy_tags());
+  TagIdSet new_integrity_tags =
+      tags_->integrity_tags().Intersection(other.tags_->integrity_tags());
+  return WithTags(std::move(new_secrecy_tags), std::move(new_integrity_tags));
 }
 
 AbstractIfcTags AbstractIfcTags::SetIntegrity(TagId tag) const {
   if (IsBottom()) return *this;
+  if (tags_->integrity_tags().contains(tag)) return *this;
 
   TagIdSet new_integrity_tags = tags_->integrity_tags();
   new_integrity_tags.insert(tag);
-  return AbstractIfcTags(tags_->secrecy_tags(), std::move(new_integrity_tags));
+  return WithTags(tags_->secrecy_tags(), std::move(new_integrity_tags));
 }
 
 AbstractIfcTags AbstractIfcTags::ClearIntegrity(TagId tag) const {
   if (IsBottom()) return *this;
+  if (!tags_->integrity_tags().contains(tag)) return *this;
 
   TagIdSet new_integrity_tags = tags_->integrity_tags();
   new_integrity_tags.erase(tag);
-  return AbstractIfcTags(tags_->secrecy_tags(), std::move(new_integrity_tags));
+  return WithTags(tags_->secrecy_tags(), std::move(new_integrity_tags));
 }
 
 AbstractIfcTags AbstractIfcTags::SetSecrecy(TagId tag) const {
   if (IsBottom()) return *this;
+  if (tags_->secrecy_tags().contains(tag)) return *this;
 
   TagIdSet new_secrecy_tags = tags_->secrecy_tags();
   new_secrecy_tags.insert(tag);
-  return AbstractIfcTags(std::move(new_secrecy_tags), tags_->integrity_tags());
+  return WithTags(std::move(new_secrecy_tags), tags_->integrity_tags());
 }
 
 AbstractIfcTags AbstractIfcTags::ClearSecrecy(TagId tag) const {
   if (IsBottom()) return *this;
+  if (!tags_->secrecy_tags().contains(tag)) return *this;
 
   TagIdSet new_secrecy_tags = tags_->secrecy_tags();
   new_secrecy_tags.erase(tag);
-  return AbstractIfcTags(std::move(new_secrecy_tags), tags_->integrity_tags());
+  return WithTags(std::move(new_secrecy_tags), tags_->integrity_tags());
+}
+
+AbstractIfcTags AbstractIfcTags::WithTags(TagIdSet secrecy_tags,
+                                          TagIdSet integrity_tags) const {
+  CHECK(!IsBottom()) << "Cannot derive tags from bottom.";
+  if (tags_->interner() == nullptr) {
+    return AbstractIfcTags(std::move(secrecy_tags), std::move(integrity_tags));
+  }
+  return tags_->interner()->Intern(std::move(secrecy_tags),
+                                   std::move(integrity_tags));
 }
 
 const TagIdSet& AbstractIfcTags::secrecy_tags() const {
@@ -112,7 +129,8 @@ std::string AbstractIfcTags::ToString(
     const std::vector<std::string>& tag_names) const {
   if (IsBottom()) return "[Bottom]";
 
-  auto render_tags = [&tag_names](absl::string_view label, TagIdSet tags_set) {
+  auto render_tags = [&tag_names](absl::string_view label,
+                                const TagIdSet& tags_set) {
     return absl::StrCat(
         label, ": {",
         absl::StrJoin(
@@ -129,4 +147,39 @@ std::string AbstractIfcTags::ToString(
                       render_tags("i", tags_->integrity_tags()));
 }
 
+IfcTagsInterner::~IfcTagsInterner() {
+  // Values that are still referenced elsewhere stay valid as plain values.
+  for (const IfcTagsConstPtr& tags : interned_tags_) {
+    tags->interner_ = nullptr;
+  }
+}
+
+AbstractIfcTags IfcTagsInterner::Intern(TagIdSet secrecy_tags,
+                                        TagIdSet integrity_tags) {
+  auto find_result =
+      interned_tags_.find(TagsView{secrecy_tags, integrity_tags});
+  if (find_result != interned_tags_.end()) {
+    return AbstractIfcTags(*find_result);
+  }
+  IfcTagsPtr tags =
+      IfcTags::Create(std::move(secrecy_tags), std::move(integrity_tags));
+  tags->interner_ = this;
+  interned_tags_.insert(tags);
+  return AbstractIfcTags(std::move(tags));
+}
+
+AbstractIfcTags IfcTagsInterner::Join(const IfcTags* lhs, const IfcTags* rhs) {
+  // Join is commutative, so both orders of operands share a cache entry.
+  if (rhs < lhs) std::swap(lhs, rhs);
+  auto find_result = joins_.find({lhs, rhs});
+  if (find_result != joins_.end()) {
+    return AbstractIfcTags(IfcTagsConstPtr(find_result->second));
+  }
+  AbstractIfcTags result =
+      Intern(lhs->secrecy_tags().Union(rhs->secrecy_tags()),
+             lhs->integrity_tags().Intersection(rhs->integrity_tags()));
+  joins_.insert({{lhs, rhs}, result.tags_.get()});
+  return result;
+}
+
 }  // namespace raksha::analysis::taint
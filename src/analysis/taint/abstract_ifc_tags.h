@@ -16,16 +16,22 @@
 #ifndef SRC_ANALYSIS_TAINT_ABSTRACT_IFC_TAGS_H_
 #define SRC_ANALYSIS_TAINT_ABSTRACT_IFC_TAGS_H_
 
+#include <cstddef>
+#include <utility>
+
 #include "absl/base/attributes.h"
 #include "absl/container/btree_set.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
 #include "src/analysis/taint/inference_rules.h"
+#include "src/analysis/taint/tag_id_set.h"
 #include "src/common/utils/intrusive_ptr.h"
 
 namespace raksha::analysis::taint {
 
-using TagIdSet = absl::flat_hash_set<TagId>;
-
 class IfcTags;
+class IfcTagsInterner;
 using IfcTagsConstPtr = intrusive_ptr<const IfcTags>;
 using IfcTagsPtr = intrusive_ptr<IfcTags>;
 
@@ -42,18 +48,31 @@ class IfcTags : public RefCounted<IfcTags> {
   const TagIdSet& secrecy_tags() const { return secrecy_tags_; }
   const TagIdSet& integrity_tags() const { return integrity_tags_; }
 
+  // Returns the interner that holds this instance, or nullptr if this instance
+  // is not interned.
+  IfcTagsInterner* interner() const { return interner_; }
+
  private:
   IfcTags(TagIdSet secrecy_tags, TagIdSet integrity_tags)
       : secrecy_tags_(std::move(secrecy_tags)),
-        integrity_tags_(std::move(integrity_tags)) {}
+        integrity_tags_(std::move(integrity_tags)),
+        interner_(nullptr) {}
 
   TagIdSet secrecy_tags_;
   TagIdSet integrity_tags_;
+  // Set by the interner, which detaches its instances when it is destroyed.
+  mutable IfcTagsInterner* interner_;
 
   friend class intrusive_ptr<IfcTags>;
+  friend class IfcTagsInterner;
 };
 
 // Abstract domain for IFC tags.
+//
+// Values created by an `IfcTagsInterner` share a single `IfcTags` instance per
+// distinct tag state. Operations on interned values return interned values, so
+// that equivalence of values of the same interner is a pointer comparison and
+// joins are memoized.
 class AbstractIfcTags {
  public:
   AbstractIfcTags(TagIdSet secrecy_tags, TagIdSet integrity_tags);
@@ -106,7 +125,82 @@ class AbstractIfcTags {
  private:
   AbstractIfcTags(IfcTagsConstPtr tags) : tags_(std::move(tags)) {}
 
+  // Returns a value with the given tags that is interned in the same interner
+  // as this value, if any. Fails if this is bottom.
+  AbstractIfcTags WithTags(TagIdSet secrecy_tags,
+                           TagIdSet integrity_tags) const;
+
   IfcTagsConstPtr tags_;
+
+  friend class IfcTagsInterner;
+};
+
+// A table of `IfcTags` instances that makes equal tag states share a single
+// instance. An interner is meant to live for a single analysis run: it keeps
+// every state it has seen alive until it is destroyed. Values that outlive
+// their interner remain valid but are no longer interned.
+//
+// This class is not thread-safe.
+class IfcTagsInterner {
+ public:
+  IfcTagsInterner() = default;
+  ~IfcTagsInterner();
+
+  IfcTagsInterner(const IfcTagsInterner&) = delete;
+  IfcTagsInterner& operator=(const IfcTagsInterner&) = delete;
+
+  // Returns the interned value with the given tags.
+  AbstractIfcTags Intern(TagIdSet secrecy_tags, TagIdSet integrity_tags);
+
+  // Returns the number of distinct tag states in the interner.
+  size_t size() const { return interned_tags_.size(); }
+
+ private:
+  friend class AbstractIfcTags;
+
+  // A view of the tags of an `IfcTags` instance that is used for lookups.
+  struct TagsView {
+    const TagIdSet& secrecy_tags;
+    const TagIdSet& integrity_tags;
+
+    template <typename H>
+    friend H AbslHashValue(H h, const TagsView& view) {
+      return H::combine(std::move(h), view.secrecy_tags, view.integrity_tags);
+    }
+  };
+
+  static TagsView ViewOf(const TagsView& view) { return view; }
+  static TagsView ViewOf(const IfcTagsConstPtr& tags) {
+    return {tags->secrecy_tags(), tags->integrity_tags()};
+  }
+
+  struct TagsHash {
+    using is_transparent = void;
+    template <typename T>
+    size_t operator()(const T& tags) const {
+      return absl::Hash<TagsView>()(ViewOf(tags));
+    }
+  };
+
+  struct TagsEq {
+    using is_transparent = void;
+    template <typename T, typename U>
+    bool operator()(const T& lhs, const U& rhs) const {
+      TagsView lhs_view = ViewOf(lhs);
+      TagsView rhs_view = ViewOf(rhs);
+      return lhs_view.secrecy_tags == rhs_view.secrecy_tags &&
+             lhs_view.integrity_tags == rhs_view.integrity_tags;
+    }
+  };
+
+  // Returns the join of two distinct instances held by this interner.
+  AbstractIfcTags Join(const IfcTags* lhs, const IfcTags* rhs);
+
+  absl::flat_hash_set<IfcTagsConstPtr, TagsHash, TagsEq> interned_tags_;
+  // Memoized joins, keyed by the (unordered) pair of joined instances.
+  absl::flat_hash_map<std::pair<const IfcTags*, const IfcTags*>,
+                      const IfcTags*>
+      joins_;
 };
 
 }  // namespace raksha::analysis::taint
@@ -16,6 +16,7 @@
 #include "src/analysis/taint/abstract_ifc_tags.h"
 
 #include <cstdint>
+#include <optional>
 #include <tuple>
 #include <utility>
 
@@ -361,5 +362,44 @@ TEST_P(AbstractIfcTagsToStringTest, ToStringIsAsExpected) {
   EXPECT_THAT(ifc_tags.ToString(kTagNames), AnyOfArray(expected_strings));
 }
 
+// IfcTagsInterner tests
+TEST(IfcTagsInternerTest, EqualStatesAreInternedOnce) {
+  IfcTagsInterner interner;
+  AbstractIfcTags first = interner.Intern({0, 1}, {2});
+  AbstractIfcTags second = interner.Intern({1, 0}, {2});
+  EXPECT_EQ(interner.size(), 1);
+  EXPECT_TRUE(first.IsEquivalentTo(second));
+  EXPECT_FALSE(first.IsEquivalentTo(interner.Intern({0}, {2})));
+  EXPECT_EQ(interner.size(), 2);
+}
+
+TEST(IfcTagsInternerTest, OperationsOnInternedValuesAreInterned) {
+  IfcTagsInterner interner;
+  AbstractIfcTags lhs = interner.Intern({0}, {2, 3});
+  AbstractIfcTags rhs = interner.Intern({1}, {2});
+  AbstractIfcTags joined = lhs.Join(rhs);
+  EXPECT_TRUE(joined.IsEquivalentTo(AbstractIfcTags({0, 1}, {2})));
+  EXPECT_EQ(interner.size(), 3);
+  EXPECT_TRUE(joined.IsEquivalentTo(rhs.Join(lhs)));
+  EXPECT_TRUE(
+      joined.IsEquivalentTo(rhs.SetSecrecy(0).ClearIntegrity(3).SetSecrecy(1)));
+  EXPECT_EQ(interner.size(), 3);
+  // Interned and plain values with equal tags are equivalent.
+  EXPECT_TRUE(lhs.IsEquivalentTo(AbstractIfcTags({0}, {2, 3})));
+  EXPECT_TRUE(AbstractIfcTags({0}, {2, 3}).IsEquivalentTo(lhs));
+}
+
+TEST(IfcTagsInternerTest, ValuesOutliveTheirInterner) {
+  std::optional<IfcTagsInterner> interner;
+  interner.emplace();
+  AbstractIfcTags lhs = interner->Intern({0}, {2, 3});
+  AbstractIfcTags rhs = interner->Intern({1}, {2});
+  interner.reset();
+  AbstractIfcTags joined = lhs.Join(rhs);
+  EXPECT_THAT(joined.secrecy_tags(), Eq(TagIdSet({0, 1})));
+  EXPECT_THAT(joined.integrity_tags(), Eq(TagIdSet({2})));
+  EXPECT_FALSE(lhs.IsEquivalentTo(rhs));
+}
+
 }  // namespace
 }  // namespace raksha::analysis::taint
@@ -38,7 +38,7 @@ AbstractIfcTags AbstractSemantics::ApplyDefaultOperationTransformer(
       });
   if (joined_result.IsBottom()) return joined_result;
   // We clear the integrity tags as they should not be preserved by default.
-  return AbstractIfcTags(joined_result.secrecy_tags(), {});
+  return interner_->Intern(joined_result.secrecy_tags(), {});
 }
 
 namespace {
@@ -47,7 +47,8 @@ namespace {
 AbstractIfcTags InteprepretMergeIntegrityTags(
     const MergeIntegrityTags& merge_tags,
     const std::vector<AbstractIfcTags>& input_states,
-    const AbstractIfcTags& current_value) {  // transform(bottom) = bottom
+    const AbstractIfcTags& current_value,
+    IfcTagsInterner& interner) {  // transform(bottom) = bottom
   if (current_value.IsBottom()) return current_value;
   // If any of the input states are bottom, we return bottom. Note
   // that bottom on an input state means that the specific value has
@@ -95,20 +96,17 @@ AbstractIfcTags InteprepretMergeIntegrityTags(
         switch (merge_tags.kind) {
           case MergeIntegrityTags::Kind::kUnion:
             result = std::move(accumulated_tags);
-            absl::c_copy(input_integrity_tags,
-                         std::inserter(result, result.end()));
+            result |= input_integrity_tags;
             break;
           case MergeIntegrityTags::Kind::kIntersect:
-            for (const TagId& tag : accumulated_tags) {
-              if (input_integrity_tags.contains(tag)) {
-                result.insert(tag);
-              }
-            }
+            result = std::move(accumulated_tags);
+            result &= input_integrity_tags;
             break;
         }
         return std::make_pair(false, result);
       });
-  return AbstractIfcTags(current_secrecy_tags, new_integrity_tags);
+  return interner.Intern(std::move(current_secrecy_tags),
+                         std::move(new_integrity_tags));
 }
 }  // namespace
 
@@ -150,10 +148,10 @@ AbstractIfcTags AbstractSemantics::InterpretInferenceRule(
                 return current_value.SetSecrecy(modify_tag.tag);
             }
           },
-          [&current_value,
+          [this, &current_value,
            &input_states](const MergeIntegrityTags& merge_tags) {
             return InteprepretMergeIntegrityTags(merge_tags, input_states,
-                                                 current_value);
+                                                 current_value, *interner_);
           },
           [&current_value](auto value) { return current_value; }},
       rule.conclusion);
@@ -190,7 +188,7 @@ std::vector<AbstractIfcTags> AbstractSemantics::ApplyOperationTransformer(
 
 AbstractIfcTags AbstractSemantics::GetInitialState(
     const ir::Value& value) const {
-  return AbstractIfcTags({}, {});
+  return interner_->Intern({}, {});
 }
 
 }  // namespace raksha::analysis::taint
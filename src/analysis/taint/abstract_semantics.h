@@ -1,6 +1,7 @@
 #ifndef SRC_ANALYSIS_TAINT_ABSTRACT_SEMANTICS_H_
 #define SRC_ANALYSIS_TAINT_ABSTRACT_SEMANTICS_H_
 
+#include <memory>
 #include <variant>
 
 #include "absl/container/flat_hash_set.h"
@@ -16,7 +17,8 @@ class AbstractSemantics {
   using AbstractState = AbstractIfcTags;
 
   explicit AbstractSemantics(InferenceRules inference_rules)
-      : inference_rules_(std::move(inference_rules)) {}
+      : inference_rules_(std::move(inference_rules)),
+        interner_(std::make_unique<IfcTagsInterner>()) {}
 
   // Returns the inital state for the given value.
   AbstractIfcTags GetInitialState(const ir::Value& value) const;
@@ -39,6 +41,9 @@ class AbstractSemantics {
       const AbstractIfcTags& current_value) const;
 
   InferenceRules inference_rules_;
+  // Interns all states computed by this instance. It is held by pointer so
+  // that the states stay attached to it when the semantics is moved.
+  std::unique_ptr<IfcTagsInterner> interner_;
 };
 
 }  // namespace raksha::analysis::taint
@@ -16,8 +16,12 @@
 #ifndef SRC_ANALYSIS_TAINT_INFERENCE_RULES_H_
 #define SRC_ANALYSIS_TAINT_INFERENCE_RULES_H_
 
+#include <cstdint>
 #include <functional>
+#include <optional>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
@@ -44,16 +48,40 @@ class InferenceRules {
                  absl::flat_hash_map<const ir::Operation*, std::string> actions,
                  absl::flat_hash_map<std::string, TagId> tags,
                  std::vector<std::string> tag_names)
-      : action_rules_(std::move(action_rules)),
-        actions_(std::move(actions)),
-        tags_(std::move(tags)),
-        tag_names_(std::move(tag_names)) {}
-
-  const ActionRules& action_rules() const { return action_rules_; }
-  const absl::flat_hash_map<const ir::Operation*, std::string>& actions()
-      const {
-    return actions_;
+      : tags_(std::move(tags)), tag_names_(std::move(tag_names)) {
+    for (auto& [action, output_rules] : action_rules) {
+      ActionId action_id = GetOrCreateActionId(action);
+      action_output_rules_[action_id] = std::move(output_rules);
+    }
+    for (const auto& [operation, action] : actions) {
+      operation_actions_.insert({operation, GetOrCreateActionId(action)});
+    }
   }
+
+  // Returns the rules of each action that has any. The map is rebuilt on
+  // every call, so this is meant for inspection rather than for lookups.
+  ActionRules action_rules() const {
+    ActionRules action_rules;
+    for (ActionId action = 0; action < action_names_.size(); ++action) {
+      if (action_output_rules_[action].has_value()) {
+        action_rules.insert(
+            {action_names_[action], *action_output_rules_[action]});
+      }
+    }
+    return action_rules;
+  }
+
+  // Returns the action of each operation that is marked as one. The map is
+  // rebuilt on every call, so this is meant for inspection rather than for
+  // lookups.
+  absl::flat_hash_map<const ir::Operation*, std::string> actions() const {
+    absl::flat_hash_map<const ir::Operation*, std::string> actions;
+    for (const auto& [operation, action] : operation_actions_) {
+      actions.insert({operation, action_names_[action]});
+    }
+    return actions;
+  }
+
   const absl::flat_hash_map<std::string, TagId>& tags() const { return tags_; }
   const std::vector<std::string>& tag_names() const { return tag_names_; }
 
@@ -76,25 +104,51 @@ class InferenceRules {
 
   // Returns the rule associated with the given action.
   OptionOutputRulesRef GetOutputRulesForAction(absl::string_view action) const {
-    auto find_result = action_rules_.find(action);
-    return (find_result == action_rules_.end())
+    auto find_result = action_ids_.find(action);
+    return (find_result == action_ids_.end())
                ? std::nullopt
-               : OptionOutputRulesRef(std::cref(find_result->second));
+               : GetOutputRulesForActionId(find_result->second);
   }
 
   // Returns inference rule for the given operation. Returns std::nullopt if
   // there are no inference rules associated with this operation.
   OptionOutputRulesRef GetOutputRulesForOperation(
       const ir::Operation& operation) const {
-    auto find_result = actions_.find(&operation);
-    return (find_result == actions_.end())
+    auto find_result = operation_actions_.find(&operation);
+    return (find_result == operation_actions_.end())
                ? std::nullopt
-               : GetOutputRulesForAction(find_result->second);
+               : GetOutputRulesForActionId(find_result->second);
   }
 
  private:
-  ActionRules action_rules_;
-  absl::flat_hash_map<const ir::Operation*, std::string> actions_;
+  // Actions are interned to dense ids, like tags, so that finding the rules
+  // of an operation does not hash the name of its action.
+  using ActionId = uint64_t;
+
+  ActionId GetOrCreateActionId(absl::string_view action) {
+    auto insert_result =
+        action_ids_.insert({std::string(action), action_names_.size()});
+    if (insert_result.second) {
+      action_names_.push_back(insert_result.first->first);
+      action_output_rules_.push_back(std::nullopt);
+    }
+    return insert_result.first->second;
+  }
+
+  OptionOutputRulesRef GetOutputRulesForActionId(ActionId action) const {
+    const std::optional<OutputRules>& output_rules =
+        action_output_rules_[action];
+    return output_rules.has_value()
+               ? OptionOutputRulesRef(std::cref(*output_rules))
+               : std::nullopt;
+  }
+
+  // Actions Table. An action may be marked on operations without having any
+  // rules, in which case its entry in `action_output_rules_` is empty.
+  absl::flat_hash_map<std::string, ActionId> action_ids_;
+  std::vector<std::string> action_names_;
+  std::vector<std::optional<OutputRules>> action_output_rules_;
+  absl::flat_hash_map<const ir::Operation*, ActionId> operation_actions_;
 
   // TagIds Table
   absl::flat_hash_map<std::string, TagId> tags_;
@@ -117,5 +117,27 @@ TEST_F(InferenceRulesTest,
               Eq(std::nullopt));
 }
 
+TEST(InferenceRulesWithoutFixtureTest,
+     GetOutputRulesForOperationReturnsNullForActionWithoutRules) {
+  ir::Operator plus_operator("core.plus");
+  ir::Operation plus(nullptr, plus_operator, {}, {});
+  InferenceRules rules(/*action_rules=*/{},
+                       /*actions=*/{{&plus, "plus_action"}},
+                       /*tags=*/{}, /*tag_names=*/{});
+  EXPECT_THAT(rules.GetOutputRulesForOperation(plus), Eq(std::nullopt));
+  EXPECT_THAT(rules.GetOutputRulesForAction("plus_action"), Eq(std::nullopt));
+  EXPECT_THAT(rules.action_rules(), ::testing::IsEmpty());
+  EXPECT_THAT(rules.actions(), ::testing::UnorderedElementsAre(
+                                   std::make_pair(&plus, "plus_action")));
+}
+
+TEST_F(InferenceRulesTest, CopiesKeepTheRulesOfOperations) {
+  InferenceRules copy = rules();
+  EXPECT_THAT(copy.GetOutputRulesForOperation(plus()),
+              Eq(std::make_optional(test_action_rules[0])));
+  EXPECT_THAT(copy.GetOutputRulesForOperation(minus()),
+              Eq(std::make_optional(test_action_rules[1])));
+}
+
 }  // namespace
 }  // namespace raksha::analysis::taint
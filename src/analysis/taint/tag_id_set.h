@@ -0,0 +1,210 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+#ifndef SRC_ANALYSIS_TAINT_TAG_ID_SET_H_
+#define SRC_ANALYSIS_TAINT_TAG_ID_SET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/numeric/bits.h"
+#include "src/analysis/taint/inference_rule.h"
+
+namespace raksha::analysis::taint {
+
+// A set of tag ids represented as a dense bitset. Tag ids are indices into
+// the tag table of `InferenceRules`, so they are small and dense. The bits
+// for the first 128 tags are stored inline; larger ids spill to the heap.
+//
+// The words never end in a zero word, so that equal sets have equal words and
+// comparisons, unions and intersections are plain word-wise operations.
+class TagIdSet {
+ public:
+  using value_type = TagId;
+  using size_type = size_t;
+
+  // Iterates over the tags of the set in increasing order.
+  class const_iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = TagId;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const TagId*;
+    using reference = TagId;
+
+    const_iterator() : words_(nullptr), num_words_(0), tag_(0) {}
+
+    TagId operator*() const { return tag_; }
+
+    const_iterator& operator++() {
+      tag_ = NextTag(tag_ + 1);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator result = *this;
+      ++(*this);
+      return result;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return tag_ == other.tag_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    friend class TagIdSet;
+
+    const_iterator(const uint64_t* words, size_t num_words, TagId from)
+        : words_(words), num_words_(num_words), tag_(NextTag(from)) {}
+
+    // Returns the first tag in the set that is not less than `from`, or the
+    // end position if there is none.
+    TagId NextTag(TagId from) const {
+      size_t word_index = from / kBitsPerWord;
+      if (word_index >= num_words_) return num_words_ * kBitsPerWord;
+      uint64_t word =
+          words_[word_index] & (~uint64_t{0} << (from % kBitsPerWord));
+      while (word == 0) {
+        if (++word_index == num_words_) return num_words_ * kBitsPerWord;
+        word = words_[word_index];
+      }
+      return word_index * kBitsPerWord + absl::countr_zero(word);
+    }
+
+    const uint64_t* words_;
+    size_t num_words_;
+    TagId tag_;
+  };
+  using iterator = const_iterator;
+
+  TagIdSet() = default;
+  TagIdSet(std::initializer_list<TagId> tags) {
+    for (TagId tag : tags) insert(tag);
+  }
+
+  const_iterator begin() const {
+    return const_iterator(words_.data(), words_.size(), 0);
+  }
+  const_iterator end() const {
+    return const_iterator(words_.data(), words_.size(),
+                          words_.size() * kBitsPerWord);
+  }
+
+  bool empty() const { return words_.empty(); }
+
+  size_t size() const {
+    size_t result = 0;
+    for (uint64_t word : words_) result += absl::popcount(word);
+    return result;
+  }
+
+  bool contains(TagId tag) const {
+    size_t word_index = tag / kBitsPerWord;
+    return word_index < words_.size() &&
+           (words_[word_index] & BitOf(tag)) != 0;
+  }
+
+  // Adds the tag to the set. Returns true if it was not in the set before.
+  bool insert(TagId tag) {
+    size_t word_index = tag / kBitsPerWord;
+    if (word_index >= words_.size()) words_.resize(word_index + 1, 0);
+    bool inserted = (words_[word_index] & BitOf(tag)) == 0;
+    words_[word_index] |= BitOf(tag);
+    return inserted;
+  }
+
+  // Removes the tag from the set. Returns the number of removed tags.
+  size_t erase(TagId tag) {
+    size_t word_index = tag / kBitsPerWord;
+    if (word_index >= words_.size()) return 0;
+    size_t erased = (words_[word_index] & BitOf(tag)) != 0 ? 1 : 0;
+    words_[word_index] &= ~BitOf(tag);
+    TrimTrailingZeroWords();
+    return erased;
+  }
+
+  // Adds all tags of `other` to this set.
+  TagIdSet& operator|=(const TagIdSet& other) {
+    if (other.words_.size() > words_.size()) {
+      words_.resize(other.words_.size(), 0);
+    }
+    for (size_t i = 0; i < other.words_.size(); ++i) {
+      words_[i] |= other.words_[i];
+    }
+    return *this;
+  }
+
+  // Removes all tags from this set that are not in `other`.
+  TagIdSet& operator&=(const TagIdSet& other) {
+    if (words_.size() > other.words_.size()) {
+      words_.resize(other.words_.size());
+    }
+    for (size_t i = 0; i < words_.size(); ++i) {
+      words_[i] &= other.words_[i];
+    }
+    TrimTrailingZeroWords();
+    return *this;
+  }
+
+  ABSL_MUST_USE_RESULT TagIdSet Union(const TagIdSet& other) const {
+    TagIdSet result = *this;
+    result |= other;
+    return result;
+  }
+
+  ABSL_MUST_USE_RESULT TagIdSet Intersection(const TagIdSet& other) const {
+    TagIdSet result = *this;
+    result &= other;
+    return result;
+  }
+
+  bool operator==(const TagIdSet& other) const {
+    return words_ == other.words_;
+  }
+  bool operator!=(const TagIdSet& other) const { return !(*this == other); }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const TagIdSet& tag_id_set) {
+    return H::combine(std::move(h), tag_id_set.words_);
+  }
+
+ private:
+  static constexpr size_t kBitsPerWord = 64;
+  static constexpr size_t kInlineWords = 2;
+
+  static uint64_t BitOf(TagId tag) {
+    return uint64_t{1} << (tag % kBitsPerWord);
+  }
+
+  void TrimTrailingZeroWords() {
+    size_t num_words = words_.size();
+    while (num_words > 0 && words_[num_words - 1] == 0) --num_words;
+    words_.resize(num_words);
+  }
+
+  absl::InlinedVector<uint64_t, kInlineWords> words_;
+};
+
+}  // namespace raksha::analysis::taint
+
+#endif  // SRC_ANALYSIS_TAINT_TAG_ID_SET_H_
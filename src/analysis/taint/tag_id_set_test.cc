@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+#include "src/analysis/taint/tag_id_set.h"
+
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/btree_set.h"
+#include "src/common/testing/gtest.h"
+
+namespace raksha::analysis::taint {
+namespace {
+
+using ::testing::Combine;
+using ::testing::ElementsAreArray;
+using ::testing::IsEmpty;
+using ::testing::ValuesIn;
+
+// Tag sets that cover the inline words as well as the heap allocated ones.
+const std::vector<TagId> kTagSets[] = {
+    {}, {0}, {63}, {0, 1, 2}, {64}, {1, 127}, {128}, {3, 200, 1000}};
+
+using TagIdSetTest = ::testing::TestWithParam<std::vector<TagId>>;
+
+INSTANTIATE_TEST_SUITE_P(TagIdSetTests, TagIdSetTest, ValuesIn(kTagSets));
+
+TagIdSet MakeTagIdSet(const std::vector<TagId>& tags) {
+  TagIdSet result;
+  for (TagId tag : tags) result.insert(tag);
+  return result;
+}
+
+TEST_P(TagIdSetTest, IteratesOverInsertedTagsInOrder) {
+  const std::vector<TagId>& tags = GetParam();
+  TagIdSet tag_id_set = MakeTagIdSet(tags);
+  EXPECT_THAT(tag_id_set, ElementsAreArray(tags));
+  EXPECT_EQ(tag_id_set.size(), tags.size());
+  EXPECT_EQ(tag_id_set.empty(), tags.empty());
+  for (TagId tag : tags) EXPECT_TRUE(tag_id_set.contains(tag));
+  EXPECT_FALSE(tag_id_set.contains(5000));
+}
+
+TEST_P(TagIdSetTest, ErasingAllTagsGivesTheEmptySet) {
+  const std::vector<TagId>& tags = GetParam();
+  TagIdSet tag_id_set = MakeTagIdSet(tags);
+  for (TagId tag : tags) EXPECT_EQ(tag_id_set.erase(tag), 1);
+  EXPECT_THAT(tag_id_set, IsEmpty());
+  EXPECT_EQ(tag_id_set, TagIdSet());
+  EXPECT_EQ(tag_id_set.erase(5000), 0);
+}
+
+TEST(TagIdSetTest, InsertReportsWhetherTheTagIsNew) {
+  TagIdSet tag_id_set;
+  EXPECT_TRUE(tag_id_set.insert(70));
+  EXPECT_FALSE(tag_id_set.insert(70));
+}
+
+using TagIdSetBinaryOpTest = ::testing::TestWithParam<
+    std::tuple<std::vector<TagId>, std::vector<TagId>>>;
+
+INSTANTIATE_TEST_SUITE_P(TagIdSetBinaryOpTests, TagIdSetBinaryOpTest,
+                         Combine(ValuesIn(kTagSets), ValuesIn(kTagSets)));
+
+TEST_P(TagIdSetBinaryOpTest, UnionAndIntersectionMatchOrderedSets) {
+  const auto& [lhs, rhs] = GetParam();
+  absl::btree_set<TagId> expected_union(lhs.begin(), lhs.end());
+  expected_union.insert(rhs.begin(), rhs.end());
+  absl::btree_set<TagId> expected_intersection;
+  for (TagId tag : lhs) {
+    if (absl::c_linear_search(rhs, tag)) expected_intersection.insert(tag);
+  }
+
+  TagIdSet lhs_set = MakeTagIdSet(lhs);
+  TagIdSet rhs_set = MakeTagIdSet(rhs);
+  EXPECT_THAT(lhs_set.Union(rhs_set), ElementsAreArray(expected_union));
+  EXPECT_THAT(lhs_set.Intersection(rhs_set),
+              ElementsAreArray(expected_intersection));
+}
+
+TEST_P(TagIdSetBinaryOpTest, EqualityIsIndependentOfHistory) {
+  const auto& [lhs, rhs] = GetParam();
+  TagIdSet lhs_set = MakeTagIdSet(lhs);
+  TagIdSet rhs_set = MakeTagIdSet(rhs);
+  EXPECT_EQ(lhs_set == rhs_set, lhs == rhs);
+  EXPECT_EQ(lhs_set != rhs_set, lhs != rhs);
+  // The union may have more words than `lhs_set`, which the intersection has
+  // to trim again.
+  TagIdSet intersection = lhs_set.Intersection(lhs_set.Union(rhs_set));
+  EXPECT_EQ(intersection, lhs_set);
+}
+
+}  // namespace
+}  // namespace raksha::analysis::taint
@@ -1,27 +1,71 @@
 #include "src/backends/policy_engine/abstract_interpretation/abstract_interpretation_policy_checker.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "src/common/logging/logging.h"
 #include "src/ir/module.h"
+#include "src/ir/operator.h"
 
 namespace raksha::backends::policy_engine {
 
 TaintAnalysis::ValueStateMap
 AbstractInterpretationPolicyChecker::ComputeIfcTags(
     const ir::Module& module) const {
-  return TaintAnalysis().ComputeFixpoint(
+  auto semantics_maker = [this](const ir::Module& module) {
+    return analysis::taint::AbstractSemantics(inference_rules_);
+  };
+  if (num_threads_ > 1) {
+    return TaintAnalysis().ComputeFixpointInParallel(module, semantics_maker,
+                                                     num_threads_);
+  }
+  return TaintAnalysis().ComputeFixpoint(module, semantics_maker);
+}
+
+TaintAnalysis::ValueStateMap
+AbstractInterpretationPolicyChecker::RecomputeIfcTags(
+    const ir::Module& module,
+    const TaintAnalysis::ValueStateMap& previous_ifc_tags,
+    absl::Span<const ir::Operation* const> changed_operations) const {
+  return TaintAnalysis().ComputeFixpointIncrementally(
       module,
-      /*semantics_maker=*/[this](const ir::Module& module) {
+      /*semantics_maker=*/
+      [this](const ir::Module& module) {
         return analysis::taint::AbstractSemantics(inference_rules_);
-      });
+      },
+      previous_ifc_tags, changed_operations);
 }
 
 bool AbstractInterpretationPolicyChecker::IsModulePolicyCompliant(
     const ir::Module& module, const Policy& policy) const {
-  auto fixpoint_result = ComputeIfcTags(module);
+  return AreEgressesFreeOfSecrecy(module, ComputeIfcTags(module));
+}
+
+bool AbstractInterpretationPolicyChecker::RecheckModulePolicyCompliance(
+    const ir::Module& module, const Policy& policy,
+    absl::Span<const ir::Operation* const> changed_operations,
+    TaintAnalysis::ValueStateMap* ifc_tags) const {
+  CHECK(ifc_tags != nullptr) << "Re-check requires the previous IfcTags.";
+  *ifc_tags = RecomputeIfcTags(module, *ifc_tags, changed_operations);
+  return AreEgressesFreeOfSecrecy(module, *ifc_tags);
+}
+
+bool AbstractInterpretationPolicyChecker::AreEgressesFreeOfSecrecy(
+    const ir::Module& module,
+    const TaintAnalysis::ValueStateMap& fixpoint_result) const {
   // Check that all egresses don't have any secrecy tags.
   bool policy_compliant = true;
+  // Operators are interned by the context of the module, so each distinct
+  // operator is matched against the egress names only once rather than the
+  // name of every operation being hashed.
+  absl::flat_hash_map<const ir::Operator*, bool> is_egress_operator;
   for (const auto& block : module.blocks()) {
     for (const auto& operation : block->operations()) {
-      if (!egress_operation_names_.contains(operation->op().name())) continue;
+      auto [is_egress, inserted] =
+          is_egress_operator.try_emplace(&operation->op(), false);
+      if (inserted) {
+        is_egress->second =
+            egress_operation_names_.contains(operation->op().name());
+      }
+      if (!is_egress->second) continue;
       for (const auto& input : operation->inputs()) {
         auto find_result = fixpoint_result.find(input);
         // No result means this value was unreachable.
@@ -1,11 +1,13 @@
 #ifndef SRC_BACKENDS_POLICY_ENGINE_ABSTRACT_INTERPRETATION_ABSTRACT_INTERPRETATION_POLICY_CHECKER_H_
 #define SRC_BACKENDS_POLICY_ENGINE_ABSTRACT_INTERPRETATION_ABSTRACT_INTERPRETATION_POLICY_CHECKER_H_
 
+#include "absl/types/span.h"
 #include "src/analysis/common/module_fixpoint_iterator.h"
 #include "src/analysis/taint/abstract_semantics.h"
 #include "src/analysis/taint/inference_rules.h"
 #include "src/backends/policy_engine/policy.h"
 #include "src/backends/policy_engine/policy_checker.h"
+#include "src/ir/module.h"
 
 namespace raksha::backends::policy_engine {
 
@@ -14,11 +16,15 @@ using TaintAnalysis = raksha::analysis::common::ModuleFixpointIterator<
 
 class AbstractInterpretationPolicyChecker : public PolicyChecker {
  public:
+  // If `num_threads` is larger than one, independent parts of a module are
+  // analyzed in parallel on up to that many threads.
   AbstractInterpretationPolicyChecker(
       analysis::taint::InferenceRules inference_rules,
-      absl::flat_hash_set<std::string> egress_operation_names)
+      absl::flat_hash_set<std::string> egress_operation_names,
+      size_t num_threads = 1)
       : inference_rules_(std::move(inference_rules)),
-        egress_operation_names_(std::move(egress_operation_names)) {}
+        egress_operation_names_(std::move(egress_operation_names)),
+        num_threads_(num_threads) {}
 
   bool IsModulePolicyCompliant(const ir::Module& module,
                                const Policy& policy) const override;
@@ -26,9 +32,34 @@ class AbstractInterpretationPolicyChecker : public PolicyChecker {
   // Returns the IfcTags for the values in module by performing taint analysis.
   TaintAnalysis::ValueStateMap ComputeIfcTags(const ir::Module& module) const;
 
+  // Returns the IfcTags for the values in `module`, which has been derived
+  // from an earlier version by adding or changing `changed_operations`.
+  // `previous_ifc_tags` must be the IfcTags of the earlier version. Only the
+  // values that depend on the changed operations are recomputed.
+  TaintAnalysis::ValueStateMap RecomputeIfcTags(
+      const ir::Module& module,
+      const TaintAnalysis::ValueStateMap& previous_ifc_tags,
+      absl::Span<const ir::Operation* const> changed_operations) const;
+
+  // Checks `module` against the policy after `changed_operations` have been
+  // added to or changed in it. `ifc_tags` must hold the IfcTags of the module
+  // before the change and is updated to those of the changed module, so that
+  // it can be passed to the next re-check.
+  bool RecheckModulePolicyCompliance(
+      const ir::Module& module, const Policy& policy,
+      absl::Span<const ir::Operation* const> changed_operations,
+      TaintAnalysis::ValueStateMap* ifc_tags) const;
+
  private:
+  // Returns true if no input of an egress operation of `module` has secrecy
+  // tags in `ifc_tags`.
+  bool AreEgressesFreeOfSecrecy(
+      const ir::Module& module,
+      const TaintAnalysis::ValueStateMap& ifc_tags) const;
+
   analysis::taint::InferenceRules inference_rules_;
   absl::flat_hash_set<std::string> egress_operation_names_;
+  size_t num_threads_;
 };
 
 }  // namespace raksha::backends::policy_engine
@@ -173,6 +173,16 @@ TEST_P(AbstractInterpretationPolicyCheckerTest, ExpectedFixpointIsComputed) {
                                  GetParam().fixpoint_result));
 }
 
+TEST_P(AbstractInterpretationPolicyCheckerTest,
+       ParallelFixpointMatchesExpectedFixpoint) {
+  AbstractInterpretationPolicyChecker checker(inference_rules(), {},
+                                              /*num_threads=*/4);
+  TaintAnalysis::ValueStateMap results = checker.ComputeIfcTags(module());
+  EXPECT_THAT(results,
+              UnorderedPointwise(EquivalentToValueForSsaNameKey(ssa_names()),
+                                 GetParam().fixpoint_result));
+}
+
 TEST_P(AbstractInterpretationPolicyCheckerTest, PolicyViolationCheckIsCorrect) {
   AbstractInterpretationPolicyChecker checker(
       inference_rules(), {std::string(OpTraits<SqlOutputOp>::kName)});
@@ -181,6 +191,33 @@ TEST_P(AbstractInterpretationPolicyCheckerTest, PolicyViolationCheckIsCorrect) {
               Eq(GetParam().policy_compliant));
 }
 
+TEST_P(AbstractInterpretationPolicyCheckerTest, RecheckIsCorrect) {
+  AbstractInterpretationPolicyChecker checker(
+      inference_rules(), {std::string(OpTraits<SqlOutputOp>::kName)});
+  SqlPolicyRulePolicy policy("");
+  std::vector<const ir::Operation*> operations;
+  for (const auto& block : module().blocks()) {
+    for (const auto& operation : block->operations()) {
+      operations.push_back(operation.get());
+    }
+  }
+  // Everything changed, so nothing can be reused.
+  TaintAnalysis::ValueStateMap ifc_tags;
+  EXPECT_THAT(checker.RecheckModulePolicyCompliance(module(), policy,
+                                                    operations, &ifc_tags),
+              Eq(GetParam().policy_compliant));
+  EXPECT_THAT(ifc_tags,
+              UnorderedPointwise(EquivalentToValueForSsaNameKey(ssa_names()),
+                                 GetParam().fixpoint_result));
+  // Nothing changed, so everything is reused.
+  EXPECT_THAT(checker.RecheckModulePolicyCompliance(
+                  module(), policy, /*changed_operations=*/{}, &ifc_tags),
+              Eq(GetParam().policy_compliant));
+  EXPECT_THAT(ifc_tags,
+              UnorderedPointwise(EquivalentToValueForSsaNameKey(ssa_names()),
+                                 GetParam().fixpoint_result));
+}
+
 TEST(AbstractInterpretationPolicyCheckerTest,
      PolicyViolationCheckRespectsEgress) {
   constexpr absl::string_view module_text = R"(
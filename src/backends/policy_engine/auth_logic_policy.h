@@ -32,10 +32,14 @@ class AuthLogicPolicy : public Policy {
             std::move(auth_logic_policy_engine_name)) {}
 
   // policy checker for authorization logic based policies.
-  std::unique_ptr<souffle::SouffleProgram> GetPolicyAnalysisChecker()
+  std::unique_ptr<::souffle::SouffleProgram> GetPolicyAnalysisChecker()
       const override {
-    return std::unique_ptr<souffle::SouffleProgram>(
-        souffle::ProgramFactory::newInstance(auth_logic_policy_engine_name_));
+    return std::unique_ptr<::souffle::SouffleProgram>(
+        ::souffle::ProgramFactory::newInstance(auth_logic_policy_engine_name_));
+  }
+
+  std::optional<std::string> GetPolicyAnalysisCheckerName() const override {
+    return auth_logic_policy_engine_name_;
   }
 
   // Policies from authorization logic are converetd to datalog and eventually
@@ -40,10 +40,14 @@ class CatchallPolicyRulePolicy : public Policy {
   explicit CatchallPolicyRulePolicy(std::string is_sql_policy_rule_facts)
       : is_sql_policy_rule_facts_(std::move(is_sql_policy_rule_facts)) {}
 
-  std::unique_ptr<souffle::SouffleProgram> GetPolicyAnalysisChecker()
+  std::unique_ptr<::souffle::SouffleProgram> GetPolicyAnalysisChecker()
       const override {
-    return std::unique_ptr<souffle::SouffleProgram>(
-        ABSL_DIE_IF_NULL(souffle::newInstance_datalog_policy_verifier_cxx()));
+    return std::unique_ptr<::souffle::SouffleProgram>(
+        ABSL_DIE_IF_NULL(::souffle::newInstance_datalog_policy_verifier_cxx()));
+  }
+
+  std::optional<std::string> GetPolicyAnalysisCheckerName() const override {
+    return "datalog_policy_verifier_cxx";
   }
 
   std::optional<std::string> GetPolicyFactName() const override {
@@ -47,10 +47,14 @@ class DpParameterPolicy : public Policy {
       : epsilon_(epsilon), delta_(delta) {}
 
   // Always use the checker compiled from the DP policy verifier interface.
-  std::unique_ptr<souffle::SouffleProgram> GetPolicyAnalysisChecker()
+  std::unique_ptr<::souffle::SouffleProgram> GetPolicyAnalysisChecker()
       const override {
-    return std::unique_ptr<souffle::SouffleProgram>(
-        ABSL_DIE_IF_NULL(souffle::newInstance_dp_policy_verifier_cxx()));
+    return std::unique_ptr<::souffle::SouffleProgram>(
+        ABSL_DIE_IF_NULL(::souffle::newInstance_dp_policy_verifier_cxx()));
+  }
+
+  std::optional<std::string> GetPolicyAnalysisCheckerName() const override {
+    return "dp_policy_verifier_cxx";
   }
 
   // This policy always populates the `isDPParameter` relation.
@@ -18,12 +18,17 @@
 
 #include <memory>
 #include <optional>
+#include <string>
 
 #include "souffle/SouffleInterface.h"
 #include "absl/strings/string_view.h"
 
 namespace raksha::backends::policy_engine {
 
+namespace souffle {
+class SouffleProgramPool;
+}  // namespace souffle
+
 // Placeholder for the Policy interface. Right now, the policy is represented
 // as a string of datalog facts dumped to a facts file, whereas we will
 // probably want something more flexible in the future.
@@ -43,9 +48,18 @@ class Policy {
   // into the analysis itself. Thus, it is only appropriate to place the checker
   // to be called into the `Policy` as if the data compiled in were opaque
   // members of this object.
-  virtual std::unique_ptr<souffle::SouffleProgram> GetPolicyAnalysisChecker()
+  virtual std::unique_ptr<::souffle::SouffleProgram> GetPolicyAnalysisChecker()
       const = 0;
 
+  // The name under which the Souffle program returned by
+  // `GetPolicyAnalysisChecker` is registered. Checkers use it to reuse program
+  // instances across checks: two policies returning the same name must return
+  // the same kind of program. A policy that does not want its checker to be
+  // reused can leave this absent.
+  virtual std::optional<std::string> GetPolicyAnalysisCheckerName() const {
+    return std::nullopt;
+  }
+
   // Gets the name of the Datalog fact populated by this policy. If this policy
   // does not populate any facts, (it is all compiled into the analysis) this
   // can be absent.
@@ -55,6 +69,22 @@ class Policy {
   // policy. If this policy does not populate any facts, (it is all compiled
   // into the analysis) this can be absent.
   virtual std::optional<std::string> GetPolicyString() const = 0;
+
+  // Whether the analysis of this policy judges each module by its own facts
+  // alone, so that an evaluation on the combined facts of several modules
+  // finds exactly the violations that separate evaluations would find.
+  // Checkers may then check many modules at once. This may only be true for
+  // analyses that have been verified to relate facts solely through the
+  // values they share; an analysis with a global condition, such as the
+  // absence of some kind of operation, is not module-local.
+  virtual bool IsModuleLocal() const { return false; }
+
+  // A pool of instances of the program of this policy that already hold the
+  // facts of the policy, if the policy keeps one. Checkers then take their
+  // programs from this pool and only load the facts of the checked modules.
+  virtual souffle::SouffleProgramPool* GetPreloadedProgramPool() const {
+    return nullptr;
+  }
 };
 
 }  // namespace raksha::backends::policy_engine
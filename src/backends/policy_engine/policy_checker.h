@@ -16,6 +16,9 @@
 #ifndef SRC_BACKENDS_POLICY_ENGINE_POLICY_CHECKER_H_
 #define SRC_BACKENDS_POLICY_ENGINE_POLICY_CHECKER_H_
 
+#include <vector>
+
+#include "absl/types/span.h"
 #include "src/backends/policy_engine/policy.h"
 #include "src/ir/module.h"
 
@@ -29,6 +32,19 @@ class PolicyChecker {
   // Returns true if the given module is compliant with the given policy.
   virtual bool IsModulePolicyCompliant(const ir::Module& module,
                                        const Policy& policy) const = 0;
+
+  // Returns, for each of the given modules, whether it is compliant with the
+  // given policy. Checkers that can amortize work across modules should
+  // override this; by default, each module is checked on its own.
+  virtual std::vector<bool> AreModulesPolicyCompliant(
+      absl::Span<const ir::Module* const> modules, const Policy& policy) const {
+    std::vector<bool> result;
+    result.reserve(modules.size());
+    for (const ir::Module* module : modules) {
+      result.push_back(IsModulePolicyCompliant(*module, policy));
+    }
+    return result;
+  }
 };
 
 }  // namespace raksha::backends::policy_engine
@@ -0,0 +1,175 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/adt_branch_indices.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+namespace {
+
+constexpr absl::string_view kTypeDirective = ".type";
+
+// Returns `datalog` with its comments blanked out. Strings are kept as they
+// are, so comment markers in strings are left alone.
+std::string BlankOutComments(absl::string_view datalog) {
+  std::string result(datalog);
+  size_t index = 0;
+  while (index < result.size()) {
+    if (result[index] == '"') {
+      for (++index; index < result.size() && result[index] != '"'; ++index) {
+        if (result[index] == '\\') ++index;
+      }
+      ++index;
+      continue;
+    }
+    size_t end = index;
+    if (result.compare(index, 2, "//") == 0) {
+      end = std::min(result.find('\n', index), result.size());
+    } else if (result.compare(index, 2, "/*") == 0) {
+      end = result.find("*/", index + 2);
+      end = (end == std::string::npos) ? result.size() : end + 2;
+    } else {
+      ++index;
+      continue;
+    }
+    std::fill(result.begin() + index, result.begin() + end, ' ');
+    index = end;
+  }
+  return result;
+}
+
+bool IsIdentifierCharacter(char character) {
+  return absl::ascii_isalnum(character) || character == '_' ||
+         character == '?';
+}
+
+// Returns whether a directive or preprocessor line may start at `index`, i.e.,
+// whether it is at the start of `source` or follows whitespace.
+bool IsAtTokenStart(absl::string_view source, size_t index) {
+  return index == 0 || absl::ascii_isspace(source[index - 1]);
+}
+
+// Returns the end of the declaration whose body starts at `begin`, which is
+// where the next directive or preprocessor line starts.
+size_t FindDeclarationEnd(absl::string_view source, size_t begin) {
+  int depth = 0;
+  for (size_t index = begin; index < source.size(); ++index) {
+    switch (source[index]) {
+      case '{':
+      case '[':
+        ++depth;
+        break;
+      case '}':
+      case ']':
+        --depth;
+        break;
+      case '.':
+      case '#':
+        if (depth == 0 && IsAtTokenStart(source, index)) return index;
+        break;
+      default:
+        break;
+    }
+  }
+  return source.size();
+}
+
+// Returns the names of the branches declared by the body of a `.type`
+// declaration, in the order of the declaration. The result is empty if the
+// declaration is not an ADT.
+absl::StatusOr<std::vector<std::string>> GetBranchNames(
+    absl::string_view declaration) {
+  std::vector<std::string> branch_names;
+  size_t equals = declaration.find('=');
+  if (equals == absl::string_view::npos) return branch_names;
+  int depth = 0;
+  for (size_t index = equals + 1; index < declaration.size(); ++index) {
+    char character = declaration[index];
+    if (character == '}' || character == ']') {
+      --depth;
+      continue;
+    }
+    if (character == '[') {
+      ++depth;
+      continue;
+    }
+    if (character != '{') continue;
+    if (depth++ > 0) continue;
+    // The branch name is the identifier in front of the brace.
+    size_t name_end = index;
+    while (name_end > equals + 1 &&
+           absl::ascii_isspace(declaration[name_end - 1])) {
+      --name_end;
+    }
+    size_t name_begin = name_end;
+    while (name_begin > equals + 1 &&
+           IsIdentifierCharacter(declaration[name_begin - 1])) {
+      --name_begin;
+    }
+    if (name_begin == name_end) {
+      return absl::InvalidArgumentError(absl::StrFormat(
+          "Expected a branch name in `%s`.", declaration));
+    }
+    branch_names.emplace_back(
+        declaration.substr(name_begin, name_end - name_begin));
+  }
+  return branch_names;
+}
+
+}  // namespace
+
+absl::Status AddAdtBranchIndices(absl::string_view datalog,
+                                 AdtBranchIndices &branch_indices) {
+  std::string blanked_out_source = BlankOutComments(datalog);
+  absl::string_view source(blanked_out_source);
+  size_t position = 0;
+  while ((position = source.find(kTypeDirective, position)) !=
+         absl::string_view::npos) {
+    size_t body_begin = position + kTypeDirective.size();
+    if (!IsAtTokenStart(source, position) || body_begin >= source.size() ||
+        !absl::ascii_isspace(source[body_begin])) {
+      position = body_begin;
+      continue;
+    }
+    position = FindDeclarationEnd(source, body_begin);
+    absl::StatusOr<std::vector<std::string>> branch_names =
+        GetBranchNames(source.substr(body_begin, position - body_begin));
+    if (!branch_names.ok()) return branch_names.status();
+    std::sort(branch_names->begin(), branch_names->end());
+    for (size_t index = 0; index < branch_names->size(); ++index) {
+      const std::string &branch_name = (*branch_names)[index];
+      auto [entry, inserted] = branch_indices.insert(
+          {branch_name, static_cast<int64_t>(index)});
+      if (!inserted && entry->second != static_cast<int64_t>(index)) {
+        return absl::InvalidArgumentError(absl::StrFormat(
+            "ADT branch `%s` is declared by more than one ADT.",
+            branch_name));
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace raksha::backends::policy_engine::souffle
@@ -0,0 +1,45 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#ifndef SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_ADT_BRANCH_INDICES_H_
+#define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_ADT_BRANCH_INDICES_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+// The index that Souffle assigns to each branch of the algebraic data types
+// of a program, by branch name. Souffle numbers the branches of an ADT in the
+// lexicographic order of their names and requires branch names to be unique
+// across all ADTs of a program, so the branch name alone determines the
+// index.
+using AdtBranchIndices = std::map<std::string, int64_t>;
+
+// Finds the `.type` declarations of algebraic data types in the Datalog source
+// `datalog` and adds the indices of their branches to `branch_indices`.
+// Subtypes, unions, and record types are skipped. Fails if a branch is
+// already in `branch_indices` with a different index, which means that two
+// ADTs use the same branch name.
+absl::Status AddAdtBranchIndices(absl::string_view datalog,
+                                 AdtBranchIndices &branch_indices);
+
+}  // namespace raksha::backends::policy_engine::souffle
+
+#endif  // SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_ADT_BRANCH_INDICES_H_
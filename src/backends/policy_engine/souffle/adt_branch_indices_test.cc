@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/adt_branch_indices.h"
+
+#include "absl/status/status.h"
+#include "src/common/testing/gtest.h"
+
+namespace raksha::backends::policy_engine::souffle {
+namespace {
+
+using ::testing::IsEmpty;
+using ::testing::Pair;
+using ::testing::UnorderedElementsAre;
+
+TEST(AdtBranchIndicesTest, NumbersBranchesInLexicographicOrder) {
+  AdtBranchIndices branch_indices;
+  ASSERT_TRUE(AddAdtBranchIndices(R"(
+.type SqlPolicyRuleResult =
+  AddIntegrityTag { tag: IntegrityTag }
+  | RemoveConfidentialityTag { tag: Tag }
+  | AddConfidentialityTag { tag: Tag }
+)",
+                                  branch_indices)
+                  .ok());
+  EXPECT_THAT(branch_indices,
+              UnorderedElementsAre(Pair("AddConfidentialityTag", 0),
+                                   Pair("AddIntegrityTag", 1),
+                                   Pair("RemoveConfidentialityTag", 2)));
+}
+
+TEST(AdtBranchIndicesTest, SkipsTypesThatAreNotAdts) {
+  AdtBranchIndices branch_indices;
+  ASSERT_TRUE(AddAdtBranchIndices(R"(
+.type Tag <: symbol
+.type Principal = symbol | number
+.type Attribute = [attr_name: AttributeName, attr_payload: AttributePayload]
+.decl isTag(tag: Tag)
+)",
+                                  branch_indices)
+                  .ok());
+  EXPECT_THAT(branch_indices, IsEmpty());
+}
+
+TEST(AdtBranchIndicesTest, HandlesCommentsAndDirectivesAroundDeclarations) {
+  AdtBranchIndices branch_indices;
+  ASSERT_TRUE(AddAdtBranchIndices(R"(
+#include "src/analysis/souffle/tags.dl"
+.type IFCTag = ITag{ iTag: IntegrityTag } | CTag{ cTag: Tag }
+.type CheckPredicate =
+  CP_TagPresence { ap: AccessPath, principal: Principal, tag: IFCTag }
+  | CP_And { lhs: CheckPredicate, rhs: CheckPredicate }
+// Note: CP_Not { inner } is described here, but declared below.
+  | CP_Not { inner: CheckPredicate }
+/* .type Commented = Out { x: number } */
+.decl checkP(name: symbol, pred: CheckPredicate)
+.type Nested = Outer { inner: [ first: number, second: number ] }
+)",
+                                  branch_indices)
+                  .ok());
+  EXPECT_THAT(branch_indices,
+              UnorderedElementsAre(Pair("CTag", 0), Pair("ITag", 1),
+                                   Pair("CP_And", 0), Pair("CP_Not", 1),
+                                   Pair("CP_TagPresence", 2),
+                                   Pair("Outer", 0)));
+}
+
+TEST(AdtBranchIndicesTest, AcceptsTheSameAdtFromSeveralSources) {
+  constexpr char kDatalog[] =
+      ".type DPParameterValue = EpsilonValue { value: Epsilon }\n"
+      "    | DeltaValue { value: Delta }\n";
+  AdtBranchIndices branch_indices;
+  ASSERT_TRUE(AddAdtBranchIndices(kDatalog, branch_indices).ok());
+  ASSERT_TRUE(AddAdtBranchIndices(kDatalog, branch_indices).ok());
+  EXPECT_THAT(branch_indices, UnorderedElementsAre(Pair("DeltaValue", 0),
+                                                   Pair("EpsilonValue", 1)));
+}
+
+TEST(AdtBranchIndicesTest, RejectsBranchNamesSharedByAdts) {
+  AdtBranchIndices branch_indices;
+  absl::Status status = AddAdtBranchIndices(
+      ".type A = Shared { x: number } | Z { x: number }\n"
+      ".type B = Alpha { x: number } | Shared { x: number }\n",
+      branch_indices);
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace raksha::backends::policy_engine::souffle
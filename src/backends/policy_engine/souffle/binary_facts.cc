@@ -0,0 +1,354 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/binary_facts.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/casts.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/strip.h"
+#include "src/common/logging/logging.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+namespace {
+
+using EncodedValue = ir::datalog::ValueEncoder::EncodedValue;
+
+constexpr absl::string_view kMagic("RKSHFCT\0", 8);
+constexpr uint64_t kVersion = 1;
+
+// The kinds of entries in the value table. Each kind is followed by a fixed
+// number of words, and records and ADT branches by one more word per field or
+// argument.
+enum ValueKind : uint64_t {
+  // Followed by the number.
+  kNumber = 0,
+  // Followed by the bits of the double.
+  kFloat = 1,
+  // Followed by the index of the symbol.
+  kSymbol = 2,
+  kNil = 3,
+  // Followed by the arity and the indices of the fields.
+  kRecord = 4,
+  // Followed by the index of the branch name symbol, the arity and the
+  // indices of the arguments.
+  kAdtBranch = 5,
+};
+
+void AppendWord(uint64_t word, std::string &out) {
+  for (int byte = 0; byte < 8; ++byte) {
+    out.push_back(static_cast<char>((word >> (8 * byte)) & 0xff));
+  }
+}
+
+// Reads the words and bytes of a binary facts file front to back.
+class BinaryFactsReader {
+ public:
+  explicit BinaryFactsReader(absl::string_view data) : remaining_(data) {}
+
+  bool ReadWord(uint64_t &word) {
+    if (remaining_.size() < 8) return false;
+    word = 0;
+    for (int byte = 0; byte < 8; ++byte) {
+      word |= uint64_t{static_cast<unsigned char>(remaining_[byte])}
+              << (8 * byte);
+    }
+    remaining_.remove_prefix(8);
+    return true;
+  }
+
+  bool ReadBytes(uint64_t size, absl::string_view &bytes) {
+    if (remaining_.size() < size) return false;
+    bytes = remaining_.substr(0, size);
+    remaining_.remove_prefix(size);
+    return true;
+  }
+
+  // Returns whether at least `count` words are left.
+  bool HasWords(uint64_t count) const { return remaining_.size() / 8 >= count; }
+
+  bool ConsumeMagic() { return absl::ConsumePrefix(&remaining_, kMagic); }
+
+  bool AtEnd() const { return remaining_.empty(); }
+
+ private:
+  absl::string_view remaining_;
+};
+
+absl::Status Malformed(absl::string_view message) {
+  return absl::InvalidArgumentError(
+      absl::StrFormat("Malformed binary facts: %s", message));
+}
+
+}  // namespace
+
+EncodedValue BinaryFactsWriter::EncodeNumber(int64_t number) {
+  return InternValue({kNumber, static_cast<uint64_t>(number)});
+}
+
+EncodedValue BinaryFactsWriter::EncodeFloat(double number) {
+  return InternValue({kFloat, absl::bit_cast<uint64_t>(number)});
+}
+
+EncodedValue BinaryFactsWriter::EncodeSymbol(absl::string_view symbol) {
+  return InternValue({kSymbol, InternSymbol(symbol)});
+}
+
+EncodedValue BinaryFactsWriter::EncodeNil() { return InternValue({kNil}); }
+
+EncodedValue BinaryFactsWriter::EncodeRecord(
+    absl::Span<const EncodedValue> fields) {
+  std::vector<uint64_t> words = {kRecord, fields.size()};
+  words.insert(words.end(), fields.begin(), fields.end());
+  return InternValue(std::move(words));
+}
+
+EncodedValue BinaryFactsWriter::EncodeAdtBranch(
+    absl::string_view branch_name, absl::Span<const EncodedValue> arguments) {
+  std::vector<uint64_t> words = {kAdtBranch, InternSymbol(branch_name),
+                                 arguments.size()};
+  words.insert(words.end(), arguments.begin(), arguments.end());
+  return InternValue(std::move(words));
+}
+
+void BinaryFactsWriter::AddFact(absl::string_view relation_name,
+                                absl::Span<const EncodedValue> columns) {
+  auto [it, inserted] =
+      relation_indices_.try_emplace(relation_name, relations_.size());
+  if (inserted) {
+    relations_.push_back({.name_index = InternSymbol(relation_name),
+                          .arity = columns.size(),
+                          .num_tuples = 0,
+                          .columns = {}});
+  }
+  RelationTuples &relation = relations_[it->second];
+  CHECK(relation.arity == columns.size())
+      << "Arity mismatch when adding a fact to `" << relation_name << "`.";
+  // A nullary relation holds at most the empty tuple.
+  if (relation.arity == 0 && relation.num_tuples == 1) return;
+  ++relation.num_tuples;
+  for (EncodedValue column : columns) {
+    CHECK(column >= 0 && static_cast<size_t>(column) < values_.size())
+        << "Columns must be encoded by the writer they are added to.";
+    relation.columns.push_back(column);
+  }
+}
+
+std::string BinaryFactsWriter::Serialize() const {
+  std::string result(kMagic);
+  AppendWord(kVersion, result);
+  AppendWord(symbols_.size(), result);
+  for (const std::string &symbol : symbols_) {
+    AppendWord(symbol.size(), result);
+    result.append(symbol);
+  }
+  AppendWord(values_.size(), result);
+  for (const std::vector<uint64_t> &value : values_) {
+    for (uint64_t word : value) AppendWord(word, result);
+  }
+  AppendWord(relations_.size(), result);
+  for (const RelationTuples &relation : relations_) {
+    AppendWord(relation.name_index, result);
+    AppendWord(relation.arity, result);
+    AppendWord(relation.num_tuples, result);
+    for (uint64_t column : relation.columns) AppendWord(column, result);
+  }
+  return result;
+}
+
+absl::Status BinaryFactsWriter::WriteToFile(
+    const std::filesystem::path &path) const {
+  std::ofstream file(path, std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!file) {
+    return absl::FailedPreconditionError(
+        absl::StrFormat("Unable to create binary facts file `%s`: `%s`", path,
+                        std::strerror(errno)));
+  }
+  std::string contents = Serialize();
+  file.write(contents.data(), contents.size());
+  file.close();
+  if (!file) {
+    return absl::InternalError(
+        absl::StrFormat("Unable to write binary facts file `%s`: `%s`", path,
+                        std::strerror(errno)));
+  }
+  return absl::OkStatus();
+}
+
+uint64_t BinaryFactsWriter::InternSymbol(absl::string_view symbol) {
+  auto [it, inserted] = symbol_indices_.try_emplace(symbol, symbols_.size());
+  if (inserted) symbols_.push_back(std::string(symbol));
+  return it->second;
+}
+
+EncodedValue BinaryFactsWriter::InternValue(std::vector<uint64_t> words) {
+  auto [it, inserted] = value_indices_.try_emplace(words, values_.size());
+  if (inserted) values_.push_back(std::move(words));
+  return it->second;
+}
+
+absl::Status DecodeBinaryFacts(
+    absl::string_view binary_facts, ir::datalog::ValueEncoder &encoder,
+    absl::FunctionRef<void(absl::string_view relation_name,
+                           absl::Span<const EncodedValue> columns,
+                           absl::Span<const BinaryValueKind> column_kinds)>
+        add_fact) {
+  BinaryFactsReader reader(binary_facts);
+  if (!reader.ConsumeMagic()) return Malformed("missing header");
+  uint64_t version = 0;
+  if (!reader.ReadWord(version) || version != kVersion) {
+    return Malformed("unsupported version");
+  }
+
+  uint64_t num_symbols = 0;
+  if (!reader.ReadWord(num_symbols) || !reader.HasWords(num_symbols)) {
+    return Malformed("truncated symbol table");
+  }
+  std::vector<absl::string_view> symbols(num_symbols);
+  for (absl::string_view &symbol : symbols) {
+    uint64_t size = 0;
+    if (!reader.ReadWord(size) || !reader.ReadBytes(size, symbol)) {
+      return Malformed("truncated symbol");
+    }
+  }
+  auto read_symbol = [&](absl::string_view &symbol) {
+    uint64_t index = 0;
+    if (!reader.ReadWord(index) || index >= symbols.size()) return false;
+    symbol = symbols[index];
+    return true;
+  };
+
+  uint64_t num_values = 0;
+  if (!reader.ReadWord(num_values) || !reader.HasWords(num_values)) {
+    return Malformed("truncated value table");
+  }
+  std::vector<EncodedValue> values;
+  values.reserve(num_values);
+  std::vector<BinaryValueKind> kinds;
+  kinds.reserve(num_values);
+  // Reads `arity` indices of values decoded before into `parts`, and their
+  // kinds into `part_kinds`.
+  std::vector<EncodedValue> parts;
+  std::vector<BinaryValueKind> part_kinds;
+  auto read_parts = [&](uint64_t arity) {
+    if (!reader.HasWords(arity)) return false;
+    parts.clear();
+    part_kinds.clear();
+    for (uint64_t i = 0; i < arity; ++i) {
+      uint64_t index = 0;
+      if (!reader.ReadWord(index) || index >= values.size()) return false;
+      parts.push_back(values[index]);
+      part_kinds.push_back(kinds[index]);
+    }
+    return true;
+  };
+  for (uint64_t index = 0; index < num_values; ++index) {
+    uint64_t kind = 0;
+    uint64_t payload = 0;
+    absl::string_view symbol;
+    if (!reader.ReadWord(kind)) return Malformed("truncated value");
+    switch (kind) {
+      case kNumber:
+        if (!reader.ReadWord(payload)) return Malformed("truncated number");
+        values.push_back(encoder.EncodeNumber(static_cast<int64_t>(payload)));
+        kinds.push_back(BinaryValueKind::kNumber);
+        break;
+      case kFloat:
+        if (!reader.ReadWord(payload)) return Malformed("truncated float");
+        values.push_back(encoder.EncodeFloat(absl::bit_cast<double>(payload)));
+        kinds.push_back(BinaryValueKind::kFloat);
+        break;
+      case kSymbol:
+        if (!read_symbol(symbol)) return Malformed("invalid symbol index");
+        values.push_back(encoder.EncodeSymbol(symbol));
+        kinds.push_back(BinaryValueKind::kSymbol);
+        break;
+      case kNil:
+        values.push_back(encoder.EncodeNil());
+        kinds.push_back(BinaryValueKind::kNil);
+        break;
+      case kRecord:
+        if (!reader.ReadWord(payload) || payload == 0 ||
+            !read_parts(payload)) {
+          return Malformed("invalid record");
+        }
+        values.push_back(encoder.EncodeRecord(parts));
+        kinds.push_back(BinaryValueKind::kRecord);
+        break;
+      case kAdtBranch:
+        if (!read_symbol(symbol) || !reader.ReadWord(payload) ||
+            !read_parts(payload)) {
+          return Malformed("invalid ADT branch");
+        }
+        values.push_back(encoder.EncodeAdtBranch(symbol, parts));
+        kinds.push_back(BinaryValueKind::kAdtBranch);
+        break;
+      default:
+        return Malformed(absl::StrFormat("unknown value kind %d", kind));
+    }
+  }
+
+  uint64_t num_relations = 0;
+  if (!reader.ReadWord(num_relations)) return Malformed("missing relations");
+  for (uint64_t relation = 0; relation < num_relations; ++relation) {
+    absl::string_view relation_name;
+    uint64_t arity = 0;
+    uint64_t num_tuples = 0;
+    if (!read_symbol(relation_name) || !reader.ReadWord(arity) ||
+        !reader.ReadWord(num_tuples)) {
+      return Malformed("truncated relation header");
+    }
+    // Check the size up front so that a corrupt count cannot overflow it.
+    // Tuples of a nullary relation take no space, but there is at most one.
+    if (arity == 0 ? num_tuples > 1
+                   : num_tuples > binary_facts.size() / 8 / arity) {
+      return Malformed(
+          absl::StrFormat("truncated tuples of `%s`", relation_name));
+    }
+    for (uint64_t tuple = 0; tuple < num_tuples; ++tuple) {
+      if (!read_parts(arity)) {
+        return Malformed(
+            absl::StrFormat("invalid tuple of `%s`", relation_name));
+      }
+      add_fact(relation_name, parts, part_kinds);
+    }
+  }
+  if (!reader.AtEnd()) return Malformed("trailing data");
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> ReadBinaryFactsFile(
+    const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    return absl::NotFoundError(
+        absl::StrFormat("Unable to open binary facts file `%s`: `%s`", path,
+                        std::strerror(errno)));
+  }
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+}  // namespace raksha::backends::policy_engine::souffle
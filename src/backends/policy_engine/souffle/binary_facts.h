@@ -0,0 +1,131 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#ifndef SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_BINARY_FACTS_H_
+#define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_BINARY_FACTS_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "src/ir/datalog/value.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+// A compact alternative to `.facts` files. Rather than one text file per
+// relation with quoted symbols, a binary facts file holds
+//
+//  - a table of the symbols of all facts, each stored once,
+//  - a table of values, where each compound value refers to the values and
+//    symbols it is made of by their index, and
+//  - for each relation, its arity, the number of its tuples and the tuples as
+//    fixed-width rows of value indices. A nullary relation has at most one
+//    tuple, which takes no space.
+//
+// All integers are 64-bit little-endian. Values only refer to earlier values,
+// so a reader can hand each value to a `ValueEncoder` in a single pass and
+// insert the tuples without parsing any text.
+
+// Builds a binary facts file. The writer is itself a `ValueEncoder`: values are
+// encoded into the value table of the file, and equal values share an entry.
+class BinaryFactsWriter : public ir::datalog::ValueEncoder {
+ public:
+  EncodedValue EncodeNumber(int64_t number) override;
+  EncodedValue EncodeFloat(double number) override;
+  EncodedValue EncodeSymbol(absl::string_view symbol) override;
+  EncodedValue EncodeNil() override;
+  EncodedValue EncodeRecord(absl::Span<const EncodedValue> fields) override;
+  EncodedValue EncodeAdtBranch(
+      absl::string_view branch_name,
+      absl::Span<const EncodedValue> arguments) override;
+
+  // Adds a fact to the relation `relation_name`. The columns must have been
+  // encoded by this writer.
+  void AddFact(absl::string_view relation_name,
+               absl::Span<const EncodedValue> columns);
+
+  // Adds each of the given `InputRelationFact`s to its relation.
+  template <typename Fact>
+  void AddFacts(absl::Span<const Fact> facts) {
+    for (const Fact &fact : facts) {
+      AddFact(Fact::relation_name(), fact.EncodeRelationArguments(*this));
+    }
+  }
+
+  // Returns the facts added so far in the binary format.
+  std::string Serialize() const;
+
+  // Writes the facts added so far to the file at `path`.
+  absl::Status WriteToFile(const std::filesystem::path &path) const;
+
+ private:
+  // The tuples of a relation, stored row after row. The number of tuples is
+  // kept apart from the columns, as tuples of nullary relations have none.
+  struct RelationTuples {
+    uint64_t name_index;
+    uint64_t arity;
+    uint64_t num_tuples;
+    std::vector<uint64_t> columns;
+  };
+
+  uint64_t InternSymbol(absl::string_view symbol);
+  // Returns the index of the value with the given serialized form, adding it
+  // to the value table if it is not there yet.
+  EncodedValue InternValue(std::vector<uint64_t> words);
+
+  std::vector<std::string> symbols_;
+  absl::flat_hash_map<std::string, uint64_t> symbol_indices_;
+  std::vector<std::vector<uint64_t>> values_;
+  absl::flat_hash_map<std::vector<uint64_t>, EncodedValue> value_indices_;
+  std::vector<RelationTuples> relations_;
+  absl::flat_hash_map<std::string, size_t> relation_indices_;
+};
+
+// The kinds of the values of a binary facts file.
+enum class BinaryValueKind {
+  kNumber,
+  kFloat,
+  kSymbol,
+  kNil,
+  kRecord,
+  kAdtBranch,
+};
+
+// Decodes facts in the format written by `BinaryFactsWriter`. Each value of
+// the value table is handed to `encoder` once, and `add_fact` is called with
+// the name of the relation, the encoded columns and the kinds of the columns
+// of every fact.
+absl::Status DecodeBinaryFacts(
+    absl::string_view binary_facts, ir::datalog::ValueEncoder &encoder,
+    absl::FunctionRef<void(
+        absl::string_view relation_name,
+        absl::Span<const ir::datalog::ValueEncoder::EncodedValue> columns,
+        absl::Span<const BinaryValueKind> column_kinds)>
+        add_fact);
+
+// Returns the contents of the binary facts file at `path`.
+absl::StatusOr<std::string> ReadBinaryFactsFile(
+    const std::filesystem::path &path);
+
+}  // namespace raksha::backends::policy_engine::souffle
+
+#endif  // SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_BINARY_FACTS_H_
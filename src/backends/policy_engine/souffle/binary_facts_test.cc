@@ -0,0 +1,254 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/binary_facts.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/types/span.h"
+#include "src/common/testing/gtest.h"
+#include "src/common/utils/filesystem.h"
+#include "src/ir/datalog/attribute.h"
+#include "src/ir/datalog/operation.h"
+#include "src/ir/datalog/value.h"
+
+namespace raksha::backends::policy_engine::souffle {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+using ir::datalog::Attribute;
+using ir::datalog::AttributeList;
+using ir::datalog::IsOperationFact;
+using ir::datalog::Number;
+using ir::datalog::OperandList;
+using ir::datalog::Operation;
+using ir::datalog::OperationHasAttributeValueFact;
+using ir::datalog::OperationHasOperandAtIndexFact;
+using ir::datalog::ResultList;
+using ir::datalog::Symbol;
+
+using EncodedValue = ir::datalog::ValueEncoder::EncodedValue;
+
+// A `ValueEncoder` that renders every value into its Datalog string.
+class DatalogStringEncoder : public ir::datalog::ValueEncoder {
+ public:
+  EncodedValue EncodeNumber(int64_t number) override {
+    return AddString(std::to_string(number));
+  }
+  EncodedValue EncodeFloat(double number) override {
+    return AddString(absl::StrFormat("%lg", number));
+  }
+  EncodedValue EncodeSymbol(absl::string_view symbol) override {
+    return AddString(absl::StrFormat(R"("%s")", symbol));
+  }
+  EncodedValue EncodeNil() override { return AddString("nil"); }
+  EncodedValue EncodeRecord(absl::Span<const EncodedValue> fields) override {
+    return AddString(absl::StrFormat("[%s]", JoinStrings(fields)));
+  }
+  EncodedValue EncodeAdtBranch(
+      absl::string_view branch_name,
+      absl::Span<const EncodedValue> arguments) override {
+    return AddString(
+        absl::StrFormat("$%s(%s)", branch_name, JoinStrings(arguments)));
+  }
+
+  std::string JoinStrings(absl::Span<const EncodedValue> values) const {
+    return absl::StrJoin(values, ", ",
+                         [this](std::string *out, EncodedValue value) {
+                           absl::StrAppend(out, strings_.at(value));
+                         });
+  }
+
+ private:
+  EncodedValue AddString(std::string str) {
+    strings_.push_back(std::move(str));
+    return strings_.size() - 1;
+  }
+
+  std::vector<std::string> strings_;
+};
+
+// Decodes `binary_facts` and returns each fact in Datalog syntax.
+absl::StatusOr<std::vector<std::string>> DecodeToDatalogStrings(
+    absl::string_view binary_facts) {
+  DatalogStringEncoder encoder;
+  std::vector<std::string> facts;
+  absl::Status status = DecodeBinaryFacts(
+      binary_facts, encoder,
+      [&](absl::string_view relation_name,
+          absl::Span<const DatalogStringEncoder::EncodedValue> columns,
+          absl::Span<const BinaryValueKind>) {
+        facts.push_back(absl::StrFormat("%s(%s).", relation_name,
+                                        encoder.JoinStrings(columns)));
+      });
+  if (!status.ok()) return status;
+  return facts;
+}
+
+std::vector<IsOperationFact> MakeIsOperationFacts() {
+  std::vector<IsOperationFact> facts;
+  facts.push_back(IsOperationFact(Operation(
+      Symbol("sql"), Symbol("sql.Literal"),
+      ResultList(Symbol("%0"), ResultList()), OperandList(),
+      AttributeList(Attribute("literal_value", Attribute::String("number_5")),
+                    AttributeList()))));
+  facts.push_back(IsOperationFact(Operation(
+      Symbol("sql"), Symbol("sql.MergeOp"),
+      ResultList(Symbol("%1"), ResultList()),
+      OperandList(Symbol("%0"), OperandList(Symbol("%0"), OperandList())),
+      AttributeList(Attribute("count", Attribute::Number(2)),
+                    AttributeList(Attribute("ratio", Attribute::Float(0.5)),
+                                  AttributeList())))));
+  return facts;
+}
+
+TEST(BinaryFactsTest, DecodedFactsMatchTheWrittenFacts) {
+  std::vector<IsOperationFact> is_operation_facts = MakeIsOperationFacts();
+  std::vector<OperationHasOperandAtIndexFact> operand_facts;
+  operand_facts.push_back(
+      OperationHasOperandAtIndexFact(Symbol("op0"), Symbol("%0"), Number(-1)));
+  BinaryFactsWriter writer;
+  writer.AddFacts(absl::MakeConstSpan(is_operation_facts));
+  writer.AddFacts(absl::MakeConstSpan(operand_facts));
+
+  absl::StatusOr<std::vector<std::string>> decoded_facts =
+      DecodeToDatalogStrings(writer.Serialize());
+  ASSERT_TRUE(decoded_facts.ok()) << decoded_facts.status();
+  EXPECT_THAT(*decoded_facts,
+              ElementsAre(is_operation_facts[0].ToDatalogString(),
+                          is_operation_facts[1].ToDatalogString(),
+                          operand_facts[0].ToDatalogString()));
+}
+
+TEST(BinaryFactsTest, FloatsKeepTheirBits) {
+  class FloatCollector : public DatalogStringEncoder {
+   public:
+    EncodedValue EncodeFloat(double number) override {
+      floats.push_back(number);
+      return DatalogStringEncoder::EncodeFloat(number);
+    }
+    std::vector<double> floats;
+  };
+  const double kFloats[] = {0.1, -1e300, 5e-324};
+  BinaryFactsWriter writer;
+  for (double number : kFloats) {
+    writer.AddFact("floats", {writer.EncodeFloat(number)});
+  }
+  FloatCollector encoder;
+  ASSERT_TRUE(DecodeBinaryFacts(writer.Serialize(), encoder,
+                                [](absl::string_view, auto, auto) {})
+                  .ok());
+  EXPECT_THAT(encoder.floats, ElementsAreArray(kFloats));
+}
+
+TEST(BinaryFactsTest, ReportsTheKindsOfTheColumns) {
+  BinaryFactsWriter writer;
+  EncodedValue number = writer.EncodeNumber(1);
+  writer.AddFact("kinds", {number, writer.EncodeFloat(0.5),
+                           writer.EncodeSymbol("a"), writer.EncodeNil(),
+                           writer.EncodeRecord({number}),
+                           writer.EncodeAdtBranch("Branch", {number})});
+  DatalogStringEncoder encoder;
+  std::vector<BinaryValueKind> kinds;
+  ASSERT_TRUE(DecodeBinaryFacts(writer.Serialize(), encoder,
+                                [&](absl::string_view, auto,
+                                    absl::Span<const BinaryValueKind>
+                                        column_kinds) {
+                                  kinds.assign(column_kinds.begin(),
+                                               column_kinds.end());
+                                })
+                  .ok());
+  EXPECT_THAT(kinds, ElementsAre(BinaryValueKind::kNumber,
+                                 BinaryValueKind::kFloat,
+                                 BinaryValueKind::kSymbol,
+                                 BinaryValueKind::kNil,
+                                 BinaryValueKind::kRecord,
+                                 BinaryValueKind::kAdtBranch));
+}
+
+TEST(BinaryFactsTest, EqualValuesAreStoredOnce) {
+  std::vector<OperationHasAttributeValueFact> facts;
+  facts.push_back(OperationHasAttributeValueFact(
+      Symbol("op0"), Symbol("literal_value"),
+      Attribute::String("a long string that is only stored once")));
+  BinaryFactsWriter once;
+  once.AddFacts(absl::MakeConstSpan(facts));
+  BinaryFactsWriter twice;
+  twice.AddFacts(absl::MakeConstSpan(facts));
+  twice.AddFacts(absl::MakeConstSpan(facts));
+  // The second fact only adds a row of three value indices.
+  EXPECT_EQ(twice.Serialize().size(), once.Serialize().size() + 3 * 8);
+}
+
+TEST(BinaryFactsTest, RejectsTruncatedAndTrailingData) {
+  std::vector<IsOperationFact> is_operation_facts = MakeIsOperationFacts();
+  BinaryFactsWriter writer;
+  writer.AddFacts(absl::MakeConstSpan(is_operation_facts));
+  std::string binary_facts = writer.Serialize();
+  for (size_t size = 0; size < binary_facts.size(); ++size) {
+    EXPECT_FALSE(DecodeToDatalogStrings(binary_facts.substr(0, size)).ok())
+        << "Accepted a prefix of size " << size;
+  }
+  EXPECT_FALSE(DecodeToDatalogStrings(binary_facts + "x").ok());
+  EXPECT_FALSE(DecodeToDatalogStrings("not binary facts at all").ok());
+}
+
+TEST(BinaryFactsTest, KeepsNullaryFacts) {
+  BinaryFactsWriter writer;
+  writer.AddFact("flag", {});
+  writer.AddFact("flag", {});
+  absl::StatusOr<std::vector<std::string>> decoded_facts =
+      DecodeToDatalogStrings(writer.Serialize());
+  ASSERT_TRUE(decoded_facts.ok()) << decoded_facts.status();
+  EXPECT_THAT(*decoded_facts, ElementsAre("flag()."));
+}
+
+TEST(BinaryFactsTest, RejectsRepeatedNullaryTuples) {
+  BinaryFactsWriter writer;
+  writer.AddFact("flag", {});
+  std::string binary_facts = writer.Serialize();
+  // The tuple count is the last word, as the tuple has no columns.
+  ASSERT_EQ(binary_facts.substr(binary_facts.size() - 8),
+            std::string("\x01\0\0\0\0\0\0\0", 8));
+  binary_facts.replace(binary_facts.size() - 8, 8, std::string(8, '\xff'));
+  EXPECT_FALSE(DecodeToDatalogStrings(binary_facts).ok());
+}
+
+TEST(BinaryFactsTest, RoundTripsThroughAFile) {
+  std::vector<IsOperationFact> is_operation_facts = MakeIsOperationFacts();
+  BinaryFactsWriter writer;
+  writer.AddFacts(absl::MakeConstSpan(is_operation_facts));
+  absl::StatusOr<std::filesystem::path> directory =
+      common::utils::CreateTemporaryDirectory();
+  ASSERT_TRUE(directory.ok());
+  std::filesystem::path path = *directory / "facts.bin";
+
+  ASSERT_TRUE(writer.WriteToFile(path).ok());
+  absl::StatusOr<std::string> binary_facts = ReadBinaryFactsFile(path);
+  ASSERT_TRUE(binary_facts.ok()) << binary_facts.status();
+  EXPECT_EQ(*binary_facts, writer.Serialize());
+  EXPECT_FALSE(ReadBinaryFactsFile(*directory / "missing.bin").ok());
+  std::filesystem::remove_all(*directory);
+}
+
+}  // namespace
+}  // namespace raksha::backends::policy_engine::souffle
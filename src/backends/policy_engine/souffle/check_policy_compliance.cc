@@ -14,22 +14,35 @@
 // limitations under the License.
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <sstream>
+#include <string>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/flags/usage.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
 #include "src/backends/policy_engine/auth_logic_policy.h"
 #include "src/backends/policy_engine/catchall_policy_rule_policy.h"
 #include "src/backends/policy_engine/dp_parameter_policy.h"
 #include "src/backends/policy_engine/policy.h"
+#include "src/backends/policy_engine/souffle/binary_facts.h"
+#include "src/backends/policy_engine/souffle/compiled_policy.h"
 #include "src/backends/policy_engine/souffle/souffle_policy_checker.h"
+#include "src/common/utils/filesystem.h"
 #include "src/ir/proto_to_ir.h"
 #include "src/parser/ir/ir_parser.h"
 
@@ -41,8 +54,30 @@ ABSL_FLAG(std::optional<uint64_t>, epsilon_dp_parameter, std::nullopt,
 ABSL_FLAG(std::optional<uint64_t>, delta_dp_parameter, std::nullopt,
           "global delta value");
 ABSL_FLAG(std::optional<std::string>, proto, std::nullopt, "the proto file");
+ABSL_FLAG(std::optional<std::string>, binary_facts_file, std::nullopt,
+          "a binary facts file of the module to check, as written by "
+          "`ir_to_operation_facts --binary`");
+ABSL_FLAG(uint64_t, proto_threads, 1,
+          "number of threads that convert each proto into IR");
+ABSL_FLAG(std::string, proto_format, "json",
+          "the format of protos, either `json` or `binary` for the protobuf "
+          "wire format");
 ABSL_FLAG(std::optional<std::string>, policy_engine, std::nullopt,
           "name of the policy engine");
+ABSL_FLAG(uint64_t, souffle_threads, 1,
+          "number of threads used by the Souffle policy check; only has an "
+          "effect when built with --config=souffle_parallel");
+ABSL_FLAG(bool, binary_facts, false,
+          "hand the facts to Souffle in the binary facts format rather than "
+          "through text .facts files");
+ABSL_FLAG(bool, serve, false,
+          "keep running and answer the check requests read from stdin until "
+          "it is closed; the policy flags give the policy of requests that "
+          "do not name one");
+ABSL_FLAG(uint64_t, max_inline_module_bytes, uint64_t{1} << 30,
+          "with --serve, the largest module that a request may send inline; "
+          "larger modules are skipped and the request is answered with an "
+          "error");
 
 constexpr char kUsageMessage[] =
     "This tool takes an IR representation of a system, policy engine and "
@@ -50,7 +85,17 @@ constexpr char kUsageMessage[] =
 
 namespace {
 
-using raksha::parser::ir::ParseProgram;
+using raksha::backends::policy_engine::AuthLogicPolicy;
+using raksha::backends::policy_engine::CatchallPolicyRulePolicy;
+using raksha::backends::policy_engine::CompiledPolicy;
+using raksha::backends::policy_engine::DpParameterPolicy;
+using raksha::backends::policy_engine::Policy;
+using raksha::backends::policy_engine::SoufflePolicyChecker;
+using raksha::backends::policy_engine::souffle::ReadBinaryFactsFile;
+using raksha::parser::ir::IrProgramParserResult;
+using raksha::parser::ir::ParseMode;
+using raksha::parser::ir::ParseProgramFile;
+using raksha::parser::ir::TryParseProgram;
 
 absl::StatusOr<std::string> ReadFileContents(std::filesystem::path file_path) {
   if (!std::filesystem::exists(file_path)) {
@@ -80,47 +125,280 @@ struct IrGraphComponents {
   std::unique_ptr<raksha::ir::IRContext> ir_context;
 };
 
-absl::StatusOr<IrGraphComponents> GetIrGraphComponentsFromIrPath(
-    absl::string_view ir_path) {
-  absl::StatusOr<std::string> ir_string = ReadFileContents(ir_path);
-  if (ir_string.ok()) {
-    auto [context, module, ssa_names] = ParseProgram(*ir_string);
-    return IrGraphComponents{.ir_module = std::move(module),
-                             .ir_ssa_names = std::move(ssa_names),
-                             .ir_context = std::move(context)};
+absl::StatusOr<IrGraphComponents> GetIrGraphComponentsFromIrString(
+    absl::string_view ir_string) {
+  absl::StatusOr<IrProgramParserResult> ir_result =
+      TryParseProgram(ir_string, ParseMode::kBlockByBlock);
+  if (!ir_result.ok()) return ir_result.status();
+  return IrGraphComponents{.ir_module = std::move(ir_result->module),
+                           .ir_ssa_names = std::move(ir_result->ssa_names),
+                           .ir_context = std::move(ir_result->context)};
+}
+
+absl::StatusOr<IrGraphComponents> GetIrGraphComponentsFromProtoString(
+    absl::string_view proto_string) {
+  std::unique_ptr<raksha::ir::IRContext> context =
+      std::make_unique<raksha::ir::IRContext>(); /*...*/
+  absl::StatusOr<raksha::ir::ProtoToIR::Result> ir_result =
+      absl::GetFlag(FLAGS_proto_format) == "binary"
+          ? raksha::ir::ProtoToIR::ConvertBinary(
+                *context, proto_string, absl::GetFlag(FLAGS_proto_threads))
+          : raksha::ir::ProtoToIR::Convert(*context, proto_string,
+                                           absl::GetFlag(FLAGS_proto_threads));
+  if (ir_result.ok()) {
+    return IrGraphComponents{
+        .ir_module = std::move(ir_result.value().module),
+        .ir_ssa_names = std::move(ir_result.value().ssa_names),
+        .ir_context = std::move(context)};
   } else {
-    return ir_string.status();
+    return ir_result.status();
   }
 }
 
+absl::StatusOr<IrGraphComponents> GetIrGraphComponentsFromIrPath(
+    absl::string_view ir_path) {
+  absl::StatusOr<IrProgramParserResult> ir_result =
+      ParseProgramFile(std::string(ir_path));
+  if (!ir_result.ok()) return ir_result.status();
+  return IrGraphComponents{.ir_module = std::move(ir_result->module),
+                           .ir_ssa_names = std::move(ir_result->ssa_names),
+                           .ir_context = std::move(ir_result->context)};
+}
+
 absl::StatusOr<IrGraphComponents> GetIrGraphComponentsFromProtoPath(
     absl::string_view proto_path) {
-  absl::StatusOr<std::string> proto_string = ReadFileContents(proto_path);
-  if (proto_string.ok()) {
-    std::unique_ptr<raksha::ir::IRContext> context =
-        std::make_unique<raksha::ir::IRContext>(); /*...*/
-    absl::StatusOr<raksha::ir::ProtoToIR::Result> ir_result =
-        raksha::ir::ProtoToIR::Convert(*context, *proto_string);
-    if (ir_result.ok()) {
-      return IrGraphComponents{
-          .ir_module = std::move(ir_result.value().module),
-          .ir_ssa_names = std::move(ir_result.value().ssa_names),
-          .ir_context = std::move(context)};
-    } else {
-      return ir_result.status();
-    }
+  // Map the proto rather than reading it, as translation units can be large.
+  absl::StatusOr<raksha::common::utils::MappedFile> proto_file =
+      raksha::common::utils::MappedFile::Open(std::string(proto_path));
+  if (proto_file.ok()) {
+    return GetIrGraphComponentsFromProtoString(proto_file->contents());
   } else {
-    LOG(ERROR) << "Error reading proto file: " << proto_string.status();
-    return proto_string.status();
+    LOG(ERROR) << "Error reading proto file: " << proto_file.status();
+    return proto_file.status();
   }
 }
 
-}  // namespace
+// The policy to check a module against. The policy engine takes precedence
+// over the SQL policy rules, which take precedence over the DP parameters.
+struct PolicySelector {
+  std::optional<std::string> policy_engine;
+  std::optional<std::string> sql_policy_rules;
+  std::optional<uint64_t> epsilon_dp_parameter;
+  std::optional<uint64_t> delta_dp_parameter;
 
-using raksha::backends::policy_engine::AuthLogicPolicy;
-using raksha::backends::policy_engine::CatchallPolicyRulePolicy;
-using raksha::backends::policy_engine::DpParameterPolicy;
-using raksha::backends::policy_engine::SoufflePolicyChecker;
+  bool IsEmpty() const {
+    return !policy_engine && !sql_policy_rules && !epsilon_dp_parameter &&
+           !delta_dp_parameter;
+  }
+};
+
+PolicySelector GetPolicySelectorFromFlags() {
+  return PolicySelector{
+      .policy_engine = absl::GetFlag(FLAGS_policy_engine),
+      .sql_policy_rules = absl::GetFlag(FLAGS_sql_policy_rules),
+      .epsilon_dp_parameter = absl::GetFlag(FLAGS_epsilon_dp_parameter),
+      .delta_dp_parameter = absl::GetFlag(FLAGS_delta_dp_parameter)};
+}
+
+absl::StatusOr<std::unique_ptr<Policy>> MakePolicy(
+    const PolicySelector& selector) {
+  if (selector.policy_engine) {
+    return std::make_unique<AuthLogicPolicy>(*selector.policy_engine);
+  }
+  if (selector.sql_policy_rules) {
+    // Read the sql policy rules file.
+    absl::StatusOr<std::string> sql_policy_rules =
+        ReadFileContents(*selector.sql_policy_rules);
+    if (!sql_policy_rules.ok()) {
+      LOG(ERROR) << "Error reading sql policy rules file: "
+                 << sql_policy_rules.status();
+      return sql_policy_rules.status();
+    }
+    return std::make_unique<CatchallPolicyRulePolicy>(*sql_policy_rules);
+  }
+  if (selector.epsilon_dp_parameter && selector.delta_dp_parameter) {
+    return std::make_unique<DpParameterPolicy>(*selector.epsilon_dp_parameter,
+                                               *selector.delta_dp_parameter);
+  }
+  return absl::InvalidArgumentError(
+      "Required policy parameter not found. Please specify one of "
+      "--auth_logic, --sql_policy_rule, or both "
+      "--epsilon_dp_parameter and --delta_dp_parameter");
+}
+
+// Answers check requests read from a stream, keeping the policies it has seen
+// compiled so that later requests against them reuse the loaded programs.
+//
+// Each request is a line of space-separated `key=value` fields. The module to
+// check is given by one of
+//
+//   ir=<path>, proto=<path>  the IR or proto file to check, or
+//   ir_bytes=<n>, proto_bytes=<n>  the size of the IR or proto that follows
+//                                  the line of the request,
+//
+// and the policy by the fields `policy_engine`, `sql_policy_rules`,
+// `epsilon_dp_parameter` and `delta_dp_parameter`, which mean the same as the
+// flags of the same names. Protos are in the format given by
+// `--proto_format`. Requests without any policy field use the policy
+// given by the flags. Paths must not contain spaces. Empty lines are ignored.
+// Inline modules larger than `max_inline_module_bytes` are skipped rather
+// than read into memory.
+//
+// Every request is answered by one line: `pass`, `fail` or `error <message>`.
+class PolicyComplianceServer {
+ public:
+  PolicyComplianceServer(const SoufflePolicyChecker& checker,
+                         PolicySelector default_policy,
+                         uint64_t max_inline_module_bytes)
+      : checker_(checker),
+        default_policy_(std::move(default_policy)),
+        max_inline_module_bytes_(max_inline_module_bytes) {}
+
+  // Answers the requests from `in` on `out` until `in` ends. Returns false if
+  // a request ended early.
+  bool Serve(std::istream& in, std::ostream& out) {
+    std::string request;
+    while (std::getline(in, request)) {
+      if (request.empty()) continue;
+      absl::StatusOr<bool> result = HandleRequest(request, in);
+      if (result.ok()) {
+        out << (*result ? "pass" : "fail") << "\n";
+      } else {
+        out << "error " << result.status().message() << "\n";
+      }
+      out.flush();
+      // Without the whole module, the stream no longer starts at a request.
+      if (!in) return false;
+    }
+    return true;
+  }
+
+ private:
+  // Checks the module of `request`, reading it from `in` if it is inline.
+  absl::StatusOr<bool> HandleRequest(absl::string_view request,
+                                     std::istream& in) {
+    absl::flat_hash_map<std::string, std::string> fields;
+    for (absl::string_view field :
+         absl::StrSplit(request, ' ', absl::SkipEmpty())) {
+      std::pair<std::string, std::string> key_value =
+          absl::StrSplit(field, absl::MaxSplits('=', 1));
+      fields[key_value.first] = std::move(key_value.second);
+    }
+    // Read any inline module first, so that the next request is found even
+    // if this one is rejected.
+    std::string inline_module;
+    std::optional<raksha::common::utils::MappedFile> module_file;
+    absl::string_view module_contents;
+    std::optional<bool> is_proto;
+    for (const auto& [key, proto] : {std::pair{"ir_bytes", false},
+                                     std::pair{"proto_bytes", true}}) {
+      auto it = fields.find(key);
+      if (it == fields.end()) continue;
+      uint64_t size = 0;
+      if (is_proto || !absl::SimpleAtoi(it->second, &size)) {
+        return absl::InvalidArgumentError(
+            "Expected a single module size in the request.");
+      }
+      if (size > max_inline_module_bytes_) {
+        // Skip the module so that the next request is found.
+        in.ignore(static_cast<std::streamsize>(std::min<uint64_t>(
+            size, std::numeric_limits<std::streamsize>::max())));
+        return absl::InvalidArgumentError(absl::StrCat(
+            "The module of ", size, " bytes exceeds the limit of ",
+            max_inline_module_bytes_, " bytes."));
+      }
+      inline_module.resize(size);
+      if (!in.read(inline_module.data(), size)) {
+        return absl::InvalidArgumentError("The module ended early.");
+      }
+      module_contents = inline_module;
+      is_proto = proto;
+    }
+    for (const auto& [key, proto] :
+         {std::pair{"ir", false}, std::pair{"proto", true}}) {
+      auto it = fields.find(key);
+      if (it == fields.end()) continue;
+      if (is_proto) {
+        return absl::InvalidArgumentError(
+            "Expected a single module in the request.");
+      }
+      absl::StatusOr<raksha::common::utils::MappedFile> mapped_file =
+          raksha::common::utils::MappedFile::Open(it->second);
+      if (!mapped_file.ok()) return mapped_file.status();
+      module_file = *std::move(mapped_file);
+      module_contents = module_file->contents();
+      is_proto = proto;
+    }
+    if (!is_proto) {
+      return absl::InvalidArgumentError(
+          "One of ir, proto, ir_bytes or proto_bytes must be specified.");
+    }
+
+    PolicySelector selector;
+    for (const auto& [key, value] : fields) {
+      if (key == "policy_engine") {
+        selector.policy_engine = value;
+      } else if (key == "sql_policy_rules") {
+        selector.sql_policy_rules = value;
+      } else if (key == "epsilon_dp_parameter" ||
+                 key == "delta_dp_parameter") {
+        uint64_t parameter = 0;
+        if (!absl::SimpleAtoi(value, &parameter)) {
+          return absl::InvalidArgumentError(
+              absl::StrCat("Invalid ", key, ": ", value));
+        }
+        (key == "epsilon_dp_parameter" ? selector.epsilon_dp_parameter
+                                       : selector.delta_dp_parameter) =
+            parameter;
+      } else if (key != "ir" && key != "proto" && key != "ir_bytes" &&
+                 key != "proto_bytes") {
+        return absl::InvalidArgumentError(
+            absl::StrCat("Unknown request field: ", key));
+      }
+    }
+    absl::StatusOr<const Policy*> policy =
+        GetPolicy(selector.IsEmpty() ? default_policy_ : selector);
+    if (!policy.ok()) return policy.status();
+
+    absl::StatusOr<IrGraphComponents> components =
+        *is_proto ? GetIrGraphComponentsFromProtoString(module_contents)
+                  : GetIrGraphComponentsFromIrString(module_contents);
+    if (!components.ok()) return components.status();
+    return checker_.IsModulePolicyCompliant(*components->ir_module, **policy);
+  }
+
+  // Returns the compiled policy picked by `selector`, compiling it on first
+  // use. Policy rules files are only read once, so changes to them are not
+  // seen until the server is restarted.
+  absl::StatusOr<const Policy*> GetPolicy(const PolicySelector& selector) {
+    std::string key =
+        absl::StrCat(selector.policy_engine.value_or(""), "\n",
+                     selector.sql_policy_rules.value_or(""), "\n",
+                     selector.epsilon_dp_parameter.value_or(0), "\n",
+                     selector.delta_dp_parameter.value_or(0));
+    if (selector.policy_engine || selector.sql_policy_rules) {
+      // The DP parameters do not matter, so do not compile the policy again.
+      key = absl::StrCat(selector.policy_engine.value_or(""), "\n",
+                         selector.sql_policy_rules.value_or(""));
+    }
+    auto it = policies_.find(key);
+    if (it != policies_.end()) return it->second.get();
+
+    absl::StatusOr<std::unique_ptr<Policy>> policy = MakePolicy(selector);
+    if (!policy.ok()) return policy.status();
+    absl::StatusOr<std::unique_ptr<CompiledPolicy>> compiled_policy =
+        CompiledPolicy::Compile(**policy);
+    if (!compiled_policy.ok()) return compiled_policy.status();
+    return (policies_[key] = *std::move(compiled_policy)).get();
+  }
+
+  const SoufflePolicyChecker& checker_;
+  PolicySelector default_policy_;
+  uint64_t max_inline_module_bytes_;
+  absl::flat_hash_map<std::string, std::unique_ptr<CompiledPolicy>> policies_;
+};
+
+}  // namespace
 
 int main(int argc, char* argv[]) {
   absl::SetProgramUsageMessage(kUsageMessage);
@@ -128,17 +406,80 @@ int main(int argc, char* argv[]) {
 
   const std::optional<std::string> ir_path = absl::GetFlag(FLAGS_ir);
   const std::optional<std::string> proto_path = absl::GetFlag(FLAGS_proto);
+  const std::optional<std::string> binary_facts_path =
+      absl::GetFlag(FLAGS_binary_facts_file);
+  const bool serve = absl::GetFlag(FLAGS_serve);
+  const int num_modules = ir_path.has_value() + proto_path.has_value() +
+                          binary_facts_path.has_value();
 
-  if (ir_path.has_value() == proto_path.has_value()) {
-    if (ir_path.has_value()) {
-      LOG(ERROR) << "Both --ir and --proto cannot be used simultaneously.";
+  if (serve) {
+    if (num_modules > 0) {
+      LOG(ERROR) << "--ir, --proto and --binary_facts_file cannot be used "
+                    "with --serve.";
+      return UnwrapExitCode(ReturnCode::ERROR);
+    }
+  } else if (num_modules != 1) {
+    if (num_modules > 1) {
+      LOG(ERROR) << "Only one of --ir, --proto and --binary_facts_file can be "
+                    "used at a time.";
     } else {
-      LOG(ERROR) << "One of --ir or --proto must be specified.";
+      LOG(ERROR) << "One of --ir, --proto or --binary_facts_file must be "
+                    "specified.";
     }
 
     return UnwrapExitCode(ReturnCode::ERROR);
   }
 
+  const std::string proto_format = absl::GetFlag(FLAGS_proto_format);
+  if (proto_format != "json" && proto_format != "binary") {
+    LOG(ERROR) << "--proto_format must be `json` or `binary`.";
+    return UnwrapExitCode(ReturnCode::ERROR);
+  }
+
+  const uint64_t souffle_threads = absl::GetFlag(FLAGS_souffle_threads);
+  if (souffle_threads == 0) {
+    LOG(ERROR) << "--souffle_threads must be at least 1.";
+    return UnwrapExitCode(ReturnCode::ERROR);
+  }
+  const SoufflePolicyChecker checker(
+      absl::GetFlag(FLAGS_binary_facts)
+          ? SoufflePolicyChecker::FactLoadingMode::kBinaryFacts
+          : SoufflePolicyChecker::FactLoadingMode::kFactsDirectory,
+      SoufflePolicyChecker::kDefaultMaxBatchSize, souffle_threads);
+
+  if (serve) {
+    PolicyComplianceServer server(checker, GetPolicySelectorFromFlags(),
+                                  absl::GetFlag(FLAGS_max_inline_module_bytes));
+    return UnwrapExitCode(server.Serve(std::cin, std::cout)
+                              ? ReturnCode::PASS
+                              : ReturnCode::ERROR);
+  }
+
+  if (binary_facts_path.has_value()) {
+    absl::StatusOr<std::string> binary_facts =
+        ReadBinaryFactsFile(*binary_facts_path);
+    if (!binary_facts.ok()) {
+      LOG(ERROR) << "Error reading binary facts file: "
+                 << binary_facts.status();
+      return UnwrapExitCode(ReturnCode::ERROR);
+    }
+    absl::StatusOr<std::unique_ptr<Policy>> policy =
+        MakePolicy(GetPolicySelectorFromFlags());
+    if (!policy.ok()) {
+      LOG(ERROR) << policy.status().message();
+      return UnwrapExitCode(ReturnCode::ERROR);
+    }
+    absl::StatusOr<bool> is_compliant =
+        checker.AreBinaryFactsPolicyCompliant(*binary_facts, **policy);
+    if (!is_compliant.ok()) {
+      LOG(ERROR) << "Error loading binary facts: " << is_compliant.status();
+      return UnwrapExitCode(ReturnCode::ERROR);
+    }
+    LOG(ERROR) << (*is_compliant ? "Policy check succeeded!"
+                                 : "Policy check failed!");
+    return UnwrapExitCode(*is_compliant ? ReturnCode::PASS : ReturnCode::FAIL);
+  }
+
   // Parse either an IR file or a Proto file
   const absl::StatusOr<IrGraphComponents> components =
       ir_path.has_value() ? GetIrGraphComponentsFromIrPath(*ir_path)
@@ -148,40 +489,16 @@ int main(int argc, char* argv[]) {
     return UnwrapExitCode(ReturnCode::ERROR);
   }
 
-  bool policyCheckSucceeded = false;
+  absl::StatusOr<std::unique_ptr<Policy>> policy =
+      MakePolicy(GetPolicySelectorFromFlags());
+  if (!policy.ok()) {
+    LOG(ERROR) << policy.status().message();
+    return UnwrapExitCode(ReturnCode::ERROR);
+  }
 
   // Invoke policy checker and return result.
-  if (absl::GetFlag(FLAGS_policy_engine).has_value()) {
-    AuthLogicPolicy policy(absl::GetFlag(FLAGS_policy_engine).value());
-    policyCheckSucceeded = SoufflePolicyChecker().IsModulePolicyCompliant(
-        *components.value().ir_module, policy);
-  } else if (absl::GetFlag(FLAGS_sql_policy_rules).has_value()) {
-    // Read the sql policy rules file.
-    absl::StatusOr<std::string> sql_policy_rules =
-        ReadFileContents(absl::GetFlag(FLAGS_sql_policy_rules).value());
-    if (absl::GetFlag(FLAGS_sql_policy_rules).has_value() &&
-        !sql_policy_rules.ok()) {
-      LOG(ERROR) << "Error reading sql policy rules file: "
-                 << sql_policy_rules.status();
-      return UnwrapExitCode(ReturnCode::ERROR);
-    }
-    CatchallPolicyRulePolicy policy(*sql_policy_rules);
-    policyCheckSucceeded = SoufflePolicyChecker().IsModulePolicyCompliant(
-        *components.value().ir_module, policy);
-  } else if (absl::GetFlag(FLAGS_epsilon_dp_parameter).has_value() &&
-             (absl::GetFlag(FLAGS_delta_dp_parameter).has_value())) {
-    uint64_t global_epsilon = absl::GetFlag(FLAGS_epsilon_dp_parameter).value();
-    uint64_t global_delta = absl::GetFlag(FLAGS_delta_dp_parameter).value();
-    DpParameterPolicy policy(global_epsilon, global_delta);
-    policyCheckSucceeded = SoufflePolicyChecker().IsModulePolicyCompliant(
-        *components.value().ir_module, policy);
-  } else {
-    LOG(ERROR) << "Required policy parameter not found. Please specify one of "
-                  "--auth_logic, --sql_policy_rule, or both "
-                  "--epsilon_dp_parameter and --delta_dp_parameter";
-    return 2;
-  }
-  if (policyCheckSucceeded) {
+  if (checker.IsModulePolicyCompliant(*components.value().ir_module,
+                                      **policy)) {
     LOG(ERROR) << "Policy check succeeded!";
     return UnwrapExitCode(ReturnCode::PASS);
   } else {
@@ -0,0 +1,89 @@
+#!/bin/bash
+#
+# Copyright 2022 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+#-------------------------------------------------------------------------------
+
+# Checks that `check_policy_compliance --serve` answers a sequence of requests
+# in order, including requests with inline modules and malformed requests, and
+# that it keeps answering after a request it rejects.
+
+CMD_ARG=$1
+SQL_POLICY_RULES_FILE_ARG=$2
+PASSING_IR_ARG=$3
+FAILING_IR_ARG=$4
+
+ROOT_DIR=${TEST_SRCDIR}/${TEST_WORKSPACE}
+CMD=${ROOT_DIR}/${CMD_ARG}
+SQL_POLICY_RULES_FILE=${ROOT_DIR}/${SQL_POLICY_RULES_FILE_ARG}
+PASSING_IR=${ROOT_DIR}/${PASSING_IR_ARG}
+FAILING_IR=${ROOT_DIR}/${FAILING_IR_ARG}
+
+FAILING_IR_BYTES=$(wc -c < "${FAILING_IR}")
+# Inline modules larger than this are skipped by the server.
+MAX_INLINE_MODULE_BYTES=1024
+OVERSIZED_MODULE_BYTES=2048
+UNPARSABLE_IR="module m0 { block b0 { %0 = core.plus [](%1) "
+UNDEFINED_VALUE_IR="module m0 { block b0 { %0 = core.plus [](%1) } }"
+
+ACTUAL=$(
+  {
+    echo "ir=${PASSING_IR}"
+    echo "ir=${FAILING_IR}"
+    echo "ir_bytes=${FAILING_IR_BYTES}"
+    cat "${FAILING_IR}"
+    echo "ir=${PASSING_IR} unknown_field=1"
+    echo "ir=${PASSING_IR}.missing"
+    echo
+    echo "ir=${PASSING_IR} sql_policy_rules=${SQL_POLICY_RULES_FILE}"
+    echo "ir_bytes=${#UNPARSABLE_IR}"
+    printf '%s' "${UNPARSABLE_IR}"
+    echo "ir_bytes=${#UNDEFINED_VALUE_IR}"
+    printf '%s' "${UNDEFINED_VALUE_IR}"
+    echo "ir=${PASSING_IR}"
+    echo "ir_bytes=${OVERSIZED_MODULE_BYTES}"
+    head -c "${OVERSIZED_MODULE_BYTES}" /dev/zero | tr '\0' ' '
+    echo "ir=${FAILING_IR}"
+    echo "ir=${PASSING_IR} proto=${PASSING_IR}"
+    echo "ir=${PASSING_IR} epsilon_dp_parameter=many"
+    echo "ir_bytes=-1"
+    echo "ir=${PASSING_IR}"
+  } | $CMD --serve --sql_policy_rules="${SQL_POLICY_RULES_FILE}" \
+      --max_inline_module_bytes="${MAX_INLINE_MODULE_BYTES}" |
+    cut -d ' ' -f 1
+)
+EXPECTED="pass
+fail
+fail
+error
+error
+pass
+error
+error
+pass
+error
+fail
+error
+error
+error
+pass"
+
+if [ "${ACTUAL}" != "${EXPECTED}" ]; then
+  echo "Server responses do not match expectations!"
+  echo "  Expected: ${EXPECTED}"
+  echo "  Actual: ${ACTUAL}"
+  exit 1
+fi
+exit 0
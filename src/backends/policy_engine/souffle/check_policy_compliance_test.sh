@@ -25,7 +25,7 @@ function printUsageAndExit() {
   echo "Usage: "
   echo "  For sql_policy_rules: "
   echo "    check_policy_compliance_test.sh \ "
-  echo "      <cmd> ${PASS_RESULT}|${FAIL_RESULT} \"sql_policy_analysis\" <ir|proto> <file> <sql_policy_rules_file> <policy_engine>"
+  echo "      <cmd> ${PASS_RESULT}|${FAIL_RESULT} \"sql_policy_analysis\" <ir|proto|binary_facts_file> <file> <sql_policy_rules_file> <policy_engine>"
   echo "  For differential privacy analysis: "
   echo "     <cmd> ${PASS_RESULT}|${FAIL_RESULT} \"dp_analysis\" <ir> <epsilon_parameter> <delta_parameter>"
   exit 1
@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/compiled_policy.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "souffle/SouffleInterface.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "src/backends/policy_engine/souffle/binary_facts.h"
+#include "src/backends/policy_engine/souffle/facts_string_encoder.h"
+#include "src/backends/policy_engine/souffle/souffle_value_encoder.h"
+#include "src/common/logging/logging.h"
+
+namespace raksha::backends::policy_engine {
+
+absl::StatusOr<std::unique_ptr<CompiledPolicy>> CompiledPolicy::Compile(
+    const Policy& policy) {
+  std::optional<std::string> checker_name =
+      policy.GetPolicyAnalysisCheckerName();
+  if (!checker_name) {
+    return absl::InvalidArgumentError(
+        "Only policies with a named checker can be compiled.");
+  }
+  std::unique_ptr<::souffle::SouffleProgram> program(
+      ::souffle::ProgramFactory::newInstance(*checker_name));
+  if (program == nullptr) {
+    return absl::NotFoundError(absl::StrFormat(
+        "No Souffle program is registered as `%s`.", *checker_name));
+  }
+
+  // Encode the facts of the policy once. Every new program of the pool loads
+  // them from this binary form, which needs no parsing.
+  std::optional<std::string> policy_fact_name = policy.GetPolicyFactName();
+  std::optional<std::string> policy_string = policy.GetPolicyString();
+  souffle::BinaryFactsWriter writer;
+  std::vector<std::string> policy_relation_names;
+  if (policy_fact_name) {
+    CHECK(policy_string) << "A policy with facts must have a policy string.";
+    const ::souffle::Relation* policy_relation =
+        program->getRelation(*policy_fact_name);
+    if (policy_relation == nullptr) {
+      return absl::NotFoundError(absl::StrFormat(
+          "The Souffle program `%s` has no relation `%s`.", *checker_name,
+          *policy_fact_name));
+    }
+    absl::StatusOr<std::vector<souffle::EncodedFact>> policy_facts =
+        souffle::EncodeFactsString(*policy_string,
+                                   souffle::GetAttributeTypes(*policy_relation),
+                                   writer);
+    if (!policy_facts.ok()) return policy_facts.status();
+    for (const souffle::EncodedFact& fact : *policy_facts) {
+      writer.AddFact(*policy_fact_name, fact);
+    }
+    policy_relation_names.push_back(*policy_fact_name);
+  }
+
+  std::string binary_policy_facts = writer.Serialize();
+  // Load the facts into the first program now, so that a policy that does not
+  // fit its program fails here rather than in the middle of a check. The
+  // program then becomes the first idle program of the pool.
+  if (absl::Status status = souffle::LoadBinaryFacts(
+          binary_policy_facts, policy_relation_names, *program);
+      !status.ok()) {
+    return status;
+  }
+
+  auto program_pool = std::make_unique<souffle::SouffleProgramPool>(
+      [checker_name = *checker_name, binary_policy_facts,
+       policy_relation_names]() {
+        std::unique_ptr<::souffle::SouffleProgram> program(
+            ABSL_DIE_IF_NULL(::souffle::ProgramFactory::newInstance(
+                checker_name)));
+        absl::Status status = souffle::LoadBinaryFacts(
+            binary_policy_facts, policy_relation_names, *program);
+        CHECK(status.ok()) << "Unexpected error while loading policy: "
+                           << status;
+        return program;
+      },
+      souffle::SouffleProgramPool::kDefaultMaxIdlePrograms,
+      souffle::SouffleProgramPool::kDefaultMaxUsesPerProgram,
+      absl::flat_hash_set<std::string>(policy_relation_names.begin(),
+                                       policy_relation_names.end()));
+  program_pool->AddIdleProgram(std::move(program));
+  return std::unique_ptr<CompiledPolicy>(new CompiledPolicy(
+      *std::move(checker_name), std::move(policy_fact_name),
+      std::move(policy_string), policy.IsModuleLocal(),
+      std::move(program_pool)));
+}
+
+}  // namespace raksha::backends::policy_engine
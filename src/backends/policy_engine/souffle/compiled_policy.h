@@ -0,0 +1,95 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#ifndef SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_COMPILED_POLICY_H_
+#define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_COMPILED_POLICY_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "souffle/SouffleInterface.h"
+#include "absl/status/statusor.h"
+#include "src/backends/policy_engine/policy.h"
+#include "src/backends/policy_engine/souffle/souffle_program_pool.h"
+
+namespace raksha::backends::policy_engine {
+
+// A policy that has been prepared once for checking many modules. Compiling a
+// policy encodes its facts once and keeps a pool of instances of its Souffle
+// program that already hold these facts (see `GetPreloadedProgramPool`).
+// Checks against a compiled policy only load, and purge, the facts of the
+// checked modules; the facts of the policy are never emitted, written or
+// parsed again.
+//
+// Only the parsing and loading of the policy facts is saved. Programs
+// generated by Souffle evaluate all of their strata on every run, so the
+// relations that only depend on the policy are derived again by each check.
+//
+// A compiled policy can be used from several threads at once.
+class CompiledPolicy : public Policy {
+ public:
+  // Compiles `policy`. The program of the policy has to be registered with
+  // Souffle under `GetPolicyAnalysisCheckerName`, and the facts of the policy
+  // have to be well-formed.
+  static absl::StatusOr<std::unique_ptr<CompiledPolicy>> Compile(
+      const Policy& policy);
+
+  std::unique_ptr<::souffle::SouffleProgram> GetPolicyAnalysisChecker()
+      const override {
+    return std::unique_ptr<::souffle::SouffleProgram>(
+        ::souffle::ProgramFactory::newInstance(checker_name_));
+  }
+
+  std::optional<std::string> GetPolicyAnalysisCheckerName() const override {
+    return checker_name_;
+  }
+
+  std::optional<std::string> GetPolicyFactName() const override {
+    return policy_fact_name_;
+  }
+
+  std::optional<std::string> GetPolicyString() const override {
+    return policy_string_;
+  }
+
+  bool IsModuleLocal() const override { return is_module_local_; }
+
+  souffle::SouffleProgramPool* GetPreloadedProgramPool() const override {
+    return program_pool_.get();
+  }
+
+ private:
+  CompiledPolicy(std::string checker_name,
+                 std::optional<std::string> policy_fact_name,
+                 std::optional<std::string> policy_string,
+                 bool is_module_local,
+                 std::unique_ptr<souffle::SouffleProgramPool> program_pool)
+      : checker_name_(std::move(checker_name)),
+        policy_fact_name_(std::move(policy_fact_name)),
+        policy_string_(std::move(policy_string)),
+        is_module_local_(is_module_local),
+        program_pool_(std::move(program_pool)) {}
+
+  std::string checker_name_;
+  std::optional<std::string> policy_fact_name_;
+  std::optional<std::string> policy_string_;
+  bool is_module_local_;
+  std::unique_ptr<souffle::SouffleProgramPool> program_pool_;
+};
+
+}  // namespace raksha::backends::policy_engine
+
+#endif  // SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_COMPILED_POLICY_H_
@@ -16,7 +16,7 @@
 
 #include "src/backends/policy_engine/souffle/datalog_lowering_visitor.h"
 
-#include "src/common/utils/fold.h"
+#include "absl/strings/str_cat.h"
 #include "src/ir/attributes/attribute.h"
 #include "src/ir/attributes/float_attribute.h"
 #include "src/ir/attributes/int_attribute.h"
@@ -39,6 +39,14 @@ using DatalogOperandList = ir::datalog::OperandList;
 using DatalogIsOperationFact = ir::datalog::IsOperationFact;
 using DatalogAttribute = ir::datalog::Attribute;
 using DatalogAttributePayload = ir::datalog::AttributePayload;
+using DatalogIsOperationIdFact = ir::datalog::IsOperationIdFact;
+using DatalogOperationHasActorFact = ir::datalog::OperationHasActorFact;
+using DatalogOperationHasOperatorFact = ir::datalog::OperationHasOperatorFact;
+using DatalogOperationHasResultFact = ir::datalog::OperationHasResultFact;
+using DatalogOperationHasOperandAtIndexFact =
+    ir::datalog::OperationHasOperandAtIndexFact;
+using DatalogOperationHasAttributeValueFact =
+    ir::datalog::OperationHasAttributeValueFact;
 
 static DatalogAttributePayload GetPayloadForAttribute(ir::Attribute attr,
                                                       ir::SsaNames &ssa_names) {
@@ -54,26 +62,52 @@ static DatalogAttributePayload GetPayloadForAttribute(ir::Attribute attr,
   return DatalogAttribute::String("");
 }
 
+void DatalogLoweringVisitor::AddFlatOperationFacts(
+    absl::string_view op_name, std::vector<std::string> results,
+    std::vector<std::string> operands,
+    std::vector<std::pair<std::string, ir::Attribute>> attributes) {
+  // Operations have no name of their own, so number them. The prefix keeps
+  // the ids of operations from different modules apart.
+  std::string operation_id =
+      absl::StrCat(value_name_prefix_, "op", operation_count_++);
+  FlatOperationFacts &facts = datalog_facts_.mutable_flat_operation_facts();
+  facts.is_operation_facts.push_back(
+      DatalogIsOperationIdFact(DatalogSymbol(operation_id)));
+  facts.actor_facts.push_back(DatalogOperationHasActorFact(
+      DatalogSymbol(operation_id), DatalogSymbol(kDefaultPrincipal)));
+  facts.operator_facts.push_back(DatalogOperationHasOperatorFact(
+      DatalogSymbol(operation_id), DatalogSymbol(op_name)));
+  for (std::string &result : results) {
+    facts.result_facts.push_back(DatalogOperationHasResultFact(
+        DatalogSymbol(operation_id), DatalogSymbol(std::move(result))));
+  }
+  for (size_t index = 0; index < operands.size(); ++index) {
+    facts.operand_facts.push_back(DatalogOperationHasOperandAtIndexFact(
+        DatalogSymbol(operation_id), DatalogSymbol(std::move(operands[index])),
+        DatalogNumber(index)));
+  }
+  for (auto &[name, attribute] : attributes) {
+    facts.attribute_facts.push_back(DatalogOperationHasAttributeValueFact(
+        DatalogSymbol(operation_id), DatalogSymbol(name),
+        GetPayloadForAttribute(std::move(attribute), ssa_names_)));
+  }
+}
+
 Unit DatalogLoweringVisitor::PreVisit(const ir::Operation &operation) {
   const ir::Operator &op = operation.op();
   absl::string_view op_name = op.name();
 
-  // Introduce a local to make capturing this field in lambdas easier.
-  ir::SsaNames &ssa_names = ssa_names_;
-
-  // Convert each operand into an `AccessPath` `Symbol` and put it in a
-  // `DatalogOperandList` to send to Souffle.
-  const ir::ValueList &ir_operand_list = operation.inputs();
-  DatalogOperandList operand_list = common::utils::rfold(
-      ir_operand_list, DatalogOperandList(),
-      [&ssa_names](DatalogOperandList list_so_far, const ir::Value &value) {
-        return DatalogOperandList(
-            DatalogSymbol(ValueToString(value, ssa_names)),
-            std::move(list_so_far));
-      });
+  // Convert each operand into an `AccessPath` name.
+  std::vector<std::string> operands;
+  operands.reserve(operation.inputs().size());
+  for (const ir::Value &value : operation.inputs()) {
+    // `Any` is a well-known name shared by all modules.
+    absl::string_view prefix =
+        value.If<ir::value::Any>() ? "" : value_name_prefix_;
+    operands.push_back(
+        absl::StrCat(prefix, ValueToString(value, ssa_names_)));
+  }
 
-  // Convert each `Attribute` to the analogous record in datalog and put into an
-  // `AttributeList`.
   const ir::NamedAttributeMap &ir_attr_map = operation.attributes();
 
   // Convert to std::vector for sorting (this avoids exposing flat_hash_map
@@ -82,29 +116,46 @@ Unit DatalogLoweringVisitor::PreVisit(const ir::Operation &operation) {
       ir_attr_map.begin(), ir_attr_map.end());
   std::sort(attribute_vec.begin(), attribute_vec.end(),
             [](auto &left, auto &right) { return left.first > right.first; });
-  DatalogAttributeList attribute_list = common::utils::fold(
-      attribute_vec, DatalogAttributeList(),
-      [&ssa_names](DatalogAttributeList list_so_far,
-                   std::pair<std::string, ir::Attribute> name_attr_pair) {
-        return DatalogAttributeList(
-            DatalogAttribute(std::move(name_attr_pair.first),
-                             GetPayloadForAttribute(
-                                 std::move(name_attr_pair.second), ssa_names)),
-            std::move(list_so_far));
-      });
 
   uint64_t number_of_op_return_values = op.number_of_return_values();
   std::vector<std::string> op_return_values;
   for (uint64_t i = 0; i < number_of_op_return_values; ++i) {
-    op_return_values.push_back(ssa_names_.GetOrCreateID(
-        ir::Value::MakeOperationResultValue(operation, i)));
+    std::string result_name = ssa_names_.GetOrCreateID(
+        ir::Value::MakeOperationResultValue(operation, i));
+    op_return_values.push_back(absl::StrCat(value_name_prefix_, result_name));
+  }
+
+  if (datalog_facts_.operation_encoding() == OperationEncoding::kFlat) {
+    AddFlatOperationFacts(op_name, std::move(op_return_values),
+                          std::move(operands), std::move(attribute_vec));
+    return Unit();
+  }
+
+  // Put the operands in a `DatalogOperandList` to send to Souffle.
+  std::vector<DatalogSymbol> operand_symbols;
+  operand_symbols.reserve(operands.size());
+  for (const std::string &operand : operands) {
+    operand_symbols.push_back(DatalogSymbol(operand));
+  }
+  DatalogOperandList operand_list(std::move(operand_symbols));
+
+  // Convert each `Attribute` to the analogous record in datalog and put into an
+  // `AttributeList`. The list holds the attributes in the reverse of the order
+  // they were sorted in.
+  std::vector<DatalogAttribute> attributes;
+  attributes.reserve(attribute_vec.size());
+  for (auto it = attribute_vec.rbegin(); it != attribute_vec.rend(); ++it) {
+    attributes.push_back(DatalogAttribute(
+        it->first, GetPayloadForAttribute(std::move(it->second), ssa_names_)));
+  }
+  DatalogAttributeList attribute_list(std::move(attributes));
+
+  std::vector<DatalogSymbol> result_symbols;
+  result_symbols.reserve(op_return_values.size());
+  for (const std::string &return_value : op_return_values) {
+    result_symbols.push_back(DatalogSymbol(return_value));
   }
-  DatalogResultList result_list = common::utils::rfold(
-      op_return_values, DatalogResultList(),
-      [](DatalogResultList list_so_far, const std::string &return_value) {
-        return DatalogResultList(DatalogSymbol(return_value),
-                                 std::move(list_so_far));
-      });
+  DatalogResultList result_list(std::move(result_symbols));
 
   DatalogOperation datalog_operation(
       DatalogSymbol(kDefaultPrincipal), DatalogSymbol(op_name),
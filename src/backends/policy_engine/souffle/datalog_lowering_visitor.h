@@ -17,6 +17,11 @@
 #ifndef SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_DATALOG_LOWERING_VISITOR_H_
 #define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_DATALOG_LOWERING_VISITOR_H_
 
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "src/backends/policy_engine/souffle/raksha_datalog_facts.h"
 #include "src/common/logging/logging.h"
 #include "src/common/utils/types.h"
@@ -32,19 +37,42 @@ namespace raksha::backends::policy_engine::souffle {
 class DatalogLoweringVisitor
     : public ir::IRTraversingVisitor<DatalogLoweringVisitor> {
  public:
-  explicit DatalogLoweringVisitor() = default;
-  explicit DatalogLoweringVisitor(ir::SsaNames ssa_names)
-      : ssa_names_(std::move(ssa_names)) {}
+  explicit DatalogLoweringVisitor(
+      OperationEncoding operation_encoding = OperationEncoding::kRecord)
+      : datalog_facts_(operation_encoding) {}
+  explicit DatalogLoweringVisitor(
+      ir::SsaNames ssa_names,
+      OperationEncoding operation_encoding = OperationEncoding::kRecord)
+      : ssa_names_(std::move(ssa_names)), datalog_facts_(operation_encoding) {}
   // We currently don't have any owner information when outputting IR. We don't
   // need it yet, really, but we do need to output something.
   static constexpr absl::string_view kDefaultPrincipal = "sql";
 
+  // Prefixes the names of all values lowered from now on, other than `Any`,
+  // with `prefix`. This allows lowering several modules into a single set of
+  // facts while keeping their values, including the storages they refer to,
+  // apart.
+  void SetValueNamePrefix(std::string prefix) {
+    value_name_prefix_ = std::move(prefix);
+  }
+
   Unit PreVisit(const ir::Operation &operation) override;
 
   const RakshaDatalogFacts &datalog_facts() { return datalog_facts_; }
 
  private:
+  // Adds the facts of the flat encoding for an operation with the given
+  // fields.
+  void AddFlatOperationFacts(
+      absl::string_view op_name, std::vector<std::string> results,
+      std::vector<std::string> operands,
+      std::vector<std::pair<std::string, ir::Attribute>> attributes);
+
   ir::SsaNames ssa_names_;
+  std::string value_name_prefix_;
+  // The number of operations lowered so far, used for the ids of operations
+  // in the flat encoding.
+  uint64_t operation_count_ = 0;
   RakshaDatalogFacts datalog_facts_;
 };
 
@@ -297,4 +297,70 @@ INSTANTIATE_TEST_SUITE_P(DatalogLoweringVisitModuleTest,
                          DatalogLoweringVisitModuleTest,
                          ValuesIn(kModuleAndExpectedRakshaDatalogFacts));
 
+TEST(DatalogLoweringVisitorTest, PrefixesValueNamesExceptAny) {
+  ir::Operation literal(nullptr, kLiteralOperator, ir::NamedAttributeMap({}),
+                        ir::ValueList());
+  ir::Operation merge(
+      nullptr, kMergeOpOperator, ir::NamedAttributeMap({}),
+      ir::ValueList({ir::Value::MakeDefaultOperationResultValue(literal),
+                     ir::Value(ir::value::Any())}));
+  DatalogLoweringVisitor visitor;
+  visitor.SetValueNamePrefix("m3/");
+  literal.Accept(visitor);
+  merge.Accept(visitor);
+
+  RakshaDatalogFacts expected_facts;
+  expected_facts.AddIsOperationFact(
+      ir::datalog::IsOperationFact(ir::datalog::Operation(
+          ir::datalog::Symbol("sql"), ir::datalog::Symbol("sql.ReadLiteral"),
+          ir::datalog::ResultList(ir::datalog::Symbol("m3/%0"),
+                                  ir::datalog::ResultList()),
+          ir::datalog::OperandList(), ir::datalog::AttributeList())));
+  expected_facts.AddIsOperationFact(
+      ir::datalog::IsOperationFact(ir::datalog::Operation(
+          ir::datalog::Symbol("sql"), ir::datalog::Symbol("sql.MergeOp"),
+          ir::datalog::ResultList(ir::datalog::Symbol("m3/%1"),
+                                  ir::datalog::ResultList()),
+          ir::datalog::OperandList(
+              ir::datalog::Symbol("m3/%0"),
+              ir::datalog::OperandList(ir::datalog::Symbol("<<ANY>>"),
+                                       ir::datalog::OperandList())),
+          ir::datalog::AttributeList())));
+  EXPECT_EQ(visitor.datalog_facts().ToDatalogString(),
+            expected_facts.ToDatalogString());
+}
+
+TEST(DatalogLoweringVisitorTest, LowersOperationsToFlatFacts) {
+  ir::Operation literal(
+      nullptr, kLiteralOperator,
+      ir::NamedAttributeMap(
+          {{"literal_str", ir::Attribute::Create<ir::StringAttribute>("x")},
+           {"index", ir::Attribute::Create<ir::Int64Attribute>(3)}}),
+      ir::ValueList());
+  ir::Operation merge(
+      nullptr, kMergeOpOperator, ir::NamedAttributeMap({}),
+      ir::ValueList({ir::Value::MakeDefaultOperationResultValue(literal),
+                     ir::Value(ir::value::Any())}));
+  DatalogLoweringVisitor visitor(OperationEncoding::kFlat);
+  visitor.SetValueNamePrefix("m3/");
+  literal.Accept(visitor);
+  merge.Accept(visitor);
+
+  const RakshaDatalogFacts &facts = visitor.datalog_facts();
+  EXPECT_TRUE(facts.is_operation_facts().empty());
+  EXPECT_EQ(facts.ToDatalogString(),
+            R"(isOperation("m3/op0").
+isOperation("m3/op1").
+operationHasActor("m3/op0", "sql").
+operationHasActor("m3/op1", "sql").
+operationHasOperator("m3/op0", "sql.ReadLiteral").
+operationHasOperator("m3/op1", "sql.MergeOp").
+operationHasResult("m3/op0", "m3/%0").
+operationHasResult("m3/op1", "m3/%1").
+operationHasOperandAtIndex("m3/op1", "m3/%0", 0).
+operationHasOperandAtIndex("m3/op1", "<<ANY>>", 1).
+operationHasAttributeValue("m3/op0", "literal_str", $StringAttributePayload("x")).
+operationHasAttributeValue("m3/op0", "index", $NumberAttributePayload(3)).)");
+}
+
 }  // namespace raksha::backends::policy_engine::souffle
@@ -0,0 +1,298 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/facts_string_encoder.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "absl/types/span.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+namespace {
+
+using EncodedValue = ir::datalog::ValueEncoder::EncodedValue;
+
+// A recursive descent parser for a single line of a `.facts` file. Each value
+// is handed to the encoder as soon as it has been parsed, so no intermediate
+// representation of the fact is built.
+class FactLineParser {
+ public:
+  FactLineParser(absl::string_view line,
+                 absl::Span<const std::string> attribute_types,
+                 ir::datalog::ValueEncoder &encoder)
+      : line_(line),
+        remaining_(line),
+        attribute_types_(attribute_types),
+        encoder_(encoder) {}
+
+  absl::StatusOr<EncodedFact> ParseFact() {
+    EncodedFact fact;
+    for (size_t index = 0; index < attribute_types_.size(); ++index) {
+      if (index > 0 && !absl::ConsumePrefix(&remaining_, ";")) {
+        return Error("expected `;` between columns");
+      }
+      absl::StatusOr<EncodedValue> column =
+          ParseColumn(attribute_types_[index]);
+      if (!column.ok()) return column.status();
+      fact.push_back(*column);
+      SkipWhitespace();
+    }
+    if (!remaining_.empty()) return Error("expected the end of the fact");
+    return fact;
+  }
+
+ private:
+  // Parses a column as a value of `attribute_type`. Only the kind of the type,
+  // which is its first character, matters.
+  absl::StatusOr<EncodedValue> ParseColumn(absl::string_view attribute_type) {
+    SkipWhitespace();
+    if (attribute_type.empty()) return Error("column without a type");
+    switch (attribute_type.front()) {
+      case 'i':
+        return ParseInteger();
+      case 'u':
+        return ParseUnsigned();
+      case 'f':
+        return ParseFloat();
+      case 's':
+        return ParseSymbolColumn();
+      case 'r':
+        if (absl::ConsumePrefix(&remaining_, "nil")) {
+          return encoder_.EncodeNil();
+        }
+        if (!absl::StartsWith(remaining_, "[")) {
+          return Error("expected a record or `nil`");
+        }
+        return ParseRecord();
+      case '+':
+        if (!absl::StartsWith(remaining_, "$")) {
+          return Error("expected an ADT branch");
+        }
+        return ParseAdtBranch();
+      default:
+        return Error(
+            absl::StrFormat("unsupported attribute type `%s`", attribute_type));
+    }
+  }
+
+  // A symbol column is either a quoted symbol or an unquoted symbol spanning
+  // the whole column, which is taken verbatim.
+  absl::StatusOr<EncodedValue> ParseSymbolColumn() {
+    if (absl::StartsWith(remaining_, "\"")) return ParseQuotedSymbol();
+    absl::string_view symbol = remaining_.substr(0, remaining_.find(';'));
+    remaining_.remove_prefix(symbol.size());
+    return encoder_.EncodeSymbol(absl::StripTrailingAsciiWhitespace(symbol));
+  }
+
+  // Parses a value nested in a record or ADT branch. Its type is not known, so
+  // symbols must be quoted and numbers with a fraction or exponent are floats.
+  absl::StatusOr<EncodedValue> ParseValue() {
+    SkipWhitespace();
+    if (remaining_.empty()) return Error("unexpected end of fact");
+    if (absl::ConsumePrefix(&remaining_, "nil")) return encoder_.EncodeNil();
+    switch (remaining_.front()) {
+      case '"':
+        return ParseQuotedSymbol();
+      case '[':
+        return ParseRecord();
+      case '$':
+        return ParseAdtBranch();
+      default: {
+        absl::string_view value_start = remaining_;
+        bool is_float = ConsumeNumber().find_first_of(".eE") !=
+                        absl::string_view::npos;
+        remaining_ = value_start;
+        return is_float ? ParseFloat() : ParseInteger();
+      }
+    }
+  }
+
+  // Parses a double-quoted symbol, in which `\"` and `\\` stand for a quote
+  // and a backslash.
+  absl::StatusOr<EncodedValue> ParseQuotedSymbol() {
+    remaining_.remove_prefix(1);
+    std::string symbol;
+    while (true) {
+      size_t end = remaining_.find_first_of("\"\\");
+      if (end == absl::string_view::npos) return Error("unterminated symbol");
+      symbol.append(remaining_.data(), end);
+      char delimiter = remaining_[end];
+      remaining_.remove_prefix(end + 1);
+      if (delimiter == '"') break;
+      if (!remaining_.empty() &&
+          (remaining_.front() == '"' || remaining_.front() == '\\')) {
+        symbol.push_back(remaining_.front());
+        remaining_.remove_prefix(1);
+      } else {
+        symbol.push_back('\\');
+      }
+    }
+    return encoder_.EncodeSymbol(symbol);
+  }
+
+  absl::StatusOr<EncodedValue> ParseRecord() {
+    remaining_.remove_prefix(1);
+    absl::StatusOr<std::vector<EncodedValue>> fields = ParseValueList("]");
+    if (!fields.ok()) return fields.status();
+    if (fields->empty()) return Error("records must have at least one field");
+    return encoder_.EncodeRecord(*fields);
+  }
+
+  absl::StatusOr<EncodedValue> ParseAdtBranch() {
+    remaining_.remove_prefix(1);
+    size_t name_length = 0;
+    while (name_length < remaining_.size() &&
+           (absl::ascii_isalnum(remaining_[name_length]) ||
+            remaining_[name_length] == '_')) {
+      ++name_length;
+    }
+    if (name_length == 0) return Error("expected an ADT branch name");
+    absl::string_view branch_name = remaining_.substr(0, name_length);
+    remaining_.remove_prefix(name_length);
+    SkipWhitespace();
+    if (!absl::ConsumePrefix(&remaining_, "(")) {
+      return Error("expected `(` after ADT branch name");
+    }
+    absl::StatusOr<std::vector<EncodedValue>> arguments = ParseValueList(")");
+    if (!arguments.ok()) return arguments.status();
+    return encoder_.EncodeAdtBranch(branch_name, *arguments);
+  }
+
+  absl::StatusOr<EncodedValue> ParseInteger() {
+    absl::string_view number = ConsumeNumber();
+    int64_t int_value = 0;
+    if (!absl::SimpleAtoi(number, &int_value)) {
+      return Error(absl::StrFormat("invalid number `%s`", number));
+    }
+    return encoder_.EncodeNumber(int_value);
+  }
+
+  // Unsigned numbers share the `RamDomain` representation of numbers.
+  absl::StatusOr<EncodedValue> ParseUnsigned() {
+    absl::string_view number = ConsumeNumber();
+    uint64_t unsigned_value = 0;
+    if (absl::StartsWith(number, "-") ||
+        !absl::SimpleAtoi(number, &unsigned_value)) {
+      return Error(absl::StrFormat("invalid unsigned number `%s`", number));
+    }
+    return encoder_.EncodeNumber(static_cast<int64_t>(unsigned_value));
+  }
+
+  absl::StatusOr<EncodedValue> ParseFloat() {
+    absl::string_view number = ConsumeNumber();
+    double float_value = 0;
+    if (!absl::SimpleAtod(number, &float_value)) {
+      return Error(absl::StrFormat("invalid float `%s`", number));
+    }
+    return encoder_.EncodeFloat(float_value);
+  }
+
+  // Consumes the longest prefix of the form `[+-]digits[.digits][e[+-]digits]`.
+  // Signs are only accepted where they can start a number or an exponent.
+  absl::string_view ConsumeNumber() {
+    size_t length = 0;
+    auto consume_sign = [&]() {
+      if (length < remaining_.size() &&
+          (remaining_[length] == '-' || remaining_[length] == '+')) {
+        ++length;
+      }
+    };
+    auto consume_digits = [&]() {
+      while (length < remaining_.size() &&
+             absl::ascii_isdigit(remaining_[length])) {
+        ++length;
+      }
+    };
+    consume_sign();
+    consume_digits();
+    if (length < remaining_.size() && remaining_[length] == '.') {
+      ++length;
+      consume_digits();
+    }
+    if (length < remaining_.size() &&
+        (remaining_[length] == 'e' || remaining_[length] == 'E')) {
+      ++length;
+      consume_sign();
+      consume_digits();
+    }
+    absl::string_view number = remaining_.substr(0, length);
+    remaining_.remove_prefix(length);
+    return number;
+  }
+
+  // Parses a possibly empty, comma-separated list of values up to and
+  // including `terminator`.
+  absl::StatusOr<std::vector<EncodedValue>> ParseValueList(
+      absl::string_view terminator) {
+    std::vector<EncodedValue> values;
+    SkipWhitespace();
+    if (absl::ConsumePrefix(&remaining_, terminator)) return values;
+    while (true) {
+      absl::StatusOr<EncodedValue> value = ParseValue();
+      if (!value.ok()) return value.status();
+      values.push_back(*value);
+      SkipWhitespace();
+      if (absl::ConsumePrefix(&remaining_, terminator)) return values;
+      if (!absl::ConsumePrefix(&remaining_, ",")) {
+        return Error(absl::StrFormat("expected `,` or `%s`", terminator));
+      }
+    }
+  }
+
+  void SkipWhitespace() {
+    remaining_ = absl::StripLeadingAsciiWhitespace(remaining_);
+  }
+
+  absl::Status Error(absl::string_view message) const {
+    return absl::InvalidArgumentError(
+        absl::StrFormat("Malformed fact `%s` at offset %d: %s", line_,
+                        line_.size() - remaining_.size(), message));
+  }
+
+  absl::string_view line_;
+  absl::string_view remaining_;
+  absl::Span<const std::string> attribute_types_;
+  ir::datalog::ValueEncoder &encoder_;
+};
+
+}  // namespace
+
+absl::StatusOr<std::vector<EncodedFact>> EncodeFactsString(
+    absl::string_view facts_string,
+    absl::Span<const std::string> attribute_types,
+    ir::datalog::ValueEncoder &encoder) {
+  std::vector<EncodedFact> facts;
+  for (absl::string_view line :
+       absl::StrSplit(facts_string, '\n', absl::SkipWhitespace())) {
+    absl::StatusOr<EncodedFact> fact =
+        FactLineParser(absl::StripAsciiWhitespace(line), attribute_types,
+                       encoder)
+            .ParseFact();
+    if (!fact.ok()) return fact.status();
+    facts.push_back(*std::move(fact));
+  }
+  return facts;
+}
+
+}  // namespace raksha::backends::policy_engine::souffle
@@ -0,0 +1,53 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#ifndef SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_FACTS_STRING_ENCODER_H_
+#define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_FACTS_STRING_ENCODER_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "src/ir/datalog/value.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+// The encoded columns of a single fact.
+using EncodedFact = std::vector<ir::datalog::ValueEncoder::EncodedValue>;
+
+// Parses `facts_string`, which is in the format of a Souffle `.facts` file
+// with `;` as the delimiter (one fact per line), and encodes each fact with
+// `encoder`. This allows facts that are only available as strings (such as the
+// facts carried by a `Policy`) to be handed to a Datalog engine without going
+// through the filesystem.
+//
+// Each column is parsed as a value of its entry in `attribute_types`, the
+// declared types of the relation as returned by
+// `souffle::Relation::getAttrType` (such as `i:number` or `s:Operation`), so a
+// symbol column holding `42` or `nil` is still a symbol. A symbol column is
+// either a quoted symbol, in which `\"` and `\\` are escapes, or taken
+// verbatim. Values nested in records and ADT branches have no declared type:
+// their symbols must be quoted, and their numbers are floats if they have a
+// fraction or an exponent.
+absl::StatusOr<std::vector<EncodedFact>> EncodeFactsString(
+    absl::string_view facts_string,
+    absl::Span<const std::string> attribute_types,
+    ir::datalog::ValueEncoder &encoder);
+
+}  // namespace raksha::backends::policy_engine::souffle
+
+#endif  // SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_FACTS_STRING_ENCODER_H_
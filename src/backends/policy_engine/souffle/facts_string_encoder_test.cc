@@ -0,0 +1,241 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/facts_string_encoder.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "src/common/testing/gtest.h"
+#include "src/ir/datalog/operation.h"
+#include "src/ir/datalog/value.h"
+
+namespace raksha::backends::policy_engine::souffle {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::TestWithParam;
+using ::testing::ValuesIn;
+
+// A `ValueEncoder` that renders every value into its Datalog string.
+class DatalogStringEncoder : public ir::datalog::ValueEncoder {
+ public:
+  std::vector<std::string> GetStrings(const EncodedFact &fact) const {
+    std::vector<std::string> result;
+    for (EncodedValue value : fact) result.push_back(strings_.at(value));
+    return result;
+  }
+
+  EncodedValue EncodeNumber(int64_t number) override {
+    return AddString(std::to_string(number));
+  }
+  EncodedValue EncodeFloat(double number) override {
+    return AddString(absl::StrFormat("%lg", number));
+  }
+  EncodedValue EncodeSymbol(absl::string_view symbol) override {
+    return AddString(absl::StrFormat(R"("%s")", symbol));
+  }
+  EncodedValue EncodeNil() override { return AddString("nil"); }
+  EncodedValue EncodeRecord(absl::Span<const EncodedValue> fields) override {
+    return AddString(absl::StrFormat("[%s]", JoinStrings(fields)));
+  }
+  EncodedValue EncodeAdtBranch(
+      absl::string_view branch_name,
+      absl::Span<const EncodedValue> arguments) override {
+    return AddString(
+        absl::StrFormat("$%s(%s)", branch_name, JoinStrings(arguments)));
+  }
+
+ private:
+  EncodedValue AddString(std::string str) {
+    strings_.push_back(std::move(str));
+    return strings_.size() - 1;
+  }
+
+  std::string JoinStrings(absl::Span<const EncodedValue> values) const {
+    return absl::StrJoin(values, ", ",
+                         [this](std::string *out, EncodedValue value) {
+                           absl::StrAppend(out, strings_.at(value));
+                         });
+  }
+
+  std::vector<std::string> strings_;
+};
+
+// A fact of a unary relation whose column has the given attribute type.
+struct UnaryFact {
+  absl::string_view attribute_type;
+  absl::string_view fact;
+};
+
+absl::StatusOr<std::vector<EncodedFact>> EncodeUnaryFact(
+    const UnaryFact &unary_fact, ir::datalog::ValueEncoder &encoder) {
+  return EncodeFactsString(unary_fact.fact,
+                           {std::string(unary_fact.attribute_type)}, encoder);
+}
+
+class EncodeFactsStringRoundTripTest : public TestWithParam<UnaryFact> {};
+
+TEST_P(EncodeFactsStringRoundTripTest, EncodesLikeDatalogString) {
+  DatalogStringEncoder encoder;
+  absl::StatusOr<std::vector<EncodedFact>> result =
+      EncodeUnaryFact(GetParam(), encoder);
+  ASSERT_TRUE(result.ok()) << result.status();
+  ASSERT_EQ(result->size(), 1);
+  EXPECT_THAT(encoder.GetStrings(result->front()),
+              ElementsAre(GetParam().fact));
+}
+
+static constexpr UnaryFact kRoundTripFacts[] = {
+    {"r:PreconditionList", "nil"},
+    {"i:number", "5"},
+    {"i:number", "-30"},
+    {"u:unsigned", "30"},
+    {"f:float", "0.5"},
+    {"s:symbol", R"("a symbol")"},
+    {"r:SqlPolicyRule",
+     R"(["set_restricted", $AddConfidentialityTag("restricted"), nil])"},
+    {"r:SqlPolicyRule",
+     R"(["remove", $RemoveConfidentialityTag("x"), [["pre", "tag"], nil]])"},
+    {"+:DPParameterValue", "$EpsilonValue(2)"},
+    {"+:SqlPolicyRuleResult", "$Null()"},
+    {"r:Operation",
+     R"(["sql", "sql.literal", ["%0", nil], nil, [["literal_value", )"
+     R"($StringAttributePayload("5")], nil]])"}};
+
+INSTANTIATE_TEST_SUITE_P(EncodeFactsStringRoundTripTest,
+                         EncodeFactsStringRoundTripTest,
+                         ValuesIn(kRoundTripFacts));
+
+TEST(EncodeFactsStringTest, EncodesOneFactPerLine) {
+  DatalogStringEncoder encoder;
+  absl::StatusOr<std::vector<EncodedFact>> result = EncodeFactsString(
+      "$EpsilonValue(2)\n$DeltaValue(1)\n\n", {"+:DPParameterValue"}, encoder);
+  ASSERT_TRUE(result.ok()) << result.status();
+  ASSERT_EQ(result->size(), 2);
+  EXPECT_THAT(encoder.GetStrings(result->at(0)),
+              ElementsAre("$EpsilonValue(2)"));
+  EXPECT_THAT(encoder.GetStrings(result->at(1)), ElementsAre("$DeltaValue(1)"));
+}
+
+TEST(EncodeFactsStringTest, EncodesMultipleColumns) {
+  DatalogStringEncoder encoder;
+  absl::StatusOr<std::vector<EncodedFact>> result =
+      EncodeFactsString(R"(bare symbol; ["x", 1]; 7; 1e3)",
+                        {"s:symbol", "r:Record", "i:number", "f:float"},
+                        encoder);
+  ASSERT_TRUE(result.ok()) << result.status();
+  ASSERT_EQ(result->size(), 1);
+  EXPECT_THAT(encoder.GetStrings(result->front()),
+              ElementsAre(R"("bare symbol")", R"(["x", 1])", "7", "1000"));
+}
+
+TEST(EncodeFactsStringTest, EncodesSymbolColumnsThatLookLikeOtherValues) {
+  DatalogStringEncoder encoder;
+  absl::StatusOr<std::vector<EncodedFact>> result = EncodeFactsString(
+      "42; -1; nil; 1.5", {"s:symbol", "s:symbol", "s:Operation", "s:symbol"},
+      encoder);
+  ASSERT_TRUE(result.ok()) << result.status();
+  ASSERT_EQ(result->size(), 1);
+  EXPECT_THAT(encoder.GetStrings(result->front()),
+              ElementsAre(R"("42")", R"("-1")", R"("nil")", R"("1.5")"));
+}
+
+TEST(EncodeFactsStringTest, UnescapesQuotedSymbols) {
+  DatalogStringEncoder encoder;
+  absl::StatusOr<std::vector<EncodedFact>> result = EncodeFactsString(
+      R"("say \"hi\""; ["a\\b", "c;d"]; "\n")",
+      {"s:symbol", "r:Record", "s:symbol"}, encoder);
+  ASSERT_TRUE(result.ok()) << result.status();
+  ASSERT_EQ(result->size(), 1);
+  EXPECT_THAT(encoder.GetStrings(result->front()),
+              ElementsAre(R"("say "hi"")", R"(["a\b", "c;d"])", R"("\n")"));
+}
+
+TEST(EncodeFactsStringTest, EmptyStringHasNoFacts) {
+  DatalogStringEncoder encoder;
+  absl::StatusOr<std::vector<EncodedFact>> result =
+      EncodeFactsString("", {"s:symbol"}, encoder);
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_TRUE(result->empty());
+}
+
+TEST(EncodeFactsStringTest, MatchesEncodingOfIsOperationFact) {
+  ir::datalog::IsOperationFact fact(ir::datalog::Operation(
+      ir::datalog::Symbol("sql"), ir::datalog::Symbol("sql.merge"),
+      ir::datalog::ResultList(ir::datalog::Symbol("%1"),
+                              ir::datalog::ResultList()),
+      ir::datalog::OperandList(
+          ir::datalog::Symbol("%0"),
+          ir::datalog::OperandList(ir::datalog::Symbol("%2"),
+                                   ir::datalog::OperandList())),
+      ir::datalog::AttributeList()));
+  DatalogStringEncoder encoder;
+  EncodedFact direct_encoding = fact.EncodeRelationArguments(encoder);
+  absl::StatusOr<std::vector<EncodedFact>> parsed_encoding = EncodeFactsString(
+      fact.ToDatalogFactsFileString(), {"r:Operation"}, encoder);
+  ASSERT_TRUE(parsed_encoding.ok()) << parsed_encoding.status();
+  ASSERT_EQ(parsed_encoding->size(), 1);
+  EXPECT_EQ(encoder.GetStrings(parsed_encoding->front()),
+            encoder.GetStrings(direct_encoding));
+}
+
+TEST(EncodeFactsStringTest, ReportsFactsWithTheWrongNumberOfColumns) {
+  DatalogStringEncoder encoder;
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      EncodeFactsString("1; 2", {"i:number"}, encoder).status()));
+  EXPECT_TRUE(absl::IsInvalidArgument(
+      EncodeFactsString("1", {"i:number", "i:number"}, encoder).status()));
+}
+
+class EncodeFactsStringErrorTest : public TestWithParam<UnaryFact> {};
+
+TEST_P(EncodeFactsStringErrorTest, ReportsMalformedFacts) {
+  DatalogStringEncoder encoder;
+  absl::StatusOr<std::vector<EncodedFact>> result =
+      EncodeUnaryFact(GetParam(), encoder);
+  EXPECT_TRUE(absl::IsInvalidArgument(result.status())) << result.status();
+}
+
+static constexpr UnaryFact kMalformedFacts[] = {
+    {"s:symbol", R"("unterminated)"},
+    {"s:symbol", R"("escaped end\")"},
+    {"r:Record", R"(["x", 1)"},
+    {"r:Record", "[]"},
+    {"r:Record", R"(["x" 1])"},
+    {"r:Record", R"("x")"},
+    {"r:Record", "[1-2]"},
+    {"+:Adt", "$(1)"},
+    {"+:Adt", "$Branch 1"},
+    {"+:Adt", "nil"},
+    {"i:number", "12abc"},
+    {"i:number", "1-2"},
+    {"i:number", "1+2"},
+    {"i:number", "1.5"},
+    {"i:number", "nil"},
+    {"u:unsigned", "-1"},
+    {"f:float", "1e"},
+    {"f:float", "1e2-3"},
+    {"s:symbol", R"("x" "y")"},
+    {"x:unknown", "1"}};
+
+INSTANTIATE_TEST_SUITE_P(EncodeFactsStringErrorTest,
+                         EncodeFactsStringErrorTest,
+                         ValuesIn(kMalformedFacts));
+
+}  // namespace
+}  // namespace raksha::backends::policy_engine::souffle
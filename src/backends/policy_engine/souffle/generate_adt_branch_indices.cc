@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+// Writes the indices of the ADT branches declared in the Datalog files given
+// on the command line to stdout, as the initializer entries of a map from
+// branch name to index. The output is included by `souffle_value_encoder.cc`.
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "src/backends/policy_engine/souffle/adt_branch_indices.h"
+#include "src/common/logging/logging.h"
+
+namespace {
+
+absl::StatusOr<std::string> ReadFileContents(std::filesystem::path file_path) {
+  std::ifstream file_stream(file_path);
+  if (!file_stream) {
+    return absl::FailedPreconditionError(absl::StrCat(
+        "Unable to read file '", file_path.string(), "': ", strerror(errno)));
+  }
+  std::ostringstream string_stream;
+  string_stream << file_stream.rdbuf();
+  return string_stream.str();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  raksha::backends::policy_engine::souffle::AdtBranchIndices branch_indices;
+  for (int arg = 1; arg < argc; ++arg) {
+    absl::StatusOr<std::string> datalog = ReadFileContents(argv[arg]);
+    if (!datalog.ok()) {
+      LOG(ERROR) << datalog.status();
+      return 1;
+    }
+    absl::Status status = raksha::backends::policy_engine::souffle::
+        AddAdtBranchIndices(*datalog, branch_indices);
+    if (!status.ok()) {
+      LOG(ERROR) << "Error in " << argv[arg] << ": " << status;
+      return 1;
+    }
+  }
+  std::cout << "// Generated by generate_adt_branch_indices. Do not edit.\n";
+  for (const auto& [branch_name, index] : branch_indices) {
+    std::cout << "{\"" << branch_name << "\", " << index << "},\n";
+  }
+  return 0;
+}
@@ -19,7 +19,10 @@
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <type_traits>
 
+#include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "src/backends/policy_engine/souffle/utils.h"
 #include "src/common/logging/logging.h"
 #include "src/ir/datalog/input_relation_fact.h"
@@ -28,18 +31,36 @@ namespace raksha::backends::policy_engine::souffle {
 
 namespace {
 
-template <typename F>
+template <typename Fact>
 absl::Status WriteFactsToFile(const std::filesystem::path &facts_path,
-                              absl::string_view relation_name, const F &facts) {
-  return WriteFactsStringToFactsFile(
-      facts_path, relation_name,
-      absl::StrJoin(facts, "\n", [](std::string *out, const auto &arg) {
-        absl::StrAppend(out, arg.ToDatalogFactsFileString());
-      }));
+                              absl::string_view relation_name,
+                              absl::Span<const Fact> facts) {
+  absl::StatusOr<std::ofstream> facts_file =
+      CreateFactsFile(facts_path, relation_name);
+  if (!facts_file.ok()) return facts_file.status();
+  WriteFactsFileLines(facts, *facts_file);
+  facts_file->close();
+  if (!*facts_file) {
+    return absl::InternalError(
+        absl::StrFormat("Unable to write facts file for %s: `%s`",
+                        relation_name, std::strerror(errno)));
+  }
+  return absl::OkStatus();
 }
 
 }  // namespace
 
+std::vector<std::string> RakshaDatalogFacts::GetRelationNames(
+    OperationEncoding operation_encoding) {
+  std::vector<std::string> relation_names;
+  RakshaDatalogFacts(operation_encoding)
+      .ForEachRelation([&relation_names](const auto &facts) {
+        using Fact = typename std::decay_t<decltype(facts)>::value_type;
+        relation_names.push_back(std::string(Fact::relation_name()));
+      });
+  return relation_names;
+}
+
 absl::Status RakshaDatalogFacts::DumpFactsToDirectory(
     const std::filesystem::path &facts_path,
     const std::vector<std::string> &empty_relations) const {
@@ -50,8 +71,16 @@ absl::Status RakshaDatalogFacts::DumpFactsToDirectory(
         absl::StrFormat("Requested directory `%s` is not found!", facts_path));
   }
 
-  auto status =
-      WriteFactsToFile(facts_path, "isOperation", is_operation_facts_);
+  // Every relation gets a file, even an empty one, as Souffle expects a file
+  // for each input relation.
+  absl::Status status;
+  ForEachRelation([&](const auto &facts) {
+    using Fact = typename std::decay_t<decltype(facts)>::value_type;
+    if (status.ok()) {
+      status = WriteFactsToFile(facts_path, Fact::relation_name(),
+                                absl::MakeConstSpan(facts));
+    }
+  });
   if (!status.ok()) return status;
   for (absl::string_view name : empty_relations) {
     // Allow this operation to fail (e.g., if someone has already written out
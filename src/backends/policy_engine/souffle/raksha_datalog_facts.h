@@ -17,28 +17,119 @@
 #define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_RAKSHA_DATALOG_FACTS_H_
 
 #include <filesystem>
+#include <ostream>
 #include <string>
 #include <vector>
 
 #include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "src/common/logging/logging.h"
 #include "src/ir/datalog/operation.h"
 
 namespace raksha::backends::policy_engine::souffle {
 
+// How operations are lowered to Datalog facts. The Souffle program that
+// consumes the facts has to be generated for the same encoding.
+enum class OperationEncoding {
+  // One `isOperation` fact per operation holding a nested record, whose
+  // operand, result and attribute lists are unwound by `operations.dl`.
+  kRecord,
+  // An id per operation and one fact per field of the operation, in the flat
+  // relations declared by `operations_flat.dl`. Programs have to be generated
+  // with `flat_operation_facts = True`.
+  kFlat,
+};
+
+// The facts of the operations in the flat encoding.
+struct FlatOperationFacts {
+  std::vector<ir::datalog::IsOperationIdFact> is_operation_facts;
+  std::vector<ir::datalog::OperationHasActorFact> actor_facts;
+  std::vector<ir::datalog::OperationHasOperatorFact> operator_facts;
+  std::vector<ir::datalog::OperationHasResultFact> result_facts;
+  std::vector<ir::datalog::OperationHasOperandAtIndexFact> operand_facts;
+  std::vector<ir::datalog::OperationHasAttributeValueFact> attribute_facts;
+
+  // Calls `f` with the facts of each relation.
+  template <typename F>
+  void ForEachRelation(F f) const {
+    f(is_operation_facts);
+    f(actor_facts);
+    f(operator_facts);
+    f(result_facts);
+    f(operand_facts);
+    f(attribute_facts);
+  }
+};
+
+// Writes `facts` to `out` as the lines of a Souffle input relations file, one
+// fact per line. Each line is formatted into a single buffer that is reused for
+// all facts, so that no string holding all the facts is ever built.
+template <typename Fact>
+void WriteFactsFileLines(absl::Span<const Fact> facts, std::ostream &out) {
+  std::string line;
+  for (const Fact &fact : facts) {
+    line.clear();
+    fact.AppendDatalogFactsFileString(&line);
+    line.push_back('\n');
+    out.write(line.data(), line.size());
+  }
+}
+
 // A class containing the Datalog facts produced by the IR translator in
 // structured (ie, C++ objects, not strings) form.
 class RakshaDatalogFacts {
  public:
+  explicit RakshaDatalogFacts(
+      OperationEncoding operation_encoding = OperationEncoding::kRecord)
+      : operation_encoding_(operation_encoding) {}
+
+  OperationEncoding operation_encoding() const { return operation_encoding_; }
+
+  // Returns the names of the input relations that the facts of a module are
+  // lowered to in the given encoding.
+  static std::vector<std::string> GetRelationNames(
+      OperationEncoding operation_encoding);
+
   void AddIsOperationFact(ir::datalog::IsOperationFact fact) {
+    CHECK(operation_encoding_ == OperationEncoding::kRecord)
+        << "`isOperation` records require the record encoding.";
     is_operation_facts_.push_back(std::move(fact));
   }
 
+  // Returns the facts of the flat encoding, to which the facts of operations
+  // are added.
+  FlatOperationFacts &mutable_flat_operation_facts() {
+    CHECK(operation_encoding_ == OperationEncoding::kFlat)
+        << "Flat operation facts require the flat encoding.";
+    return flat_operation_facts_;
+  }
+
   std::string ToDatalogString() const {
-    return absl::StrJoin(
-        is_operation_facts_, "\n",
-        [](std::string *out, const ir::datalog::IsOperationFact &arg) {
-          absl::StrAppend(out, arg.ToDatalogString());
-        });
+    std::string result;
+    AppendDatalogString(&result);
+    return result;
+  }
+
+  // Appends the facts to `out` as Datalog, one fact per line.
+  void AppendDatalogString(std::string *out) const {
+    bool first = true;
+    ForEachFact([&](const auto &fact) {
+      if (!first) out->push_back('\n');
+      first = false;
+      fact.AppendDatalogString(out);
+    });
+  }
+
+  // Writes the facts to `out` as Datalog, one fact per line. Unlike
+  // `ToDatalogString`, this only holds one fact in memory at a time.
+  void WriteDatalogString(std::ostream &out) const {
+    std::string line;
+    ForEachFact([&](const auto &fact) {
+      line.clear();
+      fact.AppendDatalogString(&line);
+      line.push_back('\n');
+      out.write(line.data(), line.size());
+    });
   }
 
   // Dumps facts as individual files in the provided directory so that they can
@@ -54,8 +145,33 @@ class RakshaDatalogFacts {
     return is_operation_facts_;
   }
 
+  const FlatOperationFacts &flat_operation_facts() const {
+    return flat_operation_facts_;
+  }
+
+  // Calls `f` with the vector of facts of each relation of the encoding in
+  // use. The facts of a relation all have the same type.
+  template <typename F>
+  void ForEachRelation(F f) const {
+    if (operation_encoding_ == OperationEncoding::kRecord) {
+      f(is_operation_facts_);
+      return;
+    }
+    flat_operation_facts_.ForEachRelation(f);
+  }
+
  private:
+  // Calls `f` on each fact of the encoding in use, in order.
+  template <typename F>
+  void ForEachFact(F f) const {
+    ForEachRelation([&f](const auto &facts) {
+      for (const auto &fact : facts) f(fact);
+    });
+  }
+
+  OperationEncoding operation_encoding_;
   std::vector<ir::datalog::IsOperationFact> is_operation_facts_;
+  FlatOperationFacts flat_operation_facts_;
 };
 
 }  // namespace raksha::backends::policy_engine::souffle
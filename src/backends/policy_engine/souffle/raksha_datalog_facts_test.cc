@@ -16,7 +16,11 @@
 #include "src/backends/policy_engine/souffle/raksha_datalog_facts.h"
 
 #include <filesystem>
+#include <sstream>
+#include <string>
 
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "src/common/logging/logging.h"
 #include "src/common/testing/gtest.h"
 #include "src/common/utils/filesystem.h"
@@ -180,6 +184,86 @@ TEST_F(DumpFactsToDirectoryTest,
                             directory_));
 }
 
+TEST(DumpFlatFactsToDirectoryTest, DumpsEveryFlatRelation) {
+  RakshaDatalogFacts facts(OperationEncoding::kFlat);
+  FlatOperationFacts& flat_facts = facts.mutable_flat_operation_facts();
+  flat_facts.is_operation_facts.push_back(
+      ir::datalog::IsOperationIdFact(Symbol("op0")));
+  flat_facts.operator_facts.push_back(ir::datalog::OperationHasOperatorFact(
+      Symbol("op0"), Symbol("sql.MergeOp")));
+  flat_facts.operand_facts.push_back(
+      ir::datalog::OperationHasOperandAtIndexFact(
+          Symbol("op0"), Symbol("input1"), ir::datalog::Number(0)));
+  flat_facts.attribute_facts.push_back(
+      ir::datalog::OperationHasAttributeValueFact(
+          Symbol("op0"), Symbol("literal_value"),
+          Attribute::String("number_5")));
+  absl::StatusOr<std::filesystem::path> directory =
+      common::utils::CreateTemporaryDirectory();
+  ASSERT_TRUE(directory.ok());
+
+  ASSERT_TRUE(facts.DumpFactsToDirectory(*directory).ok());
+  EXPECT_THAT(utils::test::ReadFileLines(*directory / "isOperation.facts"),
+              testing::ElementsAre("op0"));
+  EXPECT_THAT(
+      utils::test::ReadFileLines(*directory / "operationHasOperator.facts"),
+      testing::ElementsAre("op0;sql.MergeOp"));
+  EXPECT_THAT(utils::test::ReadFileLines(*directory /
+                                         "operationHasOperandAtIndex.facts"),
+              testing::ElementsAre("op0;input1;0"));
+  EXPECT_THAT(utils::test::ReadFileLines(*directory /
+                                         "operationHasAttributeValue.facts"),
+              testing::ElementsAre(R"(op0;literal_value;)"
+                                   R"($StringAttributePayload("number_5"))"));
+  // Relations without facts are still dumped, as Souffle expects a file for
+  // every input relation.
+  EXPECT_THAT(
+      utils::test::ReadFileLines(*directory / "operationHasActor.facts"),
+      testing::IsEmpty());
+  EXPECT_THAT(
+      utils::test::ReadFileLines(*directory / "operationHasResult.facts"),
+      testing::IsEmpty());
+  std::filesystem::remove_all(*directory);
+}
+
+TEST_F(DumpFactsToDirectoryTest, WriteFactsFileLinesWritesOneFactPerLine) {
+  std::ostringstream out;
+  WriteFactsFileLines(absl::MakeConstSpan(facts_.is_operation_facts()), out);
+  EXPECT_EQ(out.str(), absl::StrCat(is_operation_file_facts_[0], "\n",
+                                    is_operation_file_facts_[1], "\n"));
+}
+
+TEST_F(DumpFactsToDirectoryTest, WriteDatalogStringAgreesWithToDatalogString) {
+  std::ostringstream out;
+  facts_.WriteDatalogString(out);
+  EXPECT_EQ(out.str(), absl::StrCat(facts_.ToDatalogString(), "\n"));
+}
+
+TEST(RakshaDatalogFactsTest, AppendDatalogStringAppendsToTheBuffer) {
+  RakshaDatalogFacts facts(OperationEncoding::kFlat);
+  FlatOperationFacts& flat_facts = facts.mutable_flat_operation_facts();
+  flat_facts.is_operation_facts.push_back(
+      ir::datalog::IsOperationIdFact(Symbol("op0")));
+  flat_facts.operand_facts.push_back(
+      ir::datalog::OperationHasOperandAtIndexFact(
+          Symbol("op0"), Symbol("input1"), ir::datalog::Number(0)));
+  std::string out = "// Facts\n";
+  facts.AppendDatalogString(&out);
+  EXPECT_EQ(out, R"(// Facts
+isOperation("op0").
+operationHasOperandAtIndex("op0", "input1", 0).)");
+}
+
+TEST(RakshaDatalogFactsTest, GetRelationNamesNamesTheRelationsOfTheEncoding) {
+  EXPECT_THAT(RakshaDatalogFacts::GetRelationNames(OperationEncoding::kRecord),
+              testing::ElementsAre("isOperation"));
+  EXPECT_THAT(RakshaDatalogFacts::GetRelationNames(OperationEncoding::kFlat),
+              testing::ElementsAre("isOperation", "operationHasActor",
+                                   "operationHasOperator", "operationHasResult",
+                                   "operationHasOperandAtIndex",
+                                   "operationHasAttributeValue"));
+}
+
 }  // namespace
 
 }  // namespace raksha::backends::policy_engine::souffle
@@ -16,13 +16,30 @@
 
 #include "src/backends/policy_engine/souffle/souffle_policy_checker.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "souffle/SouffleInterface.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
 #include "src/backends/policy_engine/policy.h"
+#include "src/backends/policy_engine/souffle/binary_facts.h"
 #include "src/backends/policy_engine/souffle/datalog_lowering_visitor.h"
+#include "src/backends/policy_engine/souffle/facts_string_encoder.h"
+#include "src/backends/policy_engine/souffle/souffle_program_pool.h"
+#include "src/backends/policy_engine/souffle/souffle_value_encoder.h"
 #include "src/backends/policy_engine/souffle/utils.h"
 #include "src/common/utils/filesystem.h"
+#include "src/ir/datalog/operation.h"
 #include "src/ir/module.h"
 
 namespace raksha::backends::policy_engine {
@@ -35,66 +52,411 @@ using SouffleProgram = ::souffle::SouffleProgram;
 
 // These are from Raksha's "souffle" subpackage.
 using DatalogLoweringVisitor = souffle::DatalogLoweringVisitor;
+using RakshaDatalogFacts = souffle::RakshaDatalogFacts;
+using SouffleProgramPool = souffle::SouffleProgramPool;
+using SouffleValueEncoder = souffle::SouffleValueEncoder;
 
 static constexpr char kViolatesPolicyRelation[] = "violatesPolicy";
 static constexpr char kHasErrorRelation[] = "hasError";
 
-static bool IsModulePolicyCompliantHelper(
-    const ir::Module& module, const Policy& policy,
-    const std::filesystem::path& facts_directory) {
-  // Output the facts contained in the policy if they exist.
+// Returns the name of the relation that the facts of `policy` have to be
+// loaded into for a check, if any. The programs of a policy with a preloaded
+// program pool already hold its facts.
+static std::optional<std::string> GetPolicyFactsToLoad(const Policy& policy) {
+  if (policy.GetPreloadedProgramPool() != nullptr) return std::nullopt;
+  return policy.GetPolicyFactName();
+}
+
+// Writes the given facts and the facts of the policy into `facts_directory`
+// and loads them into the input relations of `program`.
+static void LoadFactsFromDirectory(
+    const RakshaDatalogFacts& facts, const Policy& policy,
+    const std::filesystem::path& facts_directory, SouffleProgram& program) {
+  // Output the facts contained in the policy if they exist. Souffle insists on
+  // a facts file for every input relation, so the policy relation of a
+  // compiled policy gets an empty one; loading it keeps the facts that the
+  // relation already holds.
   if (std::optional<std::string> optional_policy_fact_name =
           policy.GetPolicyFactName()) {
     std::optional<std::string> optional_policy_string =
         policy.GetPolicyString();
     CHECK(optional_policy_string);
     absl::Status output_policy_status = souffle::WriteFactsStringToFactsFile(
-        facts_directory, *optional_policy_fact_name, *optional_policy_string);
+        facts_directory, *optional_policy_fact_name,
+        GetPolicyFactsToLoad(policy) ? *optional_policy_string : "");
     CHECK(output_policy_status.ok())
         << "Unexpected error while outputting policy: " << output_policy_status;
   }
 
-  DatalogLoweringVisitor datalog_lowering_visitor;
-  module.Accept(datalog_lowering_visitor);
   absl::Status output_module_status =
-      datalog_lowering_visitor.datalog_facts().DumpFactsToDirectory(
-          facts_directory, {"isDPParameter"});
+      facts.DumpFactsToDirectory(facts_directory, {"isDPParameter"});
   CHECK(output_module_status.ok())
       << "Unexpected error while outputting module: " << output_module_status;
 
-  std::unique_ptr<SouffleProgram> program = policy.GetPolicyAnalysisChecker();
+  program.loadAll(facts_directory.string());
+}
 
-  // If we allow Souffle to set up its signal handler, it can cause issues when
-  // we call via JNI. See b/245620786 for a circumstance where this occurred.
-  int64_t setenv_result = setenv("SOUFFLE_ALLOW_SIGNALS", "NO", 1);
-  CHECK(setenv_result == 0) << "Could not set `SOUFFLE_ALLOW_SIGNALS";
-  program->loadAll(facts_directory.string());
-  program->run();
+// Encodes the given facts and the facts of the policy and inserts them
+// directly into the input relations of `program`. Fails without inserting any
+// facts if some value cannot be encoded.
+static absl::Status InsertFactsIntoProgram(const RakshaDatalogFacts& facts,
+                                           const Policy& policy,
+                                           SouffleProgram& program) {
+  SouffleValueEncoder encoder(program);
+  std::vector<std::pair<Relation*, souffle::EncodedFact>> tuples;
+  if (std::optional<std::string> optional_policy_fact_name =
+          GetPolicyFactsToLoad(policy)) {
+    std::optional<std::string> optional_policy_string =
+        policy.GetPolicyString();
+    CHECK(optional_policy_string);
+    Relation* policy_relation = ABSL_DIE_IF_NULL(
+        program.getRelation(*optional_policy_fact_name));
+    absl::StatusOr<std::vector<souffle::EncodedFact>> policy_facts =
+        souffle::EncodeFactsString(*optional_policy_string,
+                                   souffle::GetAttributeTypes(*policy_relation),
+                                   encoder);
+    CHECK(policy_facts.ok())
+        << "Unexpected error while encoding policy: " << policy_facts.status();
+    for (souffle::EncodedFact& fact : *policy_facts) {
+      tuples.emplace_back(policy_relation, std::move(fact));
+    }
+  }
+
+  auto encode_facts = [&](const auto& relation_facts) {
+    using Fact =
+        typename std::decay_t<decltype(relation_facts)>::value_type;
+    Relation* relation = ABSL_DIE_IF_NULL(
+        program.getRelation(std::string(Fact::relation_name())));
+    for (const Fact& fact : relation_facts) {
+      tuples.emplace_back(relation, fact.EncodeRelationArguments(encoder));
+    }
+  };
+  facts.ForEachRelation(encode_facts);
+  if (!encoder.status().ok()) return encoder.status();
+
+  for (const auto& [relation, fact] : tuples) {
+    souffle::InsertEncodedTuple(*relation, fact);
+  }
+  return absl::OkStatus();
+}
+
+// Adds the facts of the policy to `writer`, unless the programs of the policy
+// already hold them. The facts are parsed by the types of their relation in
+// `program`. Returns the names of the relations of the added facts.
+static std::vector<std::string> AddPolicyFacts(
+    const Policy& policy, const SouffleProgram& program,
+    souffle::BinaryFactsWriter& writer) {
+  std::optional<std::string> optional_policy_fact_name =
+      GetPolicyFactsToLoad(policy);
+  if (!optional_policy_fact_name) return {};
+  std::optional<std::string> optional_policy_string = policy.GetPolicyString();
+  CHECK(optional_policy_string);
+  const Relation* policy_relation = ABSL_DIE_IF_NULL(
+      program.getRelation(*optional_policy_fact_name));
+  absl::StatusOr<std::vector<souffle::EncodedFact>> policy_facts =
+      souffle::EncodeFactsString(*optional_policy_string,
+                                 souffle::GetAttributeTypes(*policy_relation),
+                                 writer);
+  CHECK(policy_facts.ok())
+      << "Unexpected error while encoding policy: " << policy_facts.status();
+  for (const souffle::EncodedFact& fact : *policy_facts) {
+    writer.AddFact(*optional_policy_fact_name, fact);
+  }
+  return {*optional_policy_fact_name};
+}
+
+// Encodes the given facts and the facts of the policy in the binary facts
+// format and loads them from there into the input relations of `program`.
+// Fails without loading any facts if some value cannot be encoded.
+static absl::Status LoadFactsAsBinaryFacts(const RakshaDatalogFacts& facts,
+                                           const Policy& policy,
+                                           SouffleProgram& program) {
+  souffle::BinaryFactsWriter writer;
+  std::vector<std::string> relation_names =
+      AddPolicyFacts(policy, program, writer);
+  facts.ForEachRelation([&writer](const auto& relation_facts) {
+    writer.AddFacts(absl::MakeConstSpan(relation_facts));
+  });
+  for (std::string& name :
+       RakshaDatalogFacts::GetRelationNames(facts.operation_encoding())) {
+    relation_names.push_back(std::move(name));
+  }
+  return souffle::LoadBinaryFacts(writer.Serialize(), relation_names,
+                                  program);
+}
+
+// Hands the given facts and the facts of the policy to `program` in the given
+// way. Facts that cannot be encoded directly for `program` are handed over
+// through `.facts` files instead. Returns false if the facts could not be
+// handed over.
+static bool LoadFacts(const RakshaDatalogFacts& facts, const Policy& policy,
+                      SoufflePolicyChecker::FactLoadingMode fact_loading_mode,
+                      SouffleProgram& program) {
+  absl::Status load_status;
+  switch (fact_loading_mode) {
+    case SoufflePolicyChecker::FactLoadingMode::kInMemory: {
+      load_status = InsertFactsIntoProgram(facts, policy, program);
+      break;
+    }
+    case SoufflePolicyChecker::FactLoadingMode::kBinaryFacts: {
+      load_status = LoadFactsAsBinaryFacts(facts, policy, program);
+      break;
+    }
+    case SoufflePolicyChecker::FactLoadingMode::kFactsDirectory: {
+      absl::StatusOr<std::filesystem::path> temp_dir =
+          common::utils::CreateTemporaryDirectory();
+      if (!temp_dir.ok()) {
+        LOG(ERROR) << absl::StrFormat(
+            "Could not create temporary directory for validating module: `%s`",
+            temp_dir.status().ToString());
+        return false;
+      }
+      LoadFactsFromDirectory(facts, policy, *temp_dir, program);
+      std::filesystem::remove_all(*temp_dir);
+      break;
+    }
+    default:
+      LOG(FATAL) << "Unknown fact loading mode.";
+      return false;
+  }
+  if (load_status.ok()) return true;
+  LOG(WARNING) << "Could not hand the facts to Souffle directly, falling back "
+                  "to `.facts` files: "
+               << load_status;
+  return LoadFacts(facts, policy,
+                   SoufflePolicyChecker::FactLoadingMode::kFactsDirectory,
+                   program);
+}
+
+// Runs `program`, whose input relations must already be populated, and returns
+// whether it found no policy violations and no errors.
+static bool RunPolicyCheck(SouffleProgram& program) {
+  program.run();
   Relation& errors =
-      *ABSL_DIE_IF_NULL(program->getRelation(kHasErrorRelation));
+      *ABSL_DIE_IF_NULL(program.getRelation(kHasErrorRelation));
   for (::souffle::tuple &errorMessageTuple : errors) {
     std::string message;
     errorMessageTuple >> message;
     LOG(ERROR) << "[Error] " << message << "\n";
   }
   Relation* hasPolicyViolation =
-      ABSL_DIE_IF_NULL(program->getRelation(kViolatesPolicyRelation));
+      ABSL_DIE_IF_NULL(program.getRelation(kViolatesPolicyRelation));
   return hasPolicyViolation->size() + errors.size() == 0;
 }
 
+// Calls `check` with a program for `policy` that runs on `num_threads`
+// threads, and returns its result. The program is taken from `pool` if there
+// is one.
+template <typename Check>
+static auto WithPolicyProgram(SouffleProgramPool* pool, const Policy& policy,
+                              size_t num_threads, Check check) {
+  if (pool != nullptr) {
+    SouffleProgramPool::Lease program = pool->Acquire();
+    // Pooled programs may have been used with another thread count before.
+    program->setNumThreads(num_threads);
+    return check(*program);
+  }
+  std::unique_ptr<SouffleProgram> program = policy.GetPolicyAnalysisChecker();
+  program->setNumThreads(num_threads);
+  return check(*program);
+}
+
+static void DisableSouffleSignalHandlers() {
+  // If we allow Souffle to set up its signal handler, it can cause issues when
+  // we call via JNI. See b/245620786 for a circumstance where this occurred.
+  int64_t setenv_result = setenv("SOUFFLE_ALLOW_SIGNALS", "NO", 1);
+  CHECK(setenv_result == 0) << "Could not set `SOUFFLE_ALLOW_SIGNALS";
+}
+
+// The prefix given to the values of the module at `position` in a batch.
+static std::string GetModuleValuePrefix(size_t position) {
+  return absl::StrCat("m", position, "/");
+}
+
+// Returns the position of the module whose value prefix `name` starts with,
+// if any.
+static std::optional<size_t> GetModulePosition(absl::string_view name,
+                                               size_t batch_size) {
+  if (!absl::ConsumePrefix(&name, "m")) return std::nullopt;
+  size_t position = 0;
+  if (!absl::SimpleAtoi(name.substr(0, name.find('/')), &position) ||
+      position >= batch_size) {
+    return std::nullopt;
+  }
+  return position;
+}
+
+namespace {
+
+// The violations found in the combined facts of a batch of modules.
+struct BatchViolations {
+  // The positions of the modules that are known to violate the policy.
+  absl::flat_hash_set<size_t> violating_positions;
+  // Whether there were violations or errors that could not be attributed to a
+  // module.
+  bool has_unattributed_violations = false;
+};
+
+}  // namespace
+
+// Attributes the violations and errors found by `program` to the modules of
+// the batch using the value prefix that the violation or error starts with.
+static BatchViolations AttributeBatchViolations(SouffleProgram& program,
+                                                size_t batch_size) {
+  BatchViolations result;
+  for (const char* relation_name :
+       {kViolatesPolicyRelation, kHasErrorRelation}) {
+    Relation& relation = *ABSL_DIE_IF_NULL(program.getRelation(relation_name));
+    for (::souffle::tuple& tuple : relation) {
+      // The first column of `violatesPolicy` is the offending access path,
+      // and the messages of `hasError` start with it.
+      std::string path_or_message;
+      tuple >> path_or_message;
+      std::optional<size_t> position =
+          GetModulePosition(path_or_message, batch_size);
+      if (!position) {
+        result.has_unattributed_violations = true;
+        continue;
+      }
+      result.violating_positions.insert(*position);
+      if (relation_name == kHasErrorRelation) {
+        LOG(ERROR) << "[Error] " << path_or_message << "\n";
+      }
+    }
+  }
+  return result;
+}
+
+SouffleProgramPool* SoufflePolicyChecker::GetProgramPool(
+    const Policy& policy) const {
+  if (SouffleProgramPool* pool = policy.GetPreloadedProgramPool()) {
+    return pool;
+  }
+  std::optional<std::string> checker_name =
+      policy.GetPolicyAnalysisCheckerName();
+  if (!checker_name) return nullptr;
+  absl::MutexLock lock(&program_pools_mutex_);
+  std::unique_ptr<SouffleProgramPool>& pool = program_pools_[*checker_name];
+  if (pool == nullptr) {
+    // The pool only ever builds programs of the same kind, so the policy that
+    // created it need not outlive it.
+    std::string name = *checker_name;
+    pool = std::make_unique<SouffleProgramPool>([name]() {
+      return std::unique_ptr<SouffleProgram>(
+          ::souffle::ProgramFactory::newInstance(name));
+    });
+  }
+  return pool.get();
+}
+
 bool SoufflePolicyChecker::IsModulePolicyCompliant(const ir::Module& module,
                                                    const Policy& policy) const {
-  absl::StatusOr<std::filesystem::path> temp_dir =
-      common::utils::CreateTemporaryDirectory();
-  if (!temp_dir.ok()) {
-    LOG(ERROR) << absl::StrFormat(
-        "Could not create temporary directory for validating module: `%s`",
-        temp_dir.status().ToString());
-    return false;
-  }
-  bool result = IsModulePolicyCompliantHelper(module, policy, *temp_dir);
-  std::filesystem::remove_all(*temp_dir);
+  DisableSouffleSignalHandlers();
+  DatalogLoweringVisitor datalog_lowering_visitor(operation_encoding_);
+  module.Accept(datalog_lowering_visitor);
+  return WithPolicyProgram(
+      GetProgramPool(policy), policy, num_threads_,
+      [&](SouffleProgram& program) {
+        return LoadFacts(datalog_lowering_visitor.datalog_facts(), policy,
+                         fact_loading_mode_, program) &&
+               RunPolicyCheck(program);
+      });
+}
+
+absl::StatusOr<bool> SoufflePolicyChecker::AreBinaryFactsPolicyCompliant(
+    absl::string_view binary_facts, const Policy& policy) const {
+  DisableSouffleSignalHandlers();
+  return WithPolicyProgram(
+      GetProgramPool(policy), policy, num_threads_,
+      [&](SouffleProgram& program) -> absl::StatusOr<bool> {
+        // Load the given facts first, as they are the ones that may be
+        // rejected, and nothing is loaded then. They may only hold the facts
+        // of a module, not the facts of the policy or derived facts.
+        absl::Status load_status = souffle::LoadBinaryFacts(
+            binary_facts,
+            RakshaDatalogFacts::GetRelationNames(operation_encoding_),
+            program);
+        if (!load_status.ok()) return load_status;
+        souffle::BinaryFactsWriter policy_writer;
+        std::vector<std::string> policy_relation_names =
+            AddPolicyFacts(policy, program, policy_writer);
+        absl::Status policy_status = souffle::LoadBinaryFacts(
+            policy_writer.Serialize(), policy_relation_names, program);
+        CHECK(policy_status.ok())
+            << "Unexpected error while loading policy: " << policy_status;
+        return RunPolicyCheck(program);
+      });
+}
+
+std::vector<bool> SoufflePolicyChecker::AreModulesPolicyCompliant(
+    absl::Span<const ir::Module* const> modules, const Policy& policy) const {
+  // The analysis of one module may be influenced by the facts of another, so
+  // each module needs an evaluation of its own.
+  if (!policy.IsModuleLocal()) {
+    return PolicyChecker::AreModulesPolicyCompliant(modules, policy);
+  }
+  DisableSouffleSignalHandlers();
+  std::vector<bool> result(modules.size(), true);
+  for (size_t begin = 0; begin < modules.size(); begin += max_batch_size_) {
+    std::vector<size_t> batch(
+        std::min(max_batch_size_, modules.size() - begin));
+    std::iota(batch.begin(), batch.end(), begin);
+    CheckModuleBatch(modules, batch, policy, result);
+  }
   return result;
 }
 
+void SoufflePolicyChecker::CheckModuleBatch(
+    absl::Span<const ir::Module* const> modules,
+    absl::Span<const size_t> batch, const Policy& policy,
+    std::vector<bool>& result) const {
+  if (batch.empty()) return;
+  if (batch.size() == 1) {
+    result[batch.front()] =
+        IsModulePolicyCompliant(*modules[batch.front()], policy);
+    return;
+  }
+
+  DatalogLoweringVisitor datalog_lowering_visitor(operation_encoding_);
+  for (size_t position = 0; position < batch.size(); ++position) {
+    datalog_lowering_visitor.SetValueNamePrefix(GetModuleValuePrefix(position));
+    modules[batch[position]]->Accept(datalog_lowering_visitor);
+  }
+  std::optional<BatchViolations> violations = WithPolicyProgram(
+      GetProgramPool(policy), policy, num_threads_,
+      [&](SouffleProgram& program) -> std::optional<BatchViolations> {
+        if (!LoadFacts(datalog_lowering_visitor.datalog_facts(), policy,
+                       fact_loading_mode_, program)) {
+          return std::nullopt;
+        }
+        program.run();
+        return AttributeBatchViolations(program, batch.size());
+      });
+  if (!violations) {
+    for (size_t index : batch) result[index] = false;
+    return;
+  }
+
+  std::vector<size_t> undecided;
+  for (size_t position = 0; position < batch.size(); ++position) {
+    if (violations->violating_positions.contains(position)) {
+      result[batch[position]] = false;
+    } else {
+      undecided.push_back(batch[position]);
+    }
+  }
+  // Modules that are not known to violate the policy are compliant, unless
+  // some violation could not be attributed. In that case, narrow down the
+  // culprits by checking smaller batches.
+  if (!violations->has_unattributed_violations) return;
+  if (undecided.size() < batch.size()) {
+    CheckModuleBatch(modules, undecided, policy, result);
+    return;
+  }
+  absl::Span<const size_t> undecided_span(undecided);
+  size_t half = undecided.size() / 2;
+  CheckModuleBatch(modules, undecided_span.first(half), policy, result);
+  CheckModuleBatch(modules, undecided_span.subspan(half), policy, result);
+}
+
 }  // namespace raksha::backends::policy_engine
@@ -16,17 +16,118 @@
 #ifndef SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_SOUFFLE_POLICY_CHECKER_H_
 #define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_SOUFFLE_POLICY_CHECKER_H_
 
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "src/backends/policy_engine/policy.h"
 #include "src/backends/policy_engine/policy_checker.h"
+#include "src/backends/policy_engine/souffle/raksha_datalog_facts.h"
+#include "src/backends/policy_engine/souffle/souffle_program_pool.h"
+#include "src/common/logging/logging.h"
 #include "src/ir/module.h"
 
 namespace raksha::backends::policy_engine {
 
+// Checks modules against policies by running the Souffle program of the
+// policy. The checker keeps the program instances it has built and reuses them
+// for later checks against policies with the same
+// `GetPolicyAnalysisCheckerName`, so a checker should be kept around when
+// many modules are checked. Checks against a policy with a preloaded program
+// pool, such as a `CompiledPolicy`, use the programs of that pool instead,
+// which already hold the facts of the policy.
+// The checker may be used from several threads at once.
 class SoufflePolicyChecker : public PolicyChecker {
  public:
+  // How the facts of the module and the policy are handed to Souffle.
+  enum class FactLoadingMode {
+    // Write the facts to `.facts` files in a temporary directory and have the
+    // Souffle program load them from there.
+    kFactsDirectory,
+    // Encode the facts and insert them directly into the relations of the
+    // Souffle program. This does not touch the filesystem.
+    kInMemory,
+    // Encode the facts in the compact binary facts format and insert them from
+    // there into the relations of the Souffle program, without going through
+    // Souffle's parser for `.facts` files. This does not touch the filesystem
+    // either.
+    kBinaryFacts,
+  };
+
+  static constexpr size_t kDefaultMaxBatchSize = 64;
+  static constexpr size_t kDefaultNumThreads = 1;
+
+  // `max_batch_size` bounds the number of modules that
+  // `AreModulesPolicyCompliant` checks in a single Souffle evaluation.
+  // `num_threads` is the number of threads that each Souffle evaluation may
+  // use. It only has an effect on programs generated with
+  // `--config=souffle_parallel`; other programs always run on one thread.
+  // `operation_encoding` is the encoding of operations that the programs of
+  // the checked policies were generated for.
+  explicit SoufflePolicyChecker(
+      FactLoadingMode fact_loading_mode = FactLoadingMode::kFactsDirectory,
+      size_t max_batch_size = kDefaultMaxBatchSize,
+      size_t num_threads = kDefaultNumThreads,
+      souffle::OperationEncoding operation_encoding =
+          souffle::OperationEncoding::kRecord)
+      : fact_loading_mode_(fact_loading_mode),
+        max_batch_size_(max_batch_size),
+        num_threads_(num_threads),
+        operation_encoding_(operation_encoding) {
+    CHECK(max_batch_size_ > 0) << "Batches must hold at least one module.";
+    CHECK(num_threads_ > 0) << "Souffle needs at least one thread.";
+  }
+
   bool IsModulePolicyCompliant(const ir::Module& module,
                                const Policy& policy) const override;
+
+  // Checks the modules of a module-local policy (see `Policy::IsModuleLocal`)
+  // in batches, running Souffle once on the combined facts of all modules of
+  // a batch. The values of each module are prefixed with the position of the
+  // module in its batch, so the facts of different modules never mention the
+  // same value and policy violations can be traced back to the module whose
+  // value they are about. If a batch has violations that do not mention any
+  // value, it is split up and checked again.
+  //
+  // Modules are checked one by one against policies that are not
+  // module-local.
+  std::vector<bool> AreModulesPolicyCompliant(
+      absl::Span<const ir::Module* const> modules,
+      const Policy& policy) const override;
+
+  // Checks the facts of a module given in the binary facts format, e.g., as
+  // read from a file written by `ir_to_operation_facts --binary`, against
+  // `policy`. The facts must be in the operation encoding of the checker.
+  // Returns an error if they cannot be loaded into the program of `policy`.
+  absl::StatusOr<bool> AreBinaryFactsPolicyCompliant(
+      absl::string_view binary_facts, const Policy& policy) const;
+
+ private:
+  // Returns the pool of programs for `policy`, or nullptr if the programs of
+  // `policy` cannot be reused.
+  souffle::SouffleProgramPool* GetProgramPool(const Policy& policy) const;
+
+  // Checks the modules at the indices in `batch` in a single evaluation and
+  // records the outcome in `result`.
+  void CheckModuleBatch(absl::Span<const ir::Module* const> modules,
+                        absl::Span<const size_t> batch, const Policy& policy,
+                        std::vector<bool>& result) const;
+
+  FactLoadingMode fact_loading_mode_;
+  size_t max_batch_size_;
+  size_t num_threads_;
+  souffle::OperationEncoding operation_encoding_;
+  mutable absl::Mutex program_pools_mutex_;
+  mutable absl::flat_hash_map<std::string,
+                              std::unique_ptr<souffle::SouffleProgramPool>>
+      program_pools_ ABSL_GUARDED_BY(program_pools_mutex_);
 };
 
 }  // namespace raksha::backends::policy_engine
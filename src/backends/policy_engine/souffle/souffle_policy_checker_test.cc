@@ -16,8 +16,20 @@
 #include "src/backends/policy_engine/souffle/souffle_policy_checker.h"
 
 #include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
 
+#include "souffle/SouffleInterface.h"
+#include "absl/log/die_if_null.h"
+#include "absl/status/statusor.h"
 #include "src/backends/policy_engine/dp_parameter_policy.h"
+#include "src/backends/policy_engine/souffle/binary_facts.h"
+#include "src/backends/policy_engine/souffle/compiled_policy.h"
+#include "src/backends/policy_engine/souffle/datalog_lowering_visitor.h"
+#include "src/backends/policy_engine/souffle/facts_string_encoder.h"
 #include "src/backends/policy_engine/sql_policy_rule_policy.h"
 #include "src/common/testing/gtest.h"
 #include "src/frontends/sql/ops/literal_op.h"
@@ -30,6 +42,11 @@
 #include "src/ir/value.h"
 #include "src/parser/ir/ir_parser.h"
 
+// A forward declaration of a function created by Souffle
+namespace souffle {
+SouffleProgram *newInstance_sql_policy_verifier_flat_cxx();
+}
+
 namespace raksha::backends::policy_engine {
 namespace {
 
@@ -44,13 +61,69 @@ ir::Value MakeOperationResultValue(const Operation &op) {
   return ir::Value(ir::value::OperationResult(op, 0));
 }
 
-TEST(SoufflePolicyCheckerTest, SqlPolicyRuleReturnsTrue) {
-  SoufflePolicyChecker checker;
+// A `SqlPolicyRulePolicy` that is checked by the SQL verifier generated for
+// the flat operation encoding.
+class FlatSqlPolicyRulePolicy : public SqlPolicyRulePolicy {
+ public:
+  using SqlPolicyRulePolicy::SqlPolicyRulePolicy;
+
+  std::unique_ptr<::souffle::SouffleProgram> GetPolicyAnalysisChecker()
+      const override {
+    return std::unique_ptr<::souffle::SouffleProgram>(ABSL_DIE_IF_NULL(
+        ::souffle::newInstance_sql_policy_verifier_flat_cxx()));
+  }
+
+  std::optional<std::string> GetPolicyAnalysisCheckerName() const override {
+    return "sql_policy_verifier_flat_cxx";
+  }
+};
+
+// A `SqlPolicyRulePolicy` that counts the programs built for it. It has no
+// checker name, so checkers build a new program for every evaluation.
+class CountingSqlPolicyRulePolicy : public SqlPolicyRulePolicy {
+ public:
+  using SqlPolicyRulePolicy::SqlPolicyRulePolicy;
+
+  std::unique_ptr<::souffle::SouffleProgram> GetPolicyAnalysisChecker()
+      const override {
+    ++evaluations_;
+    return SqlPolicyRulePolicy::GetPolicyAnalysisChecker();
+  }
+
+  std::optional<std::string> GetPolicyAnalysisCheckerName() const override {
+    return std::nullopt;
+  }
+
+  int evaluations() const { return evaluations_; }
+
+ private:
+  mutable int evaluations_ = 0;
+};
+
+// Returns the facts of `module` in the record operation encoding as a binary
+// facts file.
+std::string MakeBinaryFacts(const ir::Module &module) {
+  souffle::DatalogLoweringVisitor datalog_lowering_visitor;
+  module.Accept(datalog_lowering_visitor);
+  souffle::BinaryFactsWriter writer;
+  datalog_lowering_visitor.datalog_facts().ForEachRelation(
+      [&writer](const auto &relation_facts) {
+        writer.AddFacts(absl::MakeConstSpan(relation_facts));
+      });
+  return writer.Serialize();
+}
+
+// Every test is run once for each way of handing facts to Souffle.
+class SoufflePolicyCheckerTest
+    : public testing::TestWithParam<SoufflePolicyChecker::FactLoadingMode> {};
+
+TEST_P(SoufflePolicyCheckerTest, SqlPolicyRuleReturnsTrue) {
+  SoufflePolicyChecker checker(GetParam());
   ir::Module module;
   EXPECT_TRUE(checker.IsModulePolicyCompliant(module, SqlPolicyRulePolicy("")));
 }
 
-TEST(SoufflePolicyCheckerTest, SqlPolicyRuleReturnsFalse) {
+TEST_P(SoufflePolicyCheckerTest, SqlPolicyRuleReturnsFalse) {
   ir::IRContext ir_context;
   ir_context.RegisterOperator(std::make_unique<Operator>(
       frontends::sql::OpTraits<frontends::sql::LiteralOp>::kName));
@@ -58,7 +131,7 @@ TEST(SoufflePolicyCheckerTest, SqlPolicyRuleReturnsFalse) {
       frontends::sql::OpTraits<frontends::sql::SqlOutputOp>::kName));
   ir_context.RegisterOperator(std::make_unique<Operator>(
       frontends::sql::OpTraits<frontends::sql::TagTransformOp>::kName));
-  SoufflePolicyChecker checker;
+  SoufflePolicyChecker checker(GetParam());
   ir::BlockBuilder block_builder;
   const Operation &literal =
       block_builder.AddOperation<frontends::sql::LiteralOp>(ir_context,
@@ -84,8 +157,212 @@ TEST(SoufflePolicyCheckerTest, SqlPolicyRuleReturnsFalse) {
   EXPECT_TRUE(checker.IsModulePolicyCompliant(module, SqlPolicyRulePolicy("")));
 }
 
-TEST(SoufflePolicyCheckerTest, DpPolicyRuleReturnsTrue) {
+TEST_P(SoufflePolicyCheckerTest, FlatOperationEncodingAgreesWithRecords) {
+  SoufflePolicyChecker record_checker(GetParam());
+  SoufflePolicyChecker flat_checker(
+      GetParam(), SoufflePolicyChecker::kDefaultMaxBatchSize,
+      SoufflePolicyChecker::kDefaultNumThreads,
+      souffle::OperationEncoding::kFlat);
+  // Facts files are where the encodings differ most: the flat relations have
+  // columns that are whole symbols, which Souffle reads verbatim.
+  SoufflePolicyChecker flat_directory_checker(
+      SoufflePolicyChecker::FactLoadingMode::kFactsDirectory,
+      SoufflePolicyChecker::kDefaultMaxBatchSize,
+      SoufflePolicyChecker::kDefaultNumThreads,
+      souffle::OperationEncoding::kFlat);
+  IrProgramParserResult tainting_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = sql.literal[literal_string: "some_literal"]()
+%1 = sql.tag_transform[rule_name: "taint_rule"](%0)
+%2 = sql.sql_output[](%1)
+} })");
+  IrProgramParserResult clean_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = sql.literal[literal_string: "some_literal"]()
+%1 = sql.sql_output[](%0)
+} })");
+  constexpr absl::string_view kTaintingRules =
+      R"(["taint_rule", $AddConfidentialityTag("taint"), nil])";
+  for (const auto &[module, rules, expected] :
+       std::vector<std::tuple<const ir::Module *, std::string, bool>>{
+           {tainting_result.module.get(), std::string(kTaintingRules), false},
+           {tainting_result.module.get(), "", true},
+           {clean_result.module.get(), std::string(kTaintingRules), true}}) {
+    ASSERT_EQ(record_checker.IsModulePolicyCompliant(
+                  *module, SqlPolicyRulePolicy(rules)),
+              expected);
+    EXPECT_EQ(flat_checker.IsModulePolicyCompliant(
+                  *module, FlatSqlPolicyRulePolicy(rules)),
+              expected);
+    EXPECT_EQ(flat_directory_checker.IsModulePolicyCompliant(
+                  *module, FlatSqlPolicyRulePolicy(rules)),
+              expected);
+  }
+}
+
+// The programs of a compiled policy keep the facts of the policy between
+// checks, while the facts of the modules must still not leak into the next
+// check.
+TEST_P(SoufflePolicyCheckerTest, CompiledPolicyAgreesWithItsSource) {
+  SoufflePolicyChecker checker(GetParam());
+  IrProgramParserResult parse_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = sql.literal[literal_string: "some_literal"]()
+%1 = sql.tag_transform[rule_name: "taint_rule"](%0)
+%2 = sql.sql_output[](%1)
+} })");
+  const ir::Module &module = *parse_result.module;
+  ir::Module empty_module;
+  SqlPolicyRulePolicy tainting_policy(
+      R"(["taint_rule", $AddConfidentialityTag("taint"), nil])");
+  absl::StatusOr<std::unique_ptr<CompiledPolicy>> compiled_tainting_policy =
+      CompiledPolicy::Compile(tainting_policy);
+  ASSERT_TRUE(compiled_tainting_policy.ok())
+      << compiled_tainting_policy.status();
+  absl::StatusOr<std::unique_ptr<CompiledPolicy>> compiled_empty_policy =
+      CompiledPolicy::Compile(SqlPolicyRulePolicy(""));
+  ASSERT_TRUE(compiled_empty_policy.ok()) << compiled_empty_policy.status();
+  EXPECT_EQ(tainting_policy.GetPreloadedProgramPool(), nullptr);
+  EXPECT_NE((*compiled_tainting_policy)->GetPreloadedProgramPool(), nullptr);
+
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_FALSE(checker.IsModulePolicyCompliant(module, tainting_policy));
+    EXPECT_FALSE(
+        checker.IsModulePolicyCompliant(module, **compiled_tainting_policy));
+    EXPECT_TRUE(checker.IsModulePolicyCompliant(empty_module,
+                                                **compiled_tainting_policy));
+    EXPECT_TRUE(
+        checker.IsModulePolicyCompliant(module, **compiled_empty_policy));
+  }
+  std::vector<const ir::Module *> modules = {&module, &empty_module, &module};
+  EXPECT_THAT(
+      checker.AreModulesPolicyCompliant(modules, **compiled_tainting_policy),
+      testing::ElementsAre(false, true, false));
+}
+
+TEST(SoufflePolicyCheckerBinaryFactsTest, ChecksPrebuiltBinaryFacts) {
   SoufflePolicyChecker checker;
+  IrProgramParserResult parse_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = sql.literal[literal_string: "some_literal"]()
+%1 = sql.tag_transform[rule_name: "taint_rule"](%0)
+%2 = sql.sql_output[](%1)
+} })");
+  std::string binary_facts = MakeBinaryFacts(*parse_result.module);
+
+  SqlPolicyRulePolicy tainting_policy(
+      R"(["taint_rule", $AddConfidentialityTag("taint"), nil])");
+  absl::StatusOr<std::unique_ptr<CompiledPolicy>> compiled_tainting_policy =
+      CompiledPolicy::Compile(tainting_policy);
+  ASSERT_TRUE(compiled_tainting_policy.ok())
+      << compiled_tainting_policy.status();
+  for (const Policy *policy :
+       {static_cast<const Policy *>(&tainting_policy),
+        static_cast<const Policy *>(compiled_tainting_policy->get())}) {
+    absl::StatusOr<bool> result =
+        checker.AreBinaryFactsPolicyCompliant(binary_facts, *policy);
+    ASSERT_TRUE(result.ok()) << result.status();
+    EXPECT_FALSE(*result);
+  }
+  absl::StatusOr<bool> result = checker.AreBinaryFactsPolicyCompliant(
+      binary_facts, SqlPolicyRulePolicy(""));
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_TRUE(*result);
+
+  EXPECT_FALSE(
+      checker.AreBinaryFactsPolicyCompliant("not binary facts", tainting_policy)
+          .ok());
+}
+
+// Binary facts may only fill the input relations of a module; they must not
+// be able to assert a violation or smuggle in policy rules.
+TEST(SoufflePolicyCheckerBinaryFactsTest, RejectsFactsOfOtherRelations) {
+  SoufflePolicyChecker checker;
+  souffle::BinaryFactsWriter violation_writer;
+  violation_writer.AddFact(
+      "violatesPolicy", {violation_writer.EncodeSymbol("owner"),
+                         violation_writer.EncodeSymbol("tag"),
+                         violation_writer.EncodeSymbol("value")});
+  EXPECT_FALSE(checker
+                   .AreBinaryFactsPolicyCompliant(violation_writer.Serialize(),
+                                                  SqlPolicyRulePolicy(""))
+                   .ok());
+
+  constexpr absl::string_view kTaintingRules =
+      R"(["taint_rule", $AddConfidentialityTag("taint"), nil])";
+  souffle::BinaryFactsWriter rule_writer;
+  absl::StatusOr<std::vector<souffle::EncodedFact>> rule_facts =
+      souffle::EncodeFactsString(kTaintingRules, {"r:SqlPolicyRule"},
+                                 rule_writer);
+  ASSERT_TRUE(rule_facts.ok()) << rule_facts.status();
+  for (const souffle::EncodedFact &fact : *rule_facts) {
+    rule_writer.AddFact("isSqlPolicyRule", fact);
+  }
+  absl::StatusOr<std::unique_ptr<CompiledPolicy>> compiled_empty_policy =
+      CompiledPolicy::Compile(SqlPolicyRulePolicy(""));
+  ASSERT_TRUE(compiled_empty_policy.ok()) << compiled_empty_policy.status();
+  EXPECT_FALSE(checker
+                   .AreBinaryFactsPolicyCompliant(rule_writer.Serialize(),
+                                                  **compiled_empty_policy)
+                   .ok());
+
+  // The rejected rules must not have reached the programs of the policy.
+  IrProgramParserResult parse_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = sql.literal[literal_string: "some_literal"]()
+%1 = sql.tag_transform[rule_name: "taint_rule"](%0)
+%2 = sql.sql_output[](%1)
+} })");
+  absl::StatusOr<bool> result = checker.AreBinaryFactsPolicyCompliant(
+      MakeBinaryFacts(*parse_result.module), **compiled_empty_policy);
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_TRUE(*result);
+}
+
+TEST(SoufflePolicyCheckerBinaryFactsTest, RejectsColumnsOfTheWrongType) {
+  SoufflePolicyChecker flat_checker(
+      SoufflePolicyChecker::FactLoadingMode::kFactsDirectory,
+      SoufflePolicyChecker::kDefaultMaxBatchSize,
+      SoufflePolicyChecker::kDefaultNumThreads,
+      souffle::OperationEncoding::kFlat);
+  IrProgramParserResult parse_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = sql.literal[literal_string: "some_literal"]()
+%1 = sql.sql_output[](%0)
+} })");
+  // The record encoding fills `isOperation` with a record, where the flat
+  // encoding expects the symbol naming the operation.
+  EXPECT_FALSE(flat_checker
+                   .AreBinaryFactsPolicyCompliant(
+                       MakeBinaryFacts(*parse_result.module),
+                       FlatSqlPolicyRulePolicy(""))
+                   .ok());
+}
+
+TEST(CompiledPolicyTest, RejectsPoliciesWithoutANamedChecker) {
+  class UnnamedPolicy : public SqlPolicyRulePolicy {
+   public:
+    using SqlPolicyRulePolicy::SqlPolicyRulePolicy;
+    std::optional<std::string> GetPolicyAnalysisCheckerName() const override {
+      return std::nullopt;
+    }
+  };
+  EXPECT_FALSE(CompiledPolicy::Compile(UnnamedPolicy("")).ok());
+}
+
+TEST(CompiledPolicyTest, RejectsMalformedPolicyFacts) {
+  EXPECT_FALSE(
+      CompiledPolicy::Compile(SqlPolicyRulePolicy(R"(["unterminated)")).ok());
+}
+
+TEST_P(SoufflePolicyCheckerTest, DpPolicyRuleReturnsTrue) {
+  SoufflePolicyChecker checker(GetParam());
   ir::Module module;
   EXPECT_TRUE(
       checker.IsModulePolicyCompliant(module, DpParameterPolicy(10, 10)));
@@ -97,8 +374,8 @@ TEST(SoufflePolicyCheckerTest, DpPolicyRuleReturnsTrue) {
 // 5. We show that this result passes with a global epsilon limit of 10 and
 // fails with a global epsilon limit of 9 (as group by doubles the
 // sensitivity of the epsilon-5 privacy mechanism).
-TEST(SoufflePolicyCheckerTest, DpPolicyRuleReturnsFalse) {
-  SoufflePolicyChecker checker;
+TEST_P(SoufflePolicyCheckerTest, DpPolicyRuleReturnsFalse) {
+  SoufflePolicyChecker checker(GetParam());
   IrProgramParserResult parse_result = ParseProgram(R"(
 module m0 {
 block b0 {
@@ -116,5 +393,154 @@ block b0 {
       checker.IsModulePolicyCompliant(module, DpParameterPolicy(10, 1000)));
 }
 
+// A checker reuses the programs it has built, so the facts of one check must
+// not leak into the next one.
+TEST_P(SoufflePolicyCheckerTest, RepeatedChecksAreIndependent) {
+  SoufflePolicyChecker checker(GetParam());
+  IrProgramParserResult parse_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = core.input[name: "MyTable"]()
+%1 = sql.group_by[](%0)
+%2 = privacy_mechanism[epsilon: 5](%1)
+%3 = sql.average[](%2)
+%4 = sql.sql_output[](%3)
+} })");
+  const ir::Module &module = *parse_result.module;
+  ir::Module empty_module;
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_FALSE(
+        checker.IsModulePolicyCompliant(module, DpParameterPolicy(9, 0)));
+    EXPECT_TRUE(
+        checker.IsModulePolicyCompliant(empty_module, DpParameterPolicy(9, 0)));
+    EXPECT_TRUE(
+        checker.IsModulePolicyCompliant(module, DpParameterPolicy(10, 1000)));
+  }
+}
+
+// Programs that were not generated for parallel evaluation ignore the thread
+// count, so this holds with and without `--config=souffle_parallel`.
+TEST_P(SoufflePolicyCheckerTest, ThreadCountDoesNotChangeResults) {
+  SoufflePolicyChecker checker(
+      GetParam(), SoufflePolicyChecker::kDefaultMaxBatchSize,
+      /*num_threads=*/4);
+  IrProgramParserResult parse_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = core.input[name: "MyTable"]()
+%1 = sql.group_by[](%0)
+%2 = privacy_mechanism[epsilon: 5](%1)
+%3 = sql.average[](%2)
+%4 = sql.sql_output[](%3)
+} })");
+  const ir::Module &module = *parse_result.module;
+  EXPECT_FALSE(
+      checker.IsModulePolicyCompliant(module, DpParameterPolicy(9, 0)));
+  EXPECT_TRUE(
+      checker.IsModulePolicyCompliant(module, DpParameterPolicy(10, 1000)));
+}
+
+TEST_P(SoufflePolicyCheckerTest, BatchCheckAttributesViolationsToModules) {
+  // A small batch size makes the modules span several batches.
+  SoufflePolicyChecker checker(GetParam(), /*max_batch_size=*/3);
+  constexpr absl::string_view kViolatingProgram = R"(
+module m0 {
+block b0 {
+%0 = core.input[name: "MyTable"]()
+%1 = sql.group_by[](%0)
+%2 = privacy_mechanism[epsilon: 5](%1)
+%3 = sql.average[](%2)
+%4 = sql.sql_output[](%3)
+} })";
+  constexpr absl::string_view kCompliantProgram = R"(
+module m0 {
+block b0 {
+%0 = core.input[name: "MyTable"]()
+%1 = privacy_mechanism[epsilon: 2](%0)
+%2 = sql.sql_output[](%1)
+} })";
+  std::vector<IrProgramParserResult> parse_results;
+  for (absl::string_view program :
+       {kViolatingProgram, kCompliantProgram, kCompliantProgram,
+        kViolatingProgram, kViolatingProgram, kCompliantProgram,
+        kCompliantProgram}) {
+    parse_results.push_back(ParseProgram(program));
+  }
+  std::vector<const ir::Module *> modules;
+  for (const IrProgramParserResult &parse_result : parse_results) {
+    modules.push_back(parse_result.module.get());
+  }
+  EXPECT_THAT(
+      checker.AreModulesPolicyCompliant(modules, DpParameterPolicy(9, 0)),
+      testing::ElementsAre(false, true, true, false, false, true, true));
+  EXPECT_THAT(
+      checker.AreModulesPolicyCompliant(modules, DpParameterPolicy(10, 1000)),
+      testing::Each(true));
+  EXPECT_TRUE(
+      checker.AreModulesPolicyCompliant({}, DpParameterPolicy(9, 0)).empty());
+}
+
+// The violations of the SQL verifier name the output they are about, so a
+// batch with compliant and violating modules is decided in one evaluation.
+TEST_P(SoufflePolicyCheckerTest, BatchCheckAttributesSqlViolationsToModules) {
+  SoufflePolicyChecker checker(GetParam());
+  IrProgramParserResult tainting_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = sql.literal[literal_string: "some_literal"]()
+%1 = sql.tag_transform[rule_name: "taint_rule"](%0)
+%2 = sql.sql_output[](%1)
+} })");
+  IrProgramParserResult clean_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = sql.literal[literal_string: "some_literal"]()
+%1 = sql.sql_output[](%0)
+} })");
+  CountingSqlPolicyRulePolicy policy(
+      R"(["taint_rule", $AddConfidentialityTag("taint"), nil])");
+  ASSERT_TRUE(policy.IsModuleLocal());
+  std::vector<const ir::Module *> modules = {
+      tainting_result.module.get(), clean_result.module.get(),
+      clean_result.module.get(), tainting_result.module.get()};
+  EXPECT_THAT(checker.AreModulesPolicyCompliant(modules, policy),
+              testing::ElementsAre(false, true, true, false));
+  EXPECT_EQ(policy.evaluations(), 1);
+}
+
+// The DP analysis reports outputs when there is no privacy mechanism at all,
+// which depends on all the facts it sees. A mechanism in one module must not
+// hide the violation of another, so modules are not batched for this policy.
+TEST_P(SoufflePolicyCheckerTest, BatchCheckKeepsModulesOfGlobalAnalysesApart) {
+  SoufflePolicyChecker checker(GetParam());
+  IrProgramParserResult mechanism_free_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = core.input[name: "MyTable"]()
+%1 = sql.sql_output[](%0)
+} })");
+  IrProgramParserResult mechanism_result = ParseProgram(R"(
+module m0 {
+block b0 {
+%0 = core.input[name: "MyTable"]()
+%1 = privacy_mechanism[epsilon: 2](%0)
+%2 = sql.sql_output[](%1)
+} })");
+  DpParameterPolicy policy(10, 1000);
+  ASSERT_FALSE(policy.IsModuleLocal());
+  EXPECT_FALSE(
+      checker.IsModulePolicyCompliant(*mechanism_free_result.module, policy));
+  std::vector<const ir::Module *> modules = {
+      mechanism_free_result.module.get(), mechanism_result.module.get()};
+  EXPECT_THAT(checker.AreModulesPolicyCompliant(modules, policy),
+              testing::ElementsAre(false, true));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SoufflePolicyCheckerTest, SoufflePolicyCheckerTest,
+    testing::Values(SoufflePolicyChecker::FactLoadingMode::kFactsDirectory,
+                    SoufflePolicyChecker::FactLoadingMode::kInMemory,
+                    SoufflePolicyChecker::FactLoadingMode::kBinaryFacts));
+
 }  // anonymous namespace
 }  // namespace raksha::backends::policy_engine
@@ -0,0 +1,66 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/souffle_program_pool.h"
+
+#include "src/common/logging/logging.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+SouffleProgramPool::Lease SouffleProgramPool::Acquire() {
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!idle_programs_.empty()) {
+      IdleProgram idle_program = std::move(idle_programs_.back());
+      idle_programs_.pop_back();
+      return Lease(*this, std::move(idle_program.program),
+                   idle_program.use_count + 1);
+    }
+  }
+  // Build the program outside of the lock, as this is the expensive part.
+  std::unique_ptr<::souffle::SouffleProgram> program =
+      ABSL_DIE_IF_NULL(program_factory_());
+  return Lease(*this, std::move(program), 1);
+}
+
+void SouffleProgramPool::AddIdleProgram(
+    std::unique_ptr<::souffle::SouffleProgram> program) {
+  CHECK(program != nullptr) << "Only programs can be added to the pool.";
+  absl::MutexLock lock(&mutex_);
+  if (idle_programs_.size() >= max_idle_programs_) return;
+  idle_programs_.push_back({std::move(program), 0});
+}
+
+size_t SouffleProgramPool::IdleProgramCount() const {
+  absl::MutexLock lock(&mutex_);
+  return idle_programs_.size();
+}
+
+void SouffleProgramPool::Release(
+    std::unique_ptr<::souffle::SouffleProgram> program, size_t use_count) {
+  if (use_count >= max_uses_per_program_) return;
+  // Input, intermediate and output relations all have to go: input relations
+  // hold the facts of the previous user and everything else was derived from
+  // them. Only the shared facts of retained relations stay.
+  for (::souffle::Relation *relation : program->getAllRelations()) {
+    if (retained_relations_.contains(relation->getName())) continue;
+    relation->purge();
+  }
+  absl::MutexLock lock(&mutex_);
+  if (idle_programs_.size() >= max_idle_programs_) return;
+  idle_programs_.push_back({std::move(program), use_count});
+}
+
+}  // namespace raksha::backends::policy_engine::souffle
@@ -0,0 +1,135 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#ifndef SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_SOUFFLE_PROGRAM_POOL_H_
+#define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_SOUFFLE_PROGRAM_POOL_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "souffle/SouffleInterface.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+// A pool of instances of a single Souffle program. Constructing a Souffle
+// program allocates all of its relations and indices, which is a large part of
+// the cost of checking a small module. The pool hands out previously built
+// instances instead, purging every relation of an instance when it is returned
+// so that the next user starts from an empty program.
+//
+// Relations named in `retained_relations` are not purged. They hold facts that
+// every user of the pool shares, which the program factory loads into each
+// new instance.
+//
+// The symbol and record tables of a Souffle program cannot be cleared, so a
+// pooled instance is discarded after `max_uses_per_program` runs to bound the
+// memory they accumulate.
+//
+// The pool is thread-safe. Every lease is exclusive, so concurrent users are
+// handed different instances.
+class SouffleProgramPool {
+ public:
+  using ProgramFactory =
+      std::function<std::unique_ptr<::souffle::SouffleProgram>()>;
+
+  // An exclusive handle on a program of the pool. The program is returned to
+  // the pool when the lease is destroyed.
+  class Lease {
+   public:
+    Lease(Lease &&other)
+        : pool_(std::exchange(other.pool_, nullptr)),
+          program_(std::move(other.program_)),
+          use_count_(other.use_count_) {}
+    Lease &operator=(Lease &&) = delete;
+    Lease(const Lease &) = delete;
+    Lease &operator=(const Lease &) = delete;
+
+    ~Lease() {
+      if (pool_ != nullptr) pool_->Release(std::move(program_), use_count_);
+    }
+
+    ::souffle::SouffleProgram &operator*() const { return *program_; }
+    ::souffle::SouffleProgram *operator->() const { return program_.get(); }
+    ::souffle::SouffleProgram *get() const { return program_.get(); }
+
+   private:
+    friend class SouffleProgramPool;
+
+    Lease(SouffleProgramPool &pool,
+          std::unique_ptr<::souffle::SouffleProgram> program, size_t use_count)
+        : pool_(&pool), program_(std::move(program)), use_count_(use_count) {}
+
+    SouffleProgramPool *pool_;
+    std::unique_ptr<::souffle::SouffleProgram> program_;
+    // The number of leases of this program, including this one.
+    size_t use_count_;
+  };
+
+  static constexpr size_t kDefaultMaxIdlePrograms = 8;
+  static constexpr size_t kDefaultMaxUsesPerProgram = 1024;
+
+  explicit SouffleProgramPool(
+      ProgramFactory program_factory,
+      size_t max_idle_programs = kDefaultMaxIdlePrograms,
+      size_t max_uses_per_program = kDefaultMaxUsesPerProgram,
+      absl::flat_hash_set<std::string> retained_relations = {})
+      : program_factory_(std::move(program_factory)),
+        max_idle_programs_(max_idle_programs),
+        max_uses_per_program_(max_uses_per_program),
+        retained_relations_(std::move(retained_relations)) {}
+
+  SouffleProgramPool(const SouffleProgramPool &) = delete;
+  SouffleProgramPool &operator=(const SouffleProgramPool &) = delete;
+
+  // Returns an empty instance of the program, building a new one only if no
+  // idle instance is available. The pool must outlive the returned lease.
+  Lease Acquire();
+
+  // Adds `program`, which must be a fresh instance as built by the factory, to
+  // the idle instances. This lets a caller that already built an instance, for
+  // example to check that it can be built, hand it over instead of discarding
+  // it. The program is dropped if the pool is full.
+  void AddIdleProgram(std::unique_ptr<::souffle::SouffleProgram> program);
+
+  // Returns the number of instances currently waiting in the pool.
+  size_t IdleProgramCount() const;
+
+ private:
+  struct IdleProgram {
+    std::unique_ptr<::souffle::SouffleProgram> program;
+    size_t use_count;
+  };
+
+  void Release(std::unique_ptr<::souffle::SouffleProgram> program,
+               size_t use_count);
+
+  ProgramFactory program_factory_;
+  size_t max_idle_programs_;
+  size_t max_uses_per_program_;
+  absl::flat_hash_set<std::string> retained_relations_;
+  mutable absl::Mutex mutex_;
+  std::vector<IdleProgram> idle_programs_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace raksha::backends::policy_engine::souffle
+
+#endif  // SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_SOUFFLE_PROGRAM_POOL_H_
@@ -0,0 +1,149 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/souffle_program_pool.h"
+
+#include <memory>
+#include <string>
+
+#include "souffle/SouffleInterface.h"
+#include "src/backends/policy_engine/dp_parameter_policy.h"
+#include "src/common/testing/gtest.h"
+
+namespace raksha::backends::policy_engine::souffle {
+namespace {
+
+std::unique_ptr<::souffle::SouffleProgram> MakeDpPolicyVerifier() {
+  return DpParameterPolicy(10, 10).GetPolicyAnalysisChecker();
+}
+
+// Inserts a tuple of zeroes into the first input relation of `program`.
+void InsertSomeFact(::souffle::SouffleProgram &program) {
+  ASSERT_FALSE(program.getInputRelations().empty());
+  ::souffle::Relation &relation = *program.getInputRelations().front();
+  ::souffle::tuple tuple(&relation);
+  for (size_t index = 0; index < relation.getArity(); ++index) {
+    tuple[index] = 0;
+  }
+  relation.insert(tuple);
+}
+
+size_t TotalRelationSize(const ::souffle::SouffleProgram &program) {
+  size_t total_size = 0;
+  for (const ::souffle::Relation *relation : program.getAllRelations()) {
+    total_size += relation->size();
+  }
+  return total_size;
+}
+
+TEST(SouffleProgramPoolTest, ReusesReleasedPrograms) {
+  SouffleProgramPool pool(MakeDpPolicyVerifier);
+  EXPECT_EQ(pool.IdleProgramCount(), 0);
+  ::souffle::SouffleProgram *first_program = nullptr;
+  {
+    SouffleProgramPool::Lease program = pool.Acquire();
+    first_program = program.get();
+  }
+  EXPECT_EQ(pool.IdleProgramCount(), 1);
+  SouffleProgramPool::Lease program = pool.Acquire();
+  EXPECT_EQ(program.get(), first_program);
+  EXPECT_EQ(pool.IdleProgramCount(), 0);
+}
+
+TEST(SouffleProgramPoolTest, HandsOutAddedPrograms) {
+  int built_programs = 0;
+  SouffleProgramPool pool(
+      [&built_programs]() {
+        ++built_programs;
+        return MakeDpPolicyVerifier();
+      },
+      /*max_idle_programs=*/1, /*max_uses_per_program=*/1);
+  std::unique_ptr<::souffle::SouffleProgram> added_program =
+      MakeDpPolicyVerifier();
+  ::souffle::SouffleProgram *added_program_address = added_program.get();
+  pool.AddIdleProgram(std::move(added_program));
+  EXPECT_EQ(pool.IdleProgramCount(), 1);
+  // A full pool drops further programs.
+  pool.AddIdleProgram(MakeDpPolicyVerifier());
+  EXPECT_EQ(pool.IdleProgramCount(), 1);
+  {
+    SouffleProgramPool::Lease program = pool.Acquire();
+    EXPECT_EQ(program.get(), added_program_address);
+  }
+  EXPECT_EQ(built_programs, 0);
+  // The added program counts its uses from its first lease.
+  EXPECT_EQ(pool.IdleProgramCount(), 0);
+}
+
+TEST(SouffleProgramPoolTest, ConcurrentLeasesGetDifferentPrograms) {
+  SouffleProgramPool pool(MakeDpPolicyVerifier);
+  SouffleProgramPool::Lease first_program = pool.Acquire();
+  SouffleProgramPool::Lease second_program = pool.Acquire();
+  EXPECT_NE(first_program.get(), second_program.get());
+}
+
+TEST(SouffleProgramPoolTest, PurgesRelationsOfReleasedPrograms) {
+  SouffleProgramPool pool(MakeDpPolicyVerifier);
+  {
+    SouffleProgramPool::Lease program = pool.Acquire();
+    InsertSomeFact(*program);
+    program->run();
+    EXPECT_GT(TotalRelationSize(*program), 0);
+  }
+  SouffleProgramPool::Lease program = pool.Acquire();
+  EXPECT_EQ(TotalRelationSize(*program), 0);
+}
+
+TEST(SouffleProgramPoolTest, KeepsRetainedRelationsOfReleasedPrograms) {
+  std::string retained_relation;
+  {
+    std::unique_ptr<::souffle::SouffleProgram> program =
+        MakeDpPolicyVerifier();
+    retained_relation = program->getInputRelations().front()->getName();
+  }
+  SouffleProgramPool pool(MakeDpPolicyVerifier,
+                          SouffleProgramPool::kDefaultMaxIdlePrograms,
+                          SouffleProgramPool::kDefaultMaxUsesPerProgram,
+                          {retained_relation});
+  {
+    SouffleProgramPool::Lease program = pool.Acquire();
+    InsertSomeFact(*program);
+    program->run();
+  }
+  SouffleProgramPool::Lease program = pool.Acquire();
+  EXPECT_EQ(program->getRelation(retained_relation)->size(), 1);
+  EXPECT_EQ(TotalRelationSize(*program), 1);
+}
+
+TEST(SouffleProgramPoolTest, KeepsAtMostMaxIdlePrograms) {
+  SouffleProgramPool pool(MakeDpPolicyVerifier, /*max_idle_programs=*/1);
+  {
+    SouffleProgramPool::Lease first_program = pool.Acquire();
+    SouffleProgramPool::Lease second_program = pool.Acquire();
+  }
+  EXPECT_EQ(pool.IdleProgramCount(), 1);
+}
+
+TEST(SouffleProgramPoolTest, DiscardsProgramsAfterMaxUses) {
+  SouffleProgramPool pool(MakeDpPolicyVerifier, /*max_idle_programs=*/1,
+                          /*max_uses_per_program=*/2);
+  { SouffleProgramPool::Lease program = pool.Acquire(); }
+  EXPECT_EQ(pool.IdleProgramCount(), 1);
+  { SouffleProgramPool::Lease program = pool.Acquire(); }
+  EXPECT_EQ(pool.IdleProgramCount(), 0);
+}
+
+}  // namespace
+}  // namespace raksha::backends::policy_engine::souffle
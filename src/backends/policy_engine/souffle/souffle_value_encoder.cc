@@ -0,0 +1,221 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/backends/policy_engine/souffle/souffle_value_encoder.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "souffle/SouffleInterface.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "src/backends/policy_engine/souffle/binary_facts.h"
+#include "src/common/logging/logging.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+using ::souffle::RamDomain;
+using ::souffle::RamFloat;
+
+static_assert(std::is_same_v<RamDomain,
+                             ir::datalog::ValueEncoder::EncodedValue>,
+              "Souffle must be built with RAM_DOMAIN_SIZE=64.");
+
+namespace {
+
+// Returns the index Souffle assigns to each branch of the algebraic data types
+// that may appear in the input relations of the Raksha verifiers. The indices
+// are generated from the `.type` declarations in `src/analysis/souffle`; see
+// `AddAdtBranchIndices`.
+const absl::flat_hash_map<absl::string_view, RamDomain> &GetAdtBranchIndices() {
+  static const auto *const kAdtBranchIndices =
+      new absl::flat_hash_map<absl::string_view, RamDomain>({
+#include "src/backends/policy_engine/souffle/adt_branch_indices.inc"
+      });
+  return *kAdtBranchIndices;
+}
+
+// Returns whether a value of `kind` may be stored in a column whose Souffle
+// attribute type is `attribute_type`, such as `s:symbol` or `r:Operation`.
+// The first character of the type gives the kind of its values.
+bool FitsAttributeType(BinaryValueKind kind, absl::string_view attribute_type) {
+  if (attribute_type.empty()) return false;
+  switch (attribute_type.front()) {
+    case 'i':
+    case 'u':
+      return kind == BinaryValueKind::kNumber;
+    case 'f':
+      return kind == BinaryValueKind::kFloat;
+    case 's':
+      return kind == BinaryValueKind::kSymbol;
+    case 'r':
+      return kind == BinaryValueKind::kRecord || kind == BinaryValueKind::kNil;
+    case '+':
+      return kind == BinaryValueKind::kAdtBranch;
+    default:
+      return false;
+  }
+}
+
+// Returns the relation named `relation_name` if it is one of the input
+// relations of `program` that are named in `relation_names`, and an error
+// otherwise.
+absl::StatusOr<::souffle::Relation *> GetLoadableRelation(
+    absl::string_view relation_name,
+    absl::Span<const std::string> relation_names,
+    const ::souffle::SouffleProgram &program) {
+  if (std::find(relation_names.begin(), relation_names.end(), relation_name) ==
+      relation_names.end()) {
+    return absl::InvalidArgumentError(absl::StrFormat(
+        "Relation `%s` of the binary facts may not be loaded.",
+        relation_name));
+  }
+  for (::souffle::Relation *relation : program.getInputRelations()) {
+    if (relation->getName() == relation_name) return relation;
+  }
+  return absl::NotFoundError(absl::StrFormat(
+      "Unknown input relation `%s` in binary facts.", relation_name));
+}
+
+}  // namespace
+
+SouffleValueEncoder::EncodedValue SouffleValueEncoder::EncodeNumber(
+    int64_t number) {
+  return number;
+}
+
+SouffleValueEncoder::EncodedValue SouffleValueEncoder::EncodeFloat(
+    double number) {
+  return ::souffle::ramBitCast<RamDomain>(static_cast<RamFloat>(number));
+}
+
+SouffleValueEncoder::EncodedValue SouffleValueEncoder::EncodeSymbol(
+    absl::string_view symbol) {
+  return symbol_table_.encode(std::string(symbol));
+}
+
+// Souffle represents `nil` as the record reference 0.
+SouffleValueEncoder::EncodedValue SouffleValueEncoder::EncodeNil() {
+  return 0;
+}
+
+SouffleValueEncoder::EncodedValue SouffleValueEncoder::EncodeRecord(
+    absl::Span<const EncodedValue> fields) {
+  return record_table_.pack(fields.data(), fields.size());
+}
+
+// A (non-enum) ADT value is stored by Souffle as the record
+// `[branch_index, argument]`, where a branch with more than one argument
+// stores its arguments as a nested record.
+SouffleValueEncoder::EncodedValue SouffleValueEncoder::EncodeAdtBranch(
+    absl::string_view branch_name, absl::Span<const EncodedValue> arguments) {
+  const auto &branch_indices = GetAdtBranchIndices();
+  auto find_result = branch_indices.find(branch_name);
+  if (find_result == branch_indices.end()) {
+    if (status_.ok()) {
+      status_ = absl::NotFoundError(
+          absl::StrFormat("Unknown ADT branch `%s`.", branch_name));
+    }
+    return EncodeNil();
+  }
+  std::array<RamDomain, 2> adt_record = {
+      find_result->second, (arguments.size() == 1) ? arguments.front()
+                                                   : EncodeRecord(arguments)};
+  return record_table_.pack(adt_record.data(), adt_record.size());
+}
+
+void InsertEncodedTuple(
+    ::souffle::Relation &relation,
+    absl::Span<const ir::datalog::ValueEncoder::EncodedValue> columns) {
+  CHECK(columns.size() == relation.getArity())
+      << "Arity mismatch when inserting into `" << relation.getName() << "`.";
+  ::souffle::tuple tuple(&relation);
+  for (size_t index = 0; index < columns.size(); ++index) {
+    tuple[index] = columns[index];
+  }
+  relation.insert(tuple);
+}
+
+std::vector<std::string> GetAttributeTypes(
+    const ::souffle::Relation &relation) {
+  std::vector<std::string> attribute_types;
+  attribute_types.reserve(relation.getArity());
+  for (size_t index = 0; index < relation.getArity(); ++index) {
+    attribute_types.push_back(relation.getAttrType(index));
+  }
+  return attribute_types;
+}
+
+absl::Status LoadBinaryFacts(absl::string_view binary_facts,
+                             absl::Span<const std::string> relation_names,
+                             ::souffle::SouffleProgram &program) {
+  SouffleValueEncoder encoder(program);
+  // Facts of the same relation are stored together, so remember the relation
+  // of the last fact. The tuples are only inserted once all facts have been
+  // decoded, so that a failure leaves the relations untouched.
+  absl::string_view last_relation_name;
+  ::souffle::Relation *relation = nullptr;
+  std::vector<std::pair<::souffle::Relation *, std::vector<RamDomain>>> tuples;
+  absl::Status status;
+  absl::Status decode_status = DecodeBinaryFacts(
+      binary_facts, encoder,
+      [&](absl::string_view relation_name,
+          absl::Span<const SouffleValueEncoder::EncodedValue> columns,
+          absl::Span<const BinaryValueKind> column_kinds) {
+        if (!status.ok()) return;
+        if (relation == nullptr || relation_name != last_relation_name) {
+          absl::StatusOr<::souffle::Relation *> loadable_relation =
+              GetLoadableRelation(relation_name, relation_names, program);
+          if (!loadable_relation.ok()) {
+            status = loadable_relation.status();
+            return;
+          }
+          last_relation_name = relation_name;
+          relation = *loadable_relation;
+        }
+        if (columns.size() != relation->getArity()) {
+          status = absl::InvalidArgumentError(absl::StrFormat(
+              "Arity mismatch for relation `%s` in binary facts.",
+              relation_name));
+          return;
+        }
+        for (size_t index = 0; index < column_kinds.size(); ++index) {
+          if (!FitsAttributeType(column_kinds[index],
+                                 relation->getAttrType(index))) {
+            status = absl::InvalidArgumentError(absl::StrFormat(
+                "Column %d of relation `%s` in binary facts does not hold a "
+                "value of type `%s`.",
+                index, relation_name, relation->getAttrType(index)));
+            return;
+          }
+        }
+        tuples.emplace_back(
+            relation, std::vector<RamDomain>(columns.begin(), columns.end()));
+      });
+  if (!decode_status.ok()) return decode_status;
+  if (!status.ok()) return status;
+  if (!encoder.status().ok()) return encoder.status();
+  for (const auto &[tuple_relation, columns] : tuples) {
+    InsertEncodedTuple(*tuple_relation, columns);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace raksha::backends::policy_engine::souffle
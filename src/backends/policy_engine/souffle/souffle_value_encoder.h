@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#ifndef SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_SOUFFLE_VALUE_ENCODER_H_
+#define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_SOUFFLE_VALUE_ENCODER_H_
+
+#include <string>
+#include <vector>
+
+#include "souffle/SouffleInterface.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "src/ir/datalog/value.h"
+
+namespace raksha::backends::policy_engine::souffle {
+
+// A `ValueEncoder` that encodes values into the `RamDomain` representation of
+// a particular Souffle program, interning symbols and records in the program's
+// own symbol and record tables. The resulting values can be inserted into the
+// program's relations directly, without going through `.facts` files.
+class SouffleValueEncoder : public ir::datalog::ValueEncoder {
+ public:
+  explicit SouffleValueEncoder(::souffle::SouffleProgram &program)
+      : symbol_table_(program.getSymbolTable()),
+        record_table_(program.getRecordTable()) {}
+
+  EncodedValue EncodeNumber(int64_t number) override;
+  EncodedValue EncodeFloat(double number) override;
+  EncodedValue EncodeSymbol(absl::string_view symbol) override;
+  EncodedValue EncodeNil() override;
+  EncodedValue EncodeRecord(absl::Span<const EncodedValue> fields) override;
+  // Only the branches of the ADTs declared by the Raksha verifiers in
+  // `src/analysis/souffle` are known to the encoder. Other branches are
+  // encoded as `nil` and make `status()` fail.
+  EncodedValue EncodeAdtBranch(
+      absl::string_view branch_name,
+      absl::Span<const EncodedValue> arguments) override;
+
+  // Returns the first error encountered while encoding values, if any. Values
+  // encoded by an encoder whose status is not ok must not be inserted into the
+  // program.
+  const absl::Status &status() const { return status_; }
+
+ private:
+  ::souffle::SymbolTable &symbol_table_;
+  ::souffle::RecordTable &record_table_;
+  absl::Status status_;
+};
+
+// Inserts a tuple with the given encoded columns into `relation`.
+void InsertEncodedTuple(
+    ::souffle::Relation &relation,
+    absl::Span<const ir::datalog::ValueEncoder::EncodedValue> columns);
+
+// Returns the declared types of the columns of `relation`, as expected by
+// `EncodeFactsString`.
+std::vector<std::string> GetAttributeTypes(const ::souffle::Relation &relation);
+
+// Decodes facts in the format written by `BinaryFactsWriter` and inserts them
+// directly into the relations of `program`. Only the input relations of
+// `program` that are named in `relation_names` are loaded; binary facts from
+// outside the checker should name just the relations of the facts of a module
+// (see `RakshaDatalogFacts::GetRelationNames`). Fails if the facts name
+// another relation, if a column holds a value of another kind than the type
+// of the column, or if a value cannot be encoded, in which case no facts are
+// inserted.
+absl::Status LoadBinaryFacts(absl::string_view binary_facts,
+                             absl::Span<const std::string> relation_names,
+                             ::souffle::SouffleProgram &program);
+
+}  // namespace raksha::backends::policy_engine::souffle
+
+#endif  // SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_SOUFFLE_VALUE_ENCODER_H_
@@ -16,15 +16,17 @@
 
 #include "src/backends/policy_engine/souffle/utils.h"
 
+#include <cerrno>
+#include <cstring>
 #include <fstream>
 
 #include "absl/strings/str_format.h"
 
 namespace raksha::backends::policy_engine::souffle {
 
-absl::Status WriteFactsStringToFactsFile(
+absl::StatusOr<std::ofstream> CreateFactsFile(
     const std::filesystem::path &facts_directory_path,
-    absl::string_view relation_name, absl::string_view facts_string) {
+    absl::string_view relation_name) {
   std::filesystem::path fact_files_path(
       facts_directory_path /
       std::string(absl::StrFormat("%s.facts", relation_name)));
@@ -39,8 +41,16 @@ absl::Status WriteFactsStringToFactsFile(
         absl::StrFormat("Unable to create facts file for %s: `%s`",
                         relation_name, std::strerror(errno)));
   }
+  return facts_file;
+}
 
-  facts_file << facts_string;
+absl::Status WriteFactsStringToFactsFile(
+    const std::filesystem::path &facts_directory_path,
+    absl::string_view relation_name, absl::string_view facts_string) {
+  absl::StatusOr<std::ofstream> facts_file =
+      CreateFactsFile(facts_directory_path, relation_name);
+  if (!facts_file.ok()) return facts_file.status();
+  *facts_file << facts_string;
   return absl::OkStatus();
 }
 
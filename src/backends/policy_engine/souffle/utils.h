@@ -18,12 +18,20 @@
 #define SRC_BACKENDS_POLICY_ENGINE_SOUFFLE_UTILS_H_
 
 #include <filesystem>
+#include <fstream>
 
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 
 namespace raksha::backends::policy_engine::souffle {
 
+// Creates the facts file for `relation_name` in `facts_directory_path` and
+// returns a stream for writing the facts to it. Fails if the file exists.
+absl::StatusOr<std::ofstream> CreateFactsFile(
+    const std::filesystem::path &facts_directory_path,
+    absl::string_view relation_name);
+
 absl::Status WriteFactsStringToFactsFile(
     const std::filesystem::path &facts_directory_path,
     absl::string_view relation_name, absl::string_view facts_string);
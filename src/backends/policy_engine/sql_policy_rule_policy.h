@@ -37,10 +37,14 @@ class SqlPolicyRulePolicy : public Policy {
   explicit SqlPolicyRulePolicy(std::string is_sql_policy_rule_facts)
       : is_sql_policy_rule_facts_(std::move(is_sql_policy_rule_facts)) {}
 
-  std::unique_ptr<souffle::SouffleProgram> GetPolicyAnalysisChecker()
+  std::unique_ptr<::souffle::SouffleProgram> GetPolicyAnalysisChecker()
       const override {
-    return std::unique_ptr<souffle::SouffleProgram>(
-        ABSL_DIE_IF_NULL(souffle::newInstance_sql_policy_verifier_cxx()));
+    return std::unique_ptr<::souffle::SouffleProgram>(
+        ABSL_DIE_IF_NULL(::souffle::newInstance_sql_policy_verifier_cxx()));
+  }
+
+  std::optional<std::string> GetPolicyAnalysisCheckerName() const override {
+    return "sql_policy_verifier_cxx";
   }
 
   std::optional<std::string> GetPolicyFactName() const override {
@@ -51,6 +55,10 @@ class SqlPolicyRulePolicy : public Policy {
     return is_sql_policy_rule_facts_;
   }
 
+  // The SQL verifier only follows tags along the values that operations
+  // share, and its violations name the output they are about.
+  bool IsModuleLocal() const override { return true; }
+
  private:
   std::string is_sql_policy_rule_facts_;
 };
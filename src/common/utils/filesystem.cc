@@ -18,6 +18,10 @@
 
 #include <cstdio>
 #include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_format.h"
@@ -45,4 +49,38 @@ absl::StatusOr<std::filesystem::path> CreateTemporaryDirectory() {
   return std::filesystem::path(target_dir);
 }
 
+absl::StatusOr<MappedFile> MappedFile::Open(
+    const std::filesystem::path &path) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return absl::NotFoundError(absl::StrFormat("Unable to open file `%s`: %s",
+                                               path, strerror(errno)));
+  }
+  struct stat file_status;
+  if (::fstat(fd, &file_status) != 0) {
+    int fstat_errno = errno;
+    ::close(fd);
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "Unable to stat file `%s`: %s", path, strerror(fstat_errno)));
+  }
+  size_t size = file_status.st_size;
+  if (size == 0) {
+    ::close(fd);
+    return MappedFile(nullptr, 0);
+  }
+  void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  int mmap_errno = errno;
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return absl::FailedPreconditionError(absl::StrFormat(
+        "Unable to map file `%s`: %s", path, strerror(mmap_errno)));
+  }
+  return MappedFile(data, size);
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) ::munmap(data_, size_);
+}
+
 }  // namespace raksha::common::utils
@@ -17,14 +17,50 @@
 #ifndef SRC_COMMON_UTILS_FILESYSTEM_H_
 #define SRC_COMMON_UTILS_FILESYSTEM_H_
 
+#include <cstddef>
 #include <filesystem>
+#include <utility>
 
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 
 namespace raksha::common::utils {
 
 absl::StatusOr<std::filesystem::path> CreateTemporaryDirectory();
 
+// A read-only view of the contents of a file, which maps the file into memory
+// rather than copying it. The contents stay valid for the lifetime of the
+// `MappedFile`, even if the file is removed.
+class MappedFile {
+ public:
+  static absl::StatusOr<MappedFile> Open(const std::filesystem::path &path);
+
+  MappedFile(MappedFile &&other)
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+  MappedFile &operator=(MappedFile &&other) {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile();
+
+  absl::string_view contents() const {
+    return absl::string_view(static_cast<const char *>(data_), size_);
+  }
+
+ private:
+  MappedFile(void *data, size_t size) : data_(data), size_(size) {}
+
+  // The mapping, or nullptr if the file is empty, as empty files cannot be
+  // mapped.
+  void *data_;
+  size_t size_;
+};
+
 }  // namespace raksha::common::utils
 
 #endif  // SRC_COMMON_UTILS_FILESYSTEM_H_
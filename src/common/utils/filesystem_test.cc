@@ -16,6 +16,9 @@
 
 #include "src/common/utils/filesystem.h"
 
+#include <fstream>
+#include <string>
+
 #include "src/common/testing/gtest.h"
 
 namespace raksha::common::utils {
@@ -38,4 +41,30 @@ TEST(CreateTemporaryDirectoryTest, CreateTemporaryDirectoryTest) {
   std::filesystem::remove_all(temp_dir2);
 }
 
+TEST(MappedFileTest, ContentsMatchTheFile) {
+  absl::StatusOr<std::filesystem::path> temp_dir = CreateTemporaryDirectory();
+  ASSERT_TRUE(temp_dir.ok());
+  const std::string kContents("some\0binary\ncontents", 21);
+  std::filesystem::path path = *temp_dir / "file";
+  std::filesystem::path empty_path = *temp_dir / "empty";
+  std::ofstream(path, std::ios::binary) << kContents;
+  std::ofstream(empty_path, std::ios::binary).close();
+
+  absl::StatusOr<MappedFile> mapped_file = MappedFile::Open(path);
+  ASSERT_TRUE(mapped_file.ok()) << mapped_file.status();
+  absl::StatusOr<MappedFile> mapped_empty_file = MappedFile::Open(empty_path);
+  ASSERT_TRUE(mapped_empty_file.ok()) << mapped_empty_file.status();
+  std::filesystem::remove_all(*temp_dir);
+
+  EXPECT_EQ(mapped_file->contents(), kContents);
+  EXPECT_EQ(mapped_empty_file->contents(), "");
+  MappedFile moved_file = *std::move(mapped_file);
+  EXPECT_EQ(moved_file.contents(), kContents);
+  EXPECT_EQ(mapped_file->contents(), "");
+}
+
+TEST(MappedFileTest, MissingFileIsAnError) {
+  EXPECT_FALSE(MappedFile::Open("/this/file/does/not/exist").ok());
+}
+
 }  // namespace raksha::common::utils
@@ -25,6 +25,7 @@
 #include "absl/strings/match.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "src/backends/policy_engine/souffle/souffle_program_pool.h"
 #include "src/common/logging/logging.h"
 #include "src/common/utils/iterator_range.h"
 
@@ -150,6 +151,14 @@ void UpdateSettings(const souffle::SouffleProgram *program,
 
 }  // namespace
 
+PolicyChecker::SouffleProgramPool &PolicyChecker::GetProgramPool() {
+  static auto *const kProgramPool = new SouffleProgramPool([]() {
+    return std::unique_ptr<souffle::SouffleProgram>(
+        souffle::ProgramFactory::newInstance(kPolicyCheckerProgramName));
+  });
+  return *kProgramPool;
+}
+
 bool PolicyChecker::CanUserChangeSetting(PolicyChecker::User user,
                                          PolicyChecker::Settings setting) {
   return CanUserChangeSetting(GetUserName(user), GetSettingsName(setting));
@@ -157,8 +166,7 @@ bool PolicyChecker::CanUserChangeSetting(PolicyChecker::User user,
 
 bool PolicyChecker::CanUserChangeSetting(absl::string_view user,
                                          absl::string_view setting_name) {
-  std::unique_ptr<souffle::SouffleProgram> program(ABSL_DIE_IF_NULL(
-      souffle::ProgramFactory::newInstance(kPolicyCheckerProgramName)));
+  SouffleProgramPool::Lease program = GetProgramPool().Acquire();
   program->run();
 
   // .decl says_canSay_isEnabled(speaker: Principal, delegatee1: Principal,
@@ -189,8 +197,7 @@ absl::flat_hash_set<PolicyChecker::Settings> PolicyChecker::AvailableSettings(
 absl::flat_hash_set<std::string> PolicyChecker::AvailableSettings(
     absl::string_view user) const {
   absl::flat_hash_set<std::string> result;
-  std::unique_ptr<souffle::SouffleProgram> program(ABSL_DIE_IF_NULL(
-      souffle::ProgramFactory::newInstance(kPolicyCheckerProgramName)));
+  SouffleProgramPool::Lease program = GetProgramPool().Acquire();
   program->run();
 
   // .decl says_canSay_isEnabled(speaker: Principal, delegatee1: Principal,
@@ -252,8 +259,7 @@ std::pair<bool, std::string> PolicyChecker::IsValidEdge(absl::string_view src,
 }
 
 std::pair<bool, std::string> PolicyChecker::ValidatePolicyCompliance() const {
-  std::unique_ptr<souffle::SouffleProgram> program(ABSL_DIE_IF_NULL(
-      souffle::ProgramFactory::newInstance(kPolicyCheckerProgramName)));
+  SouffleProgramPool::Lease program = GetProgramPool().Acquire();
 
   UpdateEdges(program.get(), utils::make_range(edges_.begin(), edges_.end()));
   UpdateSettings(program.get(), utils::make_range(user_settings_.begin(),
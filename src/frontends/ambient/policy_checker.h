@@ -26,6 +26,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
+#include "src/backends/policy_engine/souffle/souffle_program_pool.h"
 
 namespace raksha::ambient {
 
@@ -79,6 +80,13 @@ class PolicyChecker {
       User user) const;
 
  private:
+  using SouffleProgramPool =
+      ::raksha::backends::policy_engine::souffle::SouffleProgramPool;
+
+  // All policy checkers run the same program, so they share a single pool of
+  // instances of it instead of building a new instance for every query.
+  static SouffleProgramPool &GetProgramPool();
+
   // Check and add if the given edge can be added safely to the policy context.
   std::pair<bool, std::string> AddIfValidEdge(absl::string_view src,
                                               absl::string_view tgt);
@@ -16,6 +16,9 @@
 
 #include "src/frontends/sql/driver.h"
 
+#include <memory>
+#include <vector>
+
 #include "src/backends/policy_engine/policy.h"
 #include "src/backends/policy_engine/souffle/souffle_policy_checker.h"
 #include "src/frontends/sql/decode.h"
@@ -23,6 +26,14 @@
 
 namespace raksha::frontends::sql {
 
+// The checker is kept across calls so that it can reuse the Souffle programs it
+// has built.
+static const backends::policy_engine::SoufflePolicyChecker &GetPolicyChecker() {
+  static const auto *const kPolicyChecker =
+      new backends::policy_engine::SoufflePolicyChecker();
+  return *kPolicyChecker;
+}
+
 bool verify(const ExpressionArena &arena,
             const backends::policy_engine::Policy &policy) {
   ir::IRContext ir_context;
@@ -30,8 +41,25 @@ bool verify(const ExpressionArena &arena,
   DecodeExpressionArena(arena, decoder_context);
   decoder_context.BuildTopLevelBlock();
   const ir::Module &module = decoder_context.global_module();
-  return backends::policy_engine::SoufflePolicyChecker()
-      .IsModulePolicyCompliant(module, policy);
+  return GetPolicyChecker().IsModulePolicyCompliant(module, policy);
+}
+
+std::vector<bool> verifyAll(absl::Span<const ExpressionArena *const> arenas,
+                            const backends::policy_engine::Policy &policy) {
+  // Each decoder context refers to its IR context, so the decoder contexts
+  // are declared last to be destroyed first.
+  std::vector<std::unique_ptr<ir::IRContext>> ir_contexts;
+  std::vector<std::unique_ptr<DecoderContext>> decoder_contexts;
+  std::vector<const ir::Module *> modules;
+  for (const ExpressionArena *arena : arenas) {
+    ir_contexts.push_back(std::make_unique<ir::IRContext>());
+    decoder_contexts.push_back(
+        std::make_unique<DecoderContext>(*ir_contexts.back()));
+    DecodeExpressionArena(*arena, *decoder_contexts.back());
+    decoder_contexts.back()->BuildTopLevelBlock();
+    modules.push_back(&decoder_contexts.back()->global_module());
+  }
+  return GetPolicyChecker().AreModulesPolicyCompliant(modules, policy);
 }
 
 }  // namespace raksha::frontends::sql
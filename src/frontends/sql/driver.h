@@ -19,6 +19,9 @@
 
 #include <filesystem>
 #include <optional>
+#include <vector>
+
+#include "absl/types/span.h"
 
 #include "src/backends/policy_engine/policy.h"
 #include "src/frontends/sql/sql_ir.pb.h"
@@ -30,6 +33,12 @@ namespace raksha::frontends::sql {
 bool verify(const ExpressionArena &arena,
             const backends::policy_engine::Policy &policy);
 
+// Verifies many expression arenas against the same policy at once, which is
+// considerably cheaper than calling `verify` on each of them. Returns the
+// result of verifying each arena.
+std::vector<bool> verifyAll(absl::Span<const ExpressionArena *const> arenas,
+                            const backends::policy_engine::Policy &policy);
+
 }  // namespace raksha::frontends::sql
 
 #endif  // SRC_FRONTENDS_SQL_DRIVER_H_
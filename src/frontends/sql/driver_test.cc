@@ -55,4 +55,24 @@ id_expression_pairs: [
                      backends::policy_engine::SqlPolicyRulePolicy("")));
 }
 
+TEST(VerifyAllTest, VerifiesEachArena) {
+  ExpressionArena passing_arena;
+  EXPECT_TRUE(google::protobuf::TextFormat::ParseFromString(
+      R"(id_expression_pairs: [ { id: 1 expression: { literal: { literal_str: "hello" } } } ])",
+      &passing_arena));
+  ExpressionArena failing_arena;
+  EXPECT_TRUE(google::protobuf::TextFormat::ParseFromString(
+      R"(
+id_expression_pairs: [
+  { id: 1 expression: { literal: { literal_str: "hello" } } },
+  { id: 2 expression: { tag_transform: { transform_rule_name: "add_tag" transformed_node: 1 } } } ])",
+      &failing_arena));
+
+  EXPECT_THAT(
+      verifyAll({&passing_arena, &failing_arena, &passing_arena},
+                backends::policy_engine::SqlPolicyRulePolicy(
+                    R"(["add_tag", $AddConfidentialityTag("tag"), nil])")),
+      testing::ElementsAre(true, false, true));
+}
+
 }  // namespace raksha::frontends::sql
@@ -68,7 +68,7 @@ ir::Value TagTransformOp::GetTransformedValue() const {
 absl::flat_hash_map<std::string, ir::Value> TagTransformOp::GetPreconditions()
     const {
   absl::flat_hash_map<std::string, ir::Value> result;
-  const ir::ValueList& input_values = inputs();
+  const ir::OperationInputs& input_values = inputs();
   for (const auto& [name, attribute] : attributes()) {
     if (name == kRuleNameAttribute) continue;
     auto int_attribute =
@@ -88,7 +88,7 @@ absl::flat_hash_map<std::string, ir::Value> TagTransformOp::GetPreconditions()
 absl::flat_hash_map<std::string, uint64_t>
 TagTransformOp::GetPreconditionInputIndices() const {
   absl::flat_hash_map<std::string, uint64_t> result;
-  const ir::ValueList& input_values = inputs();
+  const ir::OperationInputs& input_values = inputs();
   for (const auto& [name, attribute] : attributes()) {
     if (name == kRuleNameAttribute) continue;
     auto int_attribute =
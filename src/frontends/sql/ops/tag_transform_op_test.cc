@@ -55,7 +55,7 @@ TEST_P(TagTransformOpTest, TestSomething) {
   EXPECT_EQ(tag_transform_op->op().name(), OpTraits<TagTransformOp>::kName);
   EXPECT_EQ(tag_transform_op->parent(), parent_block);
 
-  const ir::ValueList& inputs = tag_transform_op->inputs();
+  const ir::OperationInputs& inputs = tag_transform_op->inputs();
   EXPECT_EQ(inputs.size(), preconditions.size() + 1);
   ASSERT_GT(inputs.size(), 0);
   EXPECT_EQ(inputs.front(), xformed_value)
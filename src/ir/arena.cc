@@ -0,0 +1,51 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/ir/arena.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace raksha::ir {
+
+namespace {
+
+constexpr size_t kAlignment = alignof(std::max_align_t);
+
+}  // namespace
+
+void* Arena::Allocate(size_t size) {
+  // Keep the next allocation aligned.
+  size = (size + kAlignment - 1) / kAlignment * kAlignment;
+  if (size > remaining_) {
+    // Chunks double in size up to a limit. Larger requests get a chunk of
+    // their own.
+    size_t chunk_size = std::max(
+        size, std::min(kInitialChunkSize << std::min<size_t>(chunks_.size(), 8),
+                       kMaxChunkSize));
+    // `new[]` memory is aligned for any scalar type. It is deliberately left
+    // uninitialized.
+    chunks_.push_back(std::unique_ptr<std::byte[]>(new std::byte[chunk_size]));
+    next_ = chunks_.back().get();
+    remaining_ = chunk_size;
+  }
+  void* result = next_;
+  next_ += size;
+  remaining_ -= size;
+  bytes_allocated_ += size;
+  return result;
+}
+
+}  // namespace raksha::ir
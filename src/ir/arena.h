@@ -0,0 +1,119 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#ifndef SRC_IR_ARENA_H_
+#define SRC_IR_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "src/common/utils/intrusive_ptr.h"
+#include "src/common/utils/ref_counted.h"
+
+namespace raksha::ir {
+
+class Arena;
+using ArenaPtr = intrusive_ptr<Arena>;
+
+// A bump allocator for IR nodes. Memory is handed out from large chunks and
+// is only released, all at once, when the arena is destroyed.
+//
+// An arena is shared by the `Module` that uses it and by the `BlockBuilder`s
+// that build blocks for that module, so that it outlives every node allocated
+// in it. This class is not thread-safe.
+class Arena : public RefCounted<Arena> {
+ public:
+  static ArenaPtr Create() { return make_intrusive_ptr<Arena>(); }
+
+  // Returns `size` bytes of memory that is aligned for any scalar type.
+  void* Allocate(size_t size);
+
+  // Returns the total number of bytes handed out by `Allocate`.
+  size_t bytes_allocated() const { return bytes_allocated_; }
+
+ private:
+  friend class intrusive_ptr<Arena>;
+
+  static constexpr size_t kInitialChunkSize = 64 * 1024;
+  static constexpr size_t kMaxChunkSize = 16 * 1024 * 1024;
+
+  Arena() : next_(nullptr), remaining_(0), bytes_allocated_(0) {}
+
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;
+  std::byte* next_;
+  size_t remaining_;
+  size_t bytes_allocated_;
+};
+
+// The deleter of a `std::unique_ptr` to an IR node that may have been
+// allocated in an arena. Nodes on the heap are deleted. Nodes in an arena are
+// only destroyed; their memory is released with the arena. The deleter, and so
+// the owning pointer, records which is the case, which keeps the nodes free of
+// any bookkeeping of their own.
+template <typename T>
+class ArenaDeleter {
+ public:
+  ArenaDeleter() = default;
+  explicit ArenaDeleter(Arena* arena) : arena_(arena) {}
+  // Allows taking over nodes from plain `std::unique_ptr`s, which own nodes
+  // on the heap.
+  template <typename U,
+            std::enable_if_t<std::is_convertible_v<U*, T*>, bool> = true>
+  ArenaDeleter(const std::default_delete<U>&) {}
+  template <typename U,
+            std::enable_if_t<std::is_convertible_v<U*, T*>, bool> = true>
+  ArenaDeleter(const ArenaDeleter<U>& other) : arena_(other.arena()) {}
+
+  void operator()(T* object) const {
+    if (arena_ == nullptr) {
+      delete object;
+    } else {
+      object->~T();
+    }
+  }
+
+  // Returns the arena in which the node was allocated, or nullptr if it was
+  // allocated on the heap.
+  Arena* arena() const { return arena_; }
+
+ private:
+  Arena* arena_ = nullptr;
+};
+
+// An owning pointer to an IR node that may have been allocated in an arena.
+template <typename T>
+using ArenaUniquePtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+// Returns a new `T` that is allocated in `arena`, or on the heap if `arena` is
+// nullptr.
+template <typename T, typename... Args>
+ArenaUniquePtr<T> MakeUniqueInArena(Arena* arena, Args&&... args) {
+  if (arena == nullptr) {
+    return ArenaUniquePtr<T>(new T(std::forward<Args>(args)...));
+  }
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "Arena allocations are only aligned for scalar types.");
+  void* memory = arena->Allocate(sizeof(T));
+  return ArenaUniquePtr<T>(new (memory) T(std::forward<Args>(args)...),
+                           ArenaDeleter<T>(arena));
+}
+
+}  // namespace raksha::ir
+
+#endif  // SRC_IR_ARENA_H_
@@ -0,0 +1,118 @@
+//-----------------------------------------------------------------------------
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/ir/arena.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "src/common/testing/gtest.h"
+#include "src/ir/block_builder.h"
+#include "src/ir/ir_context.h"
+#include "src/ir/module.h"
+
+namespace raksha::ir {
+namespace {
+
+TEST(ArenaTest, AllocationsAreAligned) {
+  ArenaPtr arena = Arena::Create();
+  for (size_t size : {1, 3, 8, 17, 100, 1 << 20}) {
+    void* memory = arena->Allocate(size);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(memory) % alignof(std::max_align_t),
+              0);
+  }
+}
+
+TEST(ArenaTest, BytesAllocatedCountsAlignedSizes) {
+  ArenaPtr arena = Arena::Create();
+  EXPECT_EQ(arena->bytes_allocated(), 0);
+  arena->Allocate(1);
+  EXPECT_EQ(arena->bytes_allocated(), alignof(std::max_align_t));
+}
+
+TEST(ArenaTest, DeleterRecordsTheArenaOfTheAllocation) {
+  IRContext context;
+  const Operator& op = context.RegisterOperator(Operator("core.plus"));
+  ArenaPtr arena = Arena::Create();
+  ArenaUniquePtr<Operation> heap_operation = MakeUniqueInArena<Operation>(
+      nullptr, nullptr, op, NamedAttributeMap(), ValueList());
+  ArenaUniquePtr<Operation> arena_operation = MakeUniqueInArena<Operation>(
+      arena.get(), nullptr, op, NamedAttributeMap(), ValueList());
+  EXPECT_EQ(heap_operation.get_deleter().arena(), nullptr);
+  EXPECT_EQ(arena_operation.get_deleter().arena(), arena.get());
+}
+
+TEST(ArenaTest, HeapNodesTakeNoMemoryFromTheArena) {
+  IRContext context;
+  const Operator& op = context.RegisterOperator(Operator("core.plus"));
+  ArenaPtr arena = Arena::Create();
+  BlockBuilder builder(arena);
+  // Operations from plain `std::unique_ptr`s are on the heap and stay there.
+  builder.AddOperation(
+      std::make_unique<Operation>(op, NamedAttributeMap(), ValueList()));
+  size_t bytes_allocated = arena->bytes_allocated();
+  Module module(arena);
+  const Block& block = module.AddBlock(builder.build());
+  EXPECT_EQ(block.operations().front().get_deleter().arena(), nullptr);
+  EXPECT_EQ(arena->bytes_allocated(), bytes_allocated);
+}
+
+TEST(ArenaTest, BuildsModuleInArena) {
+  IRContext context;
+  const Operator& op = context.RegisterOperator(Operator("core.plus"));
+  ArenaPtr arena = Arena::Create();
+  Module module(arena);
+  BlockBuilder builder(arena);
+  const Operation& first =
+      builder.AddOperation(op, NamedAttributeMap(), ValueList());
+  const Operation& second = builder.AddOperation(
+      op, NamedAttributeMap(), {Value(value::OperationResult(first, 0))});
+  const Block& block = module.AddBlock(builder.build());
+
+  EXPECT_EQ(module.blocks().front().get_deleter().arena(), arena.get());
+  for (const ArenaUniquePtr<Operation>& operation : block.operations()) {
+    EXPECT_EQ(operation.get_deleter().arena(), arena.get());
+  }
+  EXPECT_EQ(first.parent(), &block);
+  EXPECT_EQ(second.parent(), &block);
+  EXPECT_EQ(block.parent_module(), &module);
+  EXPECT_GT(arena->bytes_allocated(), 0);
+
+  // The module keeps the arena alive after the other references are gone.
+  arena = nullptr;
+  Module moved = std::move(module);
+  EXPECT_EQ(moved.blocks().size(), 1);
+  EXPECT_EQ(moved.blocks().front()->operations().size(), 2);
+}
+
+TEST(ArenaDeathTest, RejectsBlockFromDifferentArena) {
+  Module module(Arena::Create());
+  BlockBuilder builder(Arena::Create());
+  EXPECT_DEATH(module.AddBlock(builder.build()), "different arena");
+}
+
+TEST(ArenaDeathTest, RejectsOperationFromDifferentArena) {
+  IRContext context;
+  const Operator& op = context.RegisterOperator(Operator("core.plus"));
+  ArenaPtr arena = Arena::Create();
+  BlockBuilder builder(Arena::Create());
+  EXPECT_DEATH(builder.AddOperation(MakeUniqueInArena<Operation>(
+                   arena.get(), nullptr, op, NamedAttributeMap(), ValueList())),
+               "different arena");
+}
+
+}  // namespace
+}  // namespace raksha::ir
@@ -16,7 +16,12 @@
 #ifndef SRC_IR_ATTRIBUTES_ATTRIBUTE_H_
 #define SRC_IR_ATTRIBUTES_ATTRIBUTE_H_
 
-#include "absl/container/flat_hash_map.h"
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "src/common/utils/intrusive_ptr.h"
@@ -92,7 +97,80 @@ inline bool operator==(const Attribute& lhs, const Attribute& rhs) {
   return lhs.value_->IsEqual(*rhs.value_);
 }
 
-using NamedAttributeMap = absl::flat_hash_map<std::string, Attribute>;
+// The named attributes of an operation, kept sorted by name in a small array.
+// Operations have only a few attributes, so a sorted array is smaller than a
+// hash map and is searched just as fast; up to `kInlineAttributes` of them are
+// stored inside the map itself, and so inside their operation. The interface
+// is the part of a map's that the IR needs. Attributes are iterated in name
+// order and cannot be changed in place.
+class NamedAttributeMap {
+ public:
+  static constexpr size_t kInlineAttributes = 2;
+
+  using key_type = std::string;
+  using mapped_type = Attribute;
+  using value_type = std::pair<std::string, Attribute>;
+  using size_type = size_t;
+  using const_iterator = const value_type*;
+  using iterator = const_iterator;
+
+  NamedAttributeMap() = default;
+  NamedAttributeMap(std::initializer_list<value_type> attributes) {
+    for (const value_type& attribute : attributes) insert(attribute);
+  }
+
+  const_iterator begin() const { return attributes_.data(); }
+  const_iterator end() const { return begin() + attributes_.size(); }
+  size_t size() const { return attributes_.size(); }
+  bool empty() const { return attributes_.empty(); }
+
+  // Returns the attribute with the given name, or `end()` if there is none.
+  const_iterator find(absl::string_view name) const {
+    const_iterator position = LowerBound(name);
+    return (position != end() && position->first == name) ? position : end();
+  }
+
+  bool contains(absl::string_view name) const { return find(name) != end(); }
+
+  // Adds `attribute` unless there is already an attribute with its name.
+  // Returns the attribute with that name and whether it was added.
+  std::pair<const_iterator, bool> insert(value_type attribute) {
+    const_iterator position = LowerBound(attribute.first);
+    if (position != end() && position->first == attribute.first) {
+      return {position, false};
+    }
+    auto inserted = attributes_.insert(
+        attributes_.begin() + (position - begin()), std::move(attribute));
+    return {&*inserted, true};
+  }
+
+  std::pair<const_iterator, bool> emplace(std::string name,
+                                          Attribute attribute) {
+    return insert({std::move(name), std::move(attribute)});
+  }
+
+  // As the attributes are sorted, maps with the same attributes have them in
+  // the same order.
+  friend bool operator==(const NamedAttributeMap& lhs,
+                         const NamedAttributeMap& rhs) {
+    return lhs.attributes_ == rhs.attributes_;
+  }
+  friend bool operator!=(const NamedAttributeMap& lhs,
+                         const NamedAttributeMap& rhs) {
+    return !(lhs == rhs);
+  }
+
+ private:
+  const_iterator LowerBound(absl::string_view name) const {
+    return std::lower_bound(begin(), end(), name,
+                            [](const value_type& attribute,
+                               absl::string_view name) {
+                              return attribute.first < name;
+                            });
+  }
+
+  absl::InlinedVector<value_type, kInlineAttributes> attributes_;
+};
 
 }  // namespace raksha::ir
 
@@ -15,6 +15,7 @@
 //----------------------------------------------------------------------------
 #include "src/ir/attributes/attribute.h"
 
+#include "absl/strings/str_format.h"
 #include "src/common/testing/gtest.h"
 #include "src/common/utils/intrusive_ptr.h"
 #include "src/ir/attributes/float_attribute.h"
@@ -112,5 +113,63 @@ TEST(AttributeAsMethodTest, IncorrectTypeReturnsNullptrIntIsNotString) {
   EXPECT_EQ(int_attribute.GetIf<StringAttribute>(), nullptr);
 }
 
+TEST(NamedAttributeMapTest, IteratesInNameOrder) {
+  Attribute one = Attribute::Create<Int64Attribute>(1);
+  Attribute two = Attribute::Create<Int64Attribute>(2);
+  Attribute three = Attribute::Create<Int64Attribute>(3);
+  NamedAttributeMap attributes({{"c", three}, {"a", one}});
+  attributes.insert({"b", two});
+  EXPECT_THAT(attributes,
+              testing::ElementsAre(testing::Pair("a", one),
+                                   testing::Pair("b", two),
+                                   testing::Pair("c", three)));
+}
+
+TEST(NamedAttributeMapTest, FindsAttributesByName) {
+  Attribute one = Attribute::Create<Int64Attribute>(1);
+  Attribute two = Attribute::Create<StringAttribute>("two");
+  NamedAttributeMap attributes({{"one", one}, {"two", two}});
+  ASSERT_NE(attributes.find("two"), attributes.end());
+  EXPECT_EQ(attributes.find("two")->second, two);
+  EXPECT_EQ(attributes.find("three"), attributes.end());
+  EXPECT_TRUE(attributes.contains("one"));
+  EXPECT_FALSE(attributes.contains("on"));
+}
+
+TEST(NamedAttributeMapTest, InsertKeepsExistingAttribute) {
+  Attribute one = Attribute::Create<Int64Attribute>(1);
+  Attribute two = Attribute::Create<Int64Attribute>(2);
+  NamedAttributeMap attributes;
+  EXPECT_TRUE(attributes.insert({"x", one}).second);
+  auto [existing, inserted] = attributes.emplace("x", two);
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(existing->second, one);
+  EXPECT_EQ(attributes.size(), 1);
+}
+
+TEST(NamedAttributeMapTest, EqualityDoesNotDependOnInsertionOrder) {
+  Attribute one = Attribute::Create<Int64Attribute>(1);
+  Attribute two = Attribute::Create<Int64Attribute>(2);
+  NamedAttributeMap attributes({{"a", one}, {"b", two}});
+  EXPECT_EQ(attributes, NamedAttributeMap({{"b", two}, {"a", one}}));
+  EXPECT_NE(attributes, NamedAttributeMap({{"a", two}, {"b", one}}));
+  EXPECT_NE(attributes, NamedAttributeMap({{"a", one}}));
+}
+
+TEST(NamedAttributeMapTest, HoldsManyAttributes) {
+  NamedAttributeMap attributes;
+  for (int64_t i = 99; i >= 0; --i) {
+    attributes.insert(
+        {absl::StrFormat("attr%03d", i), Attribute::Create<Int64Attribute>(i)});
+  }
+  ASSERT_EQ(attributes.size(), 100);
+  int64_t expected = 0;
+  for (const auto& [name, attribute] : attributes) {
+    EXPECT_EQ(name, absl::StrFormat("attr%03d", expected));
+    EXPECT_EQ(attribute.GetIf<Int64Attribute>()->value(), expected);
+    ++expected;
+  }
+}
+
 }  // namespace
 }  // namespace raksha::ir
@@ -16,6 +16,7 @@
 #ifndef SRC_IR_ATTRIBUTES_STRING_ATTRIBUTE_H_
 #define SRC_IR_ATTRIBUTES_STRING_ATTRIBUTE_H_
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "src/common/utils/intrusive_ptr.h"
 #include "src/ir/attributes/attribute.h"
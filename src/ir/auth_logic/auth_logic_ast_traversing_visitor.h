@@ -20,7 +20,6 @@
 
 #include "src/common/logging/logging.h"
 #include "src/common/utils/fold.h"
-#include "src/common/utils/overloaded.h"
 #include "src/common/utils/types.h"
 #include "src/ir/auth_logic/ast.h"
 #include "src/ir/auth_logic/auth_logic_ast_visitor.h"
@@ -34,6 +33,13 @@ namespace raksha::ir::auth_logic {
 // A visitor that also traverses the children of a node and allows performing
 // different actions before (PreVisit) and after (PostVisit) the children are
 // visited. Override any of the `PreVisit` and `PostVisit` methods as needed.
+//
+// The results of the children of a node are combined with `CombineResult`,
+// which suits results that are cheap to build and to merge. A visitor that
+// collects a container from the whole program should instead accumulate it:
+// use `Unit` as the `Result` and add to a container that is a member of the
+// visitor from its `PreVisit`, `PostVisit` or `Visit` methods. Such a
+// traversal builds a single container rather than one for every node.
 template <typename Derived, typename Result = Unit,
           AstNodeMutability IsConst = AstNodeMutability::Immutable>
 class AuthLogicAstTraversingVisitor
@@ -196,21 +202,14 @@ class AuthLogicAstTraversingVisitor
     // by the order of evaluation of arguments to CombineResult.
     Result fold_result = CombineResult(
         CombineResult(std::move(pre_visit_result), std::move(left_result)),
-        right_result);
+        std::move(right_result));
     return PostVisit(can_act_as, std::move(fold_result));
   }
 
   Result Visit(CopyConst<IsConst, BaseFact>& base_fact) final override {
     Result pre_visit_result = PreVisit(base_fact);
     Result variant_visit_result = std::visit(
-        raksha::utils::overloaded{
-            [this](const datalog::Predicate& pred) {
-              return VariantVisit(pred);
-            },
-            [this](const Attribute& attrib) { return VariantVisit(attrib); },
-            [this](const CanActAs& can_act_as) {
-              return VariantVisit(can_act_as);
-            }},
+        [this](auto& value) { return VariantVisit(value); },
         base_fact.GetValue());
     Result fold_result = CombineResult(std::move(pre_visit_result),
                                        std::move(variant_visit_result));
@@ -220,7 +219,7 @@ class AuthLogicAstTraversingVisitor
   Result Visit(CopyConst<IsConst, Fact>& fact) final override {
     Result pre_visit_result = PreVisit(fact);
     Result deleg_result = FoldAccept<Principal, std::forward_list<Principal>>(
-        fact.delegation_chain(), pre_visit_result);
+        fact.delegation_chain(), std::move(pre_visit_result));
     Result base_fact_result =
         CombineResult(std::move(deleg_result), fact.base_fact().Accept(*this));
     return PostVisit(fact, std::move(base_fact_result));
@@ -232,18 +231,14 @@ class AuthLogicAstTraversingVisitor
     Result lhs_result = CombineResult(
         std::move(pre_visit_result), conditional_assertion.lhs().Accept(*this));
     Result fold_result = FoldAccept<BaseFact, std::vector<BaseFact>>(
-        conditional_assertion.rhs(), lhs_result);
+        conditional_assertion.rhs(), std::move(lhs_result));
     return PostVisit(conditional_assertion, std::move(fold_result));
   }
 
   Result Visit(CopyConst<IsConst, Assertion>& assertion) final override {
     Result pre_visit_result = PreVisit(assertion);
     Result variant_visit_result =
-        std::visit(raksha::utils::overloaded{
-                       [this](const Fact& fact) { return VariantVisit(fact); },
-                       [this](const ConditionalAssertion& cond_assertion) {
-                         return VariantVisit(cond_assertion);
-                       }},
+        std::visit([this](auto& value) { return VariantVisit(value); },
                    assertion.GetValue());
     Result fold_result = CombineResult(std::move(pre_visit_result),
                                        std::move(variant_visit_result));
@@ -256,8 +251,8 @@ class AuthLogicAstTraversingVisitor
     Result principal_result = CombineResult(
         std::move(pre_visit_result), says_assertion.principal().Accept(*this));
     Result fold_result = FoldAccept<Assertion, std::vector<Assertion>>(
-        says_assertion.assertions(), principal_result);
-    return PostVisit(says_assertion, fold_result);
+        says_assertion.assertions(), std::move(principal_result));
+    return PostVisit(says_assertion, std::move(fold_result));
   }
 
   Result Visit(CopyConst<IsConst, Query>& query) final override {
@@ -269,14 +264,14 @@ class AuthLogicAstTraversingVisitor
     Result fold_result = CombineResult(
         std::move(pre_visit_result),
         CombineResult(std::move(principal_result), std::move(fact_result)));
-    return PostVisit(query, fold_result);
+    return PostVisit(query, std::move(fold_result));
   }
 
   Result Visit(CopyConst<IsConst, Program>& program) final override {
     Result pre_visit_result = PreVisit(program);
     Result declarations_result = common::utils::fold(
         program.relation_declarations(), std::move(pre_visit_result),
-        [this](Result acc, CopyConst<IsConst, datalog::RelationDeclaration>
+        [this](Result acc, CopyConst<IsConst, datalog::RelationDeclaration>&
                                relation_declaration) {
           // TODO(#644 aferr) Fix this to accept once once relationDeclaration
           // has been refactored into ast.h
@@ -284,36 +279,44 @@ class AuthLogicAstTraversingVisitor
         });
     Result says_assertions_result =
         FoldAccept<SaysAssertion, std::vector<SaysAssertion>>(
-            program.says_assertions(), declarations_result);
+            program.says_assertions(), std::move(declarations_result));
     Result queries_result = FoldAccept<Query, std::vector<Query>>(
-        program.queries(), says_assertions_result);
-    return PostVisit(program, queries_result);
+        program.queries(), std::move(says_assertions_result));
+    return PostVisit(program, std::move(queries_result));
   }
 
   // The VariantVisit methods use overloading to help visit
-  // the alternatives for the underlying std::variants in the AST
+  // the alternatives for the underlying std::variants in the AST. They take
+  // the alternatives by reference, so that visiting does not copy the AST.
 
   // For BaseFactVariantType
-  Result VariantVisit(datalog::Predicate predicate) {
+  Result VariantVisit(CopyConst<IsConst, datalog::Predicate>& predicate) {
     // TODO(#644 aferr) once a separate predicate has been added to ast.h
     // this should use predicate.Accept(*this);
     return Visit(predicate);
   }
-  Result VariantVisit(Attribute attribute) { return attribute.Accept(*this); }
-  Result VariantVisit(CanActAs can_act_as) { return can_act_as.Accept(*this); }
+  Result VariantVisit(CopyConst<IsConst, Attribute>& attribute) {
+    return attribute.Accept(*this);
+  }
+  Result VariantVisit(CopyConst<IsConst, CanActAs>& can_act_as) {
+    return can_act_as.Accept(*this);
+  }
 
   // For AssertionVariantType
-  Result VariantVisit(Fact fact) { return fact.Accept(*this); }
-  Result VariantVisit(ConditionalAssertion conditional_assertion) {
+  Result VariantVisit(CopyConst<IsConst, Fact>& fact) {
+    return fact.Accept(*this);
+  }
+  Result VariantVisit(
+      CopyConst<IsConst, ConditionalAssertion>& conditional_assertion) {
     return conditional_assertion.Accept(*this);
   }
 
  private:
   template <class Element, class Container>
-  Result FoldAccept(Container container, Result initial) {
+  Result FoldAccept(CopyConst<IsConst, Container>& container, Result initial) {
     return common::utils::fold(
         container, std::move(initial),
-        [this](Result acc, CopyConst<IsConst, Element> element) {
+        [this](Result acc, CopyConst<IsConst, Element>& element) {
           return CombineResult(std::move(acc), element.Accept(*this));
         });
   }
@@ -74,6 +74,42 @@ TEST(AuthLogicAstTraversingVisitorTest, PrincipalNameCollectorTest) {
   EXPECT_EQ(result, expected);
 }
 
+// A visitor that accumulates the addresses of the principals in the program
+// instead of combining the results of the children of each node.
+class PrincipalAddressCollectorVisitor
+    : public AuthLogicAstTraversingVisitor<PrincipalAddressCollectorVisitor> {
+ public:
+  Unit PreVisit(const Principal& principal) override {
+    principals_.push_back(&principal);
+    return Unit();
+  }
+
+  const std::vector<const Principal*>& principals() const {
+    return principals_;
+  }
+
+ private:
+  std::vector<const Principal*> principals_;
+};
+
+TEST(AuthLogicAstTraversingVisitorTest, VisitsNodesOfProgramInPlace) {
+  Program test_prog = BuildTestProgram1();
+  PrincipalAddressCollectorVisitor collector_visitor;
+  test_prog.Accept(collector_visitor);
+  const std::vector<SaysAssertion>& says_assertions =
+      test_prog.says_assertions();
+  const CanActAs& can_act_as = std::get<CanActAs>(
+      std::get<Fact>(says_assertions[2].assertions()[0].GetValue())
+          .base_fact()
+          .GetValue());
+  EXPECT_THAT(collector_visitor.principals(),
+              testing::ElementsAre(&says_assertions[0].principal(),
+                                   &says_assertions[1].principal(),
+                                   &says_assertions[2].principal(),
+                                   &can_act_as.left_principal(),
+                                   &can_act_as.right_principal()));
+}
+
 using AstNodeVariantType =
     std::variant<datalog::Predicate, datalog::ArgumentType, datalog::Argument,
                  datalog::RelationDeclaration, Principal, Attribute, CanActAs,
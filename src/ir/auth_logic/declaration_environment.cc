@@ -16,6 +16,8 @@
 
 #include "src/ir/auth_logic/declaration_environment.h"
 
+#include <utility>
+
 namespace raksha::ir::auth_logic {
 
 namespace {
@@ -29,7 +31,7 @@ class RelationDeclarationEnvironmentVisitor
           RelationDeclarationEnvironmentVisitor> {
  public:
   RelationDeclarationEnvironmentVisitor() : decl_map_({}){};
-  DeclarationMapType decl_map() { return decl_map_; }
+  DeclarationMapType& decl_map() { return decl_map_; }
 
  private:
   void AddDeclaration(const datalog::RelationDeclaration& rel_decl) {
@@ -57,10 +59,11 @@ class RelationDeclarationEnvironmentVisitor
 DeclarationEnvironment::DeclarationEnvironment(const Program& prog) {
   RelationDeclarationEnvironmentVisitor rel_visitor;
   prog.Accept(rel_visitor);
-  inner_map_ = rel_visitor.decl_map();
+  inner_map_ = std::move(rel_visitor.decl_map());
 }
 
-datalog::RelationDeclaration DeclarationEnvironment::GetDeclarationOrFatal(
+const datalog::RelationDeclaration&
+DeclarationEnvironment::GetDeclarationOrFatal(
     absl::string_view relation_name) const {
   auto find_result = inner_map_.find(relation_name);
   CHECK(find_result != inner_map_.end())
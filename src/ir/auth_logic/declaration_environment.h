@@ -29,7 +29,7 @@ class DeclarationEnvironment {
  public:
   DeclarationEnvironment(const Program& prog);
 
-  datalog::RelationDeclaration GetDeclarationOrFatal(
+  const datalog::RelationDeclaration& GetDeclarationOrFatal(
       absl::string_view relation_name) const;
 
  private:
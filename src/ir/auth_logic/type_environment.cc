@@ -16,6 +16,8 @@
 
 #include "src/ir/auth_logic/type_environment.h"
 
+#include <utility>
+
 #include "src/ir/auth_logic/is_name_constant.h"
 
 namespace raksha::ir::auth_logic {
@@ -36,16 +38,16 @@ class TypeEnvironmentGenerationVisitor
  public:
   using LiteralTypeMapType =
       absl::flat_hash_map<std::string, datalog::ArgumentType>;
-  TypeEnvironmentGenerationVisitor(DeclarationEnvironment decl_env)
+  TypeEnvironmentGenerationVisitor(const DeclarationEnvironment& decl_env)
       : decl_env_(decl_env), literal_type_map_({}) {}
 
-  LiteralTypeMapType literal_type_map() { return literal_type_map_; }
+  LiteralTypeMapType& literal_type_map() { return literal_type_map_; }
 
  private:
   void AddTyping(absl::string_view arg_name, datalog::ArgumentType arg_type);
   Unit PreVisit(const Principal& principal);
   Unit Visit(const datalog::Predicate& pred);
-  DeclarationEnvironment decl_env_;
+  const DeclarationEnvironment& decl_env_;
   LiteralTypeMapType literal_type_map_;
 };
 
@@ -85,14 +87,14 @@ Unit TypeEnvironmentGenerationVisitor::Visit(const datalog::Predicate& pred) {
   if (pred.IsNumericOperator()) {
     // This is part of the workaround for handling numeric comparisons
     // given that the operators use the same AST nodes as predicates.
-    for (auto arg : pred.args()) {
+    for (const std::string& arg : pred.args()) {
       AddTyping(arg, datalog::ArgumentType::MakeNumberType());
     }
     return Unit();
   } else {
     // This is the case where this is a normal predicate rather
     // than a numeric operator
-    datalog::RelationDeclaration decl =
+    const datalog::RelationDeclaration& decl =
         decl_env_.GetDeclarationOrFatal(pred.name());
     // The relation declarations give the types for each position in the
     // predicate. For the xth argument in the predicate, we want to
@@ -109,11 +111,11 @@ Unit TypeEnvironmentGenerationVisitor::Visit(const datalog::Predicate& pred) {
 
 }  // namespace
 
-TypeEnvironment::TypeEnvironment(DeclarationEnvironment decl_env,
+TypeEnvironment::TypeEnvironment(const DeclarationEnvironment& decl_env,
                                  const Program& prog) {
   TypeEnvironmentGenerationVisitor type_gen_visitor(decl_env);
   prog.Accept(type_gen_visitor);
-  literal_type_map_ = type_gen_visitor.literal_type_map();
+  literal_type_map_ = std::move(type_gen_visitor.literal_type_map());
 }
 
 datalog::ArgumentType TypeEnvironment::GetTypingOrFatal(
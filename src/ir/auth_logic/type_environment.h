@@ -29,7 +29,7 @@ namespace raksha::ir::auth_logic {
 // (the constants wrapped in quotes) to typings.
 class TypeEnvironment {
  public:
-  TypeEnvironment(DeclarationEnvironment decl_env, const Program& prog);
+  TypeEnvironment(const DeclarationEnvironment& decl_env, const Program& prog);
 
   datalog::ArgumentType GetTypingOrFatal(absl::string_view argument_name);
 
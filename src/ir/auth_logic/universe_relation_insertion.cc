@@ -16,6 +16,8 @@
 
 #include "src/ir/auth_logic/universe_relation_insertion.h"
 
+#include <utility>
+
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "src/ir/auth_logic/auth_logic_ast_traversing_visitor.h"
@@ -54,68 +56,81 @@ datalog::RelationDeclaration TypeToUniverseDeclaration(
                                       {datalog::Argument("x", arg_type)});
 }
 
+// The speaker of the rules that share the universes across principals. It is
+// a variable, so these rules apply to every speaker that is a principal.
+constexpr absl::string_view kUniverseSpeaker = "universe_speaker";
+
 // This generates a set of says assertions that populate all the
-// universes for all the speakers given the type environment. Essentially,
-// it loops through the list of constant principals, and then all the
-// constants of all types, and then generates a SaysAssertion that
-// adds the constant to the universe for each speaker.
+// universes for all the speakers given the type environment. Every constant
+// principal first adds itself to its own principal universe:
+//   "P" says isPrincipal("P").
+// Then each constant of each type is added to its universe by a single rule
+// that holds for every speaker that is in its own principal universe:
+//   universe_speaker says isT(c) :- isPrincipal(universe_speaker).
+// This populates the same universes as a fact for each pair of a constant
+// principal and a constant would, but the generated program only grows with
+// the number of constants rather than with the product of these numbers.
 std::vector<SaysAssertion> GetUniverseDefiningFacts(
     const TypeEnvironment& type_env) {
-  std::vector<Principal> constant_principals;
-  for (const auto& typing : type_env.literal_type_map()) {
-    if (typing.second.kind() == datalog::ArgumentType::Kind::kPrincipal) {
-      constant_principals.push_back(Principal(typing.first));
-    }
-  }
-
   std::vector<SaysAssertion> universe_defining_says_assertions;
-  for (const auto& prin : constant_principals) {
-    for (const auto& typing : type_env.literal_type_map()) {
+  for (const auto& [literal, type] : type_env.literal_type_map()) {
+    if (type.kind() == datalog::ArgumentType::Kind::kPrincipal) {
       universe_defining_says_assertions.push_back(SaysAssertion(
-          prin,  // speaker
-          {Assertion(Fact(
-              {}, MakeUniverseMembershipFact(typing.first, typing.second)))}));
+          Principal(literal),  // speaker
+          {Assertion(Fact({}, MakeUniverseMembershipFact(literal, type)))}));
     }
   }
+  // Without any constant principal there is no speaker to share with.
+  if (universe_defining_says_assertions.empty()) return {};
+
+  BaseFact universe_speaker_is_principal = MakeUniverseMembershipFact(
+      kUniverseSpeaker, datalog::ArgumentType::MakePrincipalType());
+  for (const auto& [literal, type] : type_env.literal_type_map()) {
+    universe_defining_says_assertions.push_back(SaysAssertion(
+        Principal(std::string(kUniverseSpeaker)),
+        {Assertion(ConditionalAssertion(
+            Fact({}, MakeUniverseMembershipFact(literal, type)),
+            {universe_speaker_is_principal}))}));
+  }
   return universe_defining_says_assertions;
 }
 
-// This visitor is used only to implement GetUniverseDeclarations
+// This visitor is used only to implement GetUniverseDeclarations. It adds
+// the declarations to a single set as it goes rather than returning a set
+// for every node.
 class UniverseDeclarationGenerationVisitor
     : public AuthLogicAstTraversingVisitor<
-          UniverseDeclarationGenerationVisitor,
-          absl::flat_hash_set<datalog::RelationDeclaration>> {
- private:
+          UniverseDeclarationGenerationVisitor> {
+ public:
   using DeclSet = absl::flat_hash_set<datalog::RelationDeclaration>;
-  DeclSet GetDefaultValue() override { return {}; }
-
-  DeclSet CombineResult(DeclSet left, DeclSet right) override {
-    left.merge(std::move(right));
-    return left;
-  }
+  DeclSet& universe_declarations() { return universe_declarations_; }
 
-  DeclSet Visit(
+ private:
+  Unit Visit(
       const datalog::RelationDeclaration& relation_declaration) override {
-    DeclSet universe_declarations;
     for (const auto& argument : relation_declaration.arguments()) {
-      universe_declarations.insert(
+      universe_declarations_.insert(
           TypeToUniverseDeclaration(argument.argument_type()));
     }
-    return universe_declarations;
+    return Unit();
   }
+
+  DeclSet universe_declarations_;
 };
 
 static absl::flat_hash_set<datalog::RelationDeclaration>
 GetUniverseDeclarations(const Program& prog) {
   UniverseDeclarationGenerationVisitor gen;
-  absl::flat_hash_set<datalog::RelationDeclaration> ret = prog.Accept(gen);
+  prog.Accept(gen);
+  absl::flat_hash_set<datalog::RelationDeclaration> ret =
+      std::move(gen.universe_declarations());
   // It is possible that universes need to be created
   // for numbers and principals even if they are not
   // referenced in relation declarations in the front-end
-  absl::flat_hash_set<datalog::RelationDeclaration> builtin_universes = {
-      TypeToUniverseDeclaration(datalog::ArgumentType::MakeNumberType()),
-      TypeToUniverseDeclaration(datalog::ArgumentType::MakePrincipalType())};
-  ret.merge(builtin_universes);
+  ret.insert(
+      TypeToUniverseDeclaration(datalog::ArgumentType::MakeNumberType()));
+  ret.insert(
+      TypeToUniverseDeclaration(datalog::ArgumentType::MakePrincipalType()));
   return ret;
 }
 
@@ -155,8 +170,7 @@ GetUniverseDeclarations(const Program& prog) {
 //             otherRelation(anyCustom).
 
 class GroundingConditionTransformer
-    : public AuthLogicAstTraversingVisitor<GroundingConditionTransformer,
-                                           std::vector<BaseFact>> {
+    : public AuthLogicAstTraversingVisitor<GroundingConditionTransformer> {
  public:
   GroundingConditionTransformer(const DeclarationEnvironment& decl_env)
       : decl_env_(decl_env) {}
@@ -201,45 +215,39 @@ class GroundingConditionTransformer
   // returns a vector of conditions that should be added to the RHS of that
   // assertion. This method is where this class is actually used as a visitor.
   // The visitor works only on subtrees of the AST that are
-  // these BaseFacts on the LHS and returns a set of BaseFacts with
-  // the universe conditions.
+  // these BaseFacts on the LHS and adds the BaseFacts with
+  // the universe conditions to `conditions_`.
   std::vector<BaseFact> GetUniverseConditions(const BaseFact& base_fact) {
-    return base_fact.Accept(*this);
-  }
-
-  std::vector<BaseFact> GetDefaultValue() override { return {}; }
-  std::vector<BaseFact> CombineResult(std::vector<BaseFact> left,
-                                      std::vector<BaseFact> right) override {
-    left.insert(left.end(), right.begin(), right.end());
-    return left;
+    base_fact.Accept(*this);
+    return std::exchange(conditions_, {});
   }
 
-  std::vector<BaseFact> PreVisit(const Principal& prin) override {
+  Unit PreVisit(const Principal& prin) override {
     if (!IsNameConstant(prin.name())) {
-      return {MakeUniverseMembershipFact(
-          prin.name(), datalog::ArgumentType::MakePrincipalType())};
-    } else {
-      return {};
+      conditions_.push_back(MakeUniverseMembershipFact(
+          prin.name(), datalog::ArgumentType::MakePrincipalType()));
     }
+    return Unit();
   }
 
   // Add universe conditions for the non-constant arguments
-  std::vector<BaseFact> Visit(const datalog::Predicate& pred) override {
-    datalog::RelationDeclaration decl =
+  Unit Visit(const datalog::Predicate& pred) override {
+    const datalog::RelationDeclaration& decl =
         decl_env_.GetDeclarationOrFatal(pred.name());
-    std::vector<BaseFact> conditions;
-    std::vector<std::string> args = pred.args();
+    const std::vector<std::string>& args = pred.args();
     for (size_t i = 0; i < args.size(); i++) {
       absl::string_view arg = args[i];
       if (!IsNameConstant(arg)) {
-        conditions.push_back(MakeUniverseMembershipFact(
+        conditions_.push_back(MakeUniverseMembershipFact(
             arg, decl.arguments()[i].argument_type()));
       }
     }
-    return conditions;
+    return Unit();
   }
 
-  DeclarationEnvironment decl_env_;
+  const DeclarationEnvironment& decl_env_;
+  // The conditions of the BaseFact that is being visited.
+  std::vector<BaseFact> conditions_;
 };
 
 }  // namespace
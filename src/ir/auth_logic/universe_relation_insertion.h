@@ -34,8 +34,10 @@ both of these problems by:
     1) extending the program to implement the universe relation pattern by:
     adding universe predicates to the RHS of rules, and adding facts that add
     elements to universes.
-    2) extending the program with facts that use delegation to pass membership
-    of universes across principals.
+    2) extending the program with one rule per element of a universe that
+    passes its membership to every principal. The rules have a variable
+    speaker, so the size of the program does not depend on the product of the
+    number of principals and the number of elements.
 
 This translation is a compiler pass that operates on the data structure
 described in `ast.h` and produces a new instance of the data structure in
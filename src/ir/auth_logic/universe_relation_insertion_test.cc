@@ -16,12 +16,32 @@
 
 #include "src/ir/auth_logic/universe_relation_insertion.h"
 
+#include <string>
+
+#include "absl/strings/string_view.h"
 #include "src/common/testing/gtest.h"
 #include "src/ir/auth_logic/ast.h"
 
 namespace raksha::ir::auth_logic {
 using ::testing::UnorderedElementsAreArray;
 
+// Returns the rule that adds `element` to the universe `universe_name` of
+// every principal, i.e.,
+// `universe_speaker says universe_name(element) :-
+//      isPrincipal(universe_speaker).`
+SaysAssertion SharedUniverseRule(absl::string_view universe_name,
+                                 absl::string_view element) {
+  return SaysAssertion(
+      Principal("universe_speaker"),
+      {Assertion(ConditionalAssertion(
+          Fact({}, BaseFact(datalog::Predicate(std::string(universe_name),
+                                               {std::string(element)},
+                                               datalog::kPositive))),  // lhs
+          {BaseFact(datalog::Predicate("isPrincipal", {"universe_speaker"},
+                                       datalog::kPositive))}  // rhs
+          ))});
+}
+
 // Simple example
 Program BuildTestProgram1() {
   // Input:
@@ -52,7 +72,9 @@ Program BuildTestProgram1Expected() {
   // .decl isNumber(x: Number)
   // "DPTool" says hasToolOutput(anyApp, "DP") :- isApp(anyApp).
   // "DPTool" says isPrincipal("DPTool").
-  // "DPTool" says isProperty("Property").
+  // universe_speaker says isProperty("DP") :- isPrincipal(universe_speaker).
+  // universe_speaker says isPrincipal("DPTool") :-
+  //      isPrincipal(universe_speaker).
   datalog::RelationDeclaration has_tool_output_decl(
       "hasToolOutput", false,
       {
@@ -89,18 +111,17 @@ Program BuildTestProgram1Expected() {
           {BaseFact(datalog::Predicate("isApp", {"app"}, datalog::kPositive))}
           // rhs
           ))});
-  SaysAssertion dp_universe(
-      Principal("\"DPTool\""),
-      {Assertion(Fact({}, BaseFact(datalog::Predicate("isProperty", {"\"DP\""},
-                                                      datalog::kPositive))))});
   SaysAssertion prin_universe(
       Principal("\"DPTool\""),
       {Assertion(
           Fact({}, BaseFact(datalog::Predicate("isPrincipal", {"\"DPTool\""},
                                                datalog::kPositive))))});
-  return Program({has_tool_output_decl, is_app_decl, is_property_decl,
-                  is_principal_decl, is_number_decl},
-                 {assertion1, dp_universe, prin_universe}, {});
+  return Program(
+      {has_tool_output_decl, is_app_decl, is_property_decl, is_principal_decl,
+       is_number_decl},
+      {assertion1, prin_universe, SharedUniverseRule("isProperty", "\"DP\""),
+       SharedUniverseRule("isPrincipal", "\"DPTool\"")},
+      {});
 }
 
 // Example with canSay
@@ -137,11 +158,13 @@ Program BuildTestProgram2Expected() {
   //            isNumber(some_hash).
   // }
   // "Verifier" says isPrincipal("Verifier").
-  // "Verifier" says isPrincipal("EndorsementFile").
-  // "Verifier" says isApp("Application").
-  // "EndorsementFile" says isPrincipal("Verifier").
   // "EndorsementFile" says isPrincipal("EndorsementFile").
-  // "EndorsementFile" says isApp("Application").
+  // universe_speaker says isPrincipal("Verifier") :-
+  //      isPrincipal(universe_speaker).
+  // universe_speaker says isPrincipal("EndorsementFile") :-
+  //      isPrincipal(universe_speaker).
+  // universe_speaker says isApp("SpecificApplication") :-
+  //      isPrincipal(universe_speaker).
   datalog::RelationDeclaration expected_hash(
       "expectedHash", false,
       {
@@ -177,36 +200,17 @@ Program BuildTestProgram2Expected() {
       {Assertion(
           Fact({}, BaseFact(datalog::Predicate("isPrincipal", {"\"Verifier\""},
                                                datalog::kPositive))))});
-  SaysAssertion verif_universe_endorsement(
-      Principal("\"Verifier\""),
-      {Assertion(Fact({}, BaseFact(datalog::Predicate("isPrincipal",
-                                                      {"\"EndorsementFile\""},
-                                                      datalog::kPositive))))});
-  SaysAssertion verif_universe_app(
-      Principal("\"Verifier\""),
-      {Assertion(Fact(
-          {}, BaseFact(datalog::Predicate("isApp", {"\"SpecificApplication\""},
-                                          datalog::kPositive))))});
-  SaysAssertion endorsement_universe_verif(
-      Principal("\"EndorsementFile\""),
-      {Assertion(
-          Fact({}, BaseFact(datalog::Predicate("isPrincipal", {"\"Verifier\""},
-                                               datalog::kPositive))))});
   SaysAssertion endorsement_universe_endorsement(
       Principal("\"EndorsementFile\""),
       {Assertion(Fact({}, BaseFact(datalog::Predicate("isPrincipal",
                                                       {"\"EndorsementFile\""},
                                                       datalog::kPositive))))});
-  SaysAssertion endorsement_universe_app(
-      Principal("\"EndorsementFile\""),
-      {Assertion(Fact(
-          {}, BaseFact(datalog::Predicate("isApp", {"\"SpecificApplication\""},
-                                          datalog::kPositive))))});
   return Program(
       {expected_hash, is_app_decl, is_principal_decl, is_number_decl},
-      {assertion1, verif_universe_verif, verif_universe_endorsement,
-       verif_universe_app, endorsement_universe_verif,
-       endorsement_universe_endorsement, endorsement_universe_app},
+      {assertion1, verif_universe_verif, endorsement_universe_endorsement,
+       SharedUniverseRule("isPrincipal", "\"Verifier\""),
+       SharedUniverseRule("isPrincipal", "\"EndorsementFile\""),
+       SharedUniverseRule("isApp", "\"SpecificApplication\"")},
       {});
 }
 // Example with condition
@@ -237,7 +241,10 @@ Program BuildTestProgram3Expected() {
   // .decl isBar(x: Bar)
   // .decl isPrincipal(x: Principal)
   // .decl isNumber(x: Number)
-  // "PrinA" says foo(bar1) :- foo(bar2)
+  // "PrinA" says foo(bar1) :- isBar(bar1), foo(bar2)
+  // "PrinA" says isPrincipal("PrinA").
+  // universe_speaker says isPrincipal("PrinA") :-
+  //      isPrincipal(universe_speaker).
   datalog::RelationDeclaration foo(
       "foo", false,
       {
@@ -274,7 +281,9 @@ Program BuildTestProgram3Expected() {
           }  // rhs
           ))});
   return Program({foo, is_bar_decl, is_principal_decl, is_number_decl},
-                 {assertion1, prina_universe_prina}, {});
+                 {assertion1, prina_universe_prina,
+                  SharedUniverseRule("isPrincipal", "\"PrinA\"")},
+                 {});
 }
 
 struct ProgramEquivalenceTestData {
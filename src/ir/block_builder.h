@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "src/ir/arena.h"
 #include "src/ir/module.h"
 #include "src/ir/types/type.h"
 #include "src/ir/value.h"
@@ -30,6 +31,13 @@ class BlockBuilder {
  public:
   BlockBuilder() : block_(std::make_unique<Block>()) {}
 
+  // Creates a builder that allocates the block and the operations created by
+  // `AddOperation` in `arena`. The block can only be added to a module that
+  // uses the same arena.
+  explicit BlockBuilder(ArenaPtr arena)
+      : arena_(std::move(arena)),
+        block_(MakeUniqueInArena<Block>(arena_.get())) {}
+
   BlockBuilder& AddInput(absl::string_view name, types::Type type) {
     CHECK(!IsBuilt())
         << "Attempt to use a `BlockBuilder` that has already been built.";
@@ -57,19 +65,22 @@ class BlockBuilder {
   const Operation& AddOperation(const Operator& op,
                                 NamedAttributeMap attributes,
                                 ValueList inputs) {
-    return AddOperation(std::make_unique<Operation>(op, std::move(attributes),
-                                                    std::move(inputs)));
+    return AddOperation(MakeUniqueInArena<Operation>(
+        arena_.get(), op, std::move(attributes), std::move(inputs)));
   }
 
   // Sets parent of operation and adds an operation to the block and returns
   // the operation.
-  const Operation& AddOperation(std::unique_ptr<Operation> op) {
+  const Operation& AddOperation(ArenaUniquePtr<Operation> op) {
     CHECK(!IsBuilt())
         << "Attempt to use a `BlockBuilder` that has already been built.";
     CHECK(op != nullptr) << "`AddOperation` received a nullptr.";
     CHECK(op->parent() == nullptr)
         << "`AddOperation` received an operation with its Parent pointer "
            "already defined. Cannot set parent again!";
+    Arena* operation_arena = op.get_deleter().arena();
+    CHECK(operation_arena == nullptr || operation_arena == arena_.get())
+        << "`AddOperation` received an operation from a different arena.";
     op->set_parent(block_.get());
     block_->operations_.push_back(std::move(op));
     return *block_->operations_.back();
@@ -114,7 +125,7 @@ class BlockBuilder {
     return *this;
   }
 
-  std::unique_ptr<Block> build() {
+  ArenaUniquePtr<Block> build() {
     // After we call `build` on a `BlockBuilder`, the `block_` field is moved
     // from. This causes the pointer within the `block_` field to be stolen
     // by `std::unique_ptr`'s move constructor, leaving a `nullptr` in its
@@ -140,8 +151,13 @@ class BlockBuilder {
 
   bool IsBuilt() const { return block_.get() == nullptr; }
 
+  // Returns the arena of this builder, or nullptr if it has none.
+  Arena* arena() const { return arena_.get(); }
+
  private:
-  std::unique_ptr<Block> block_;
+  // Declared first so that it is destroyed after an unbuilt block.
+  ArenaPtr arena_;
+  ArenaUniquePtr<Block> block_;
 };
 
 }  // namespace raksha::ir
@@ -343,7 +343,7 @@ TEST_F(BlockBuilderDeathTest, AddOperationFailsIfCustomCreateSetsWrongBlock) {
 
 TEST_F(BlockBuilderDeathTest, InvokingBuildMoreThanOnceFails) {
   BlockBuilder builder;
-  std::unique_ptr<Block> block1 = builder.build();
+  ArenaUniquePtr<Block> block1 = builder.build();
   EXPECT_DEATH({ builder.build(); },
                "Attempt to build a `BlockBuilder` that has already been"
                " built.");
@@ -351,7 +351,7 @@ TEST_F(BlockBuilderDeathTest, InvokingBuildMoreThanOnceFails) {
 
 TEST_F(BlockBuilderDeathTest, InvokingGetBlockPtrAfterBuildFails) {
   BlockBuilder builder;
-  std::unique_ptr<Block> block1 = builder.build();
+  ArenaUniquePtr<Block> block1 = builder.build();
   EXPECT_DEATH(
       { builder.GetBlockPtr(); },
       "Attempt to get block pointer from a `BlockBuilder` that has already been"
@@ -26,11 +26,12 @@ namespace raksha::ir::datalog {
 
 using AttributePayload = Adt;
 
-class Attribute
-    : public Record<Symbol /*attr_name*/, AttributePayload /*attr_payload*/> {
+class Attribute final
+    : public InlineRecord<Symbol /*attr_name*/,
+                          AttributePayload /*attr_payload*/> {
  public:
   explicit Attribute(absl::string_view name, AttributePayload payload)
-      : Record(Symbol(name), std::move(payload)) {}
+      : InlineRecord(Symbol(name), std::move(payload)) {}
 
   class String : public AttributePayload {
    public:
@@ -83,11 +84,7 @@ class Attribute
       "NumberAttributePayload";
 };
 
-class AttributeList
-    : public Record<Attribute /*attr*/, AttributeList /*next*/> {
- public:
-  using Record::Record;
-};
+using AttributeList = List<Attribute /*attr*/>;
 
 }  // namespace raksha::ir::datalog
 
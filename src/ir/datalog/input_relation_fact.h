@@ -17,10 +17,14 @@
 #ifndef SRC_IR_DATALOG_INPUT_RELATION_FACT_H_
 #define SRC_IR_DATALOG_INPUT_RELATION_FACT_H_
 
+#include <string>
+#include <tuple>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
-#include "absl/strings/str_format.h"
-#include "absl/strings/str_join.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "src/ir/datalog/value.h"
 
 namespace raksha::ir::datalog {
@@ -39,24 +43,77 @@ class InputRelationFact {
   virtual absl::string_view GetRelationName() const = 0;
 
   std::string ToDatalogString() const {
-    return absl::StrFormat(R"(%s(%s).)", GetRelationName(),
-                           absl::StrJoin(relation_arguments_, ", ",
-                                         [](std::string *str, const auto &arg) {
-                                           absl::StrAppend(
-                                               str, arg.ToDatalogString());
-                                         }));
+    std::string result;
+    AppendDatalogString(&result);
+    return result;
+  }
+
+  // Appends the Datalog representation of this fact to `out`.
+  void AppendDatalogString(std::string *out) const {
+    absl::StrAppend(out, GetRelationName(), "(");
+    AppendArguments(", ", out, [out](const auto &arg) {
+      arg.AppendDatalogString(out);
+    });
+    out->append(").");
   }
 
   // Returns string representation of a fact that can be used in an input
   // relations file.
   std::string ToDatalogFactsFileString() const {
-    return absl::StrJoin(relation_arguments_, "; ",
-                         [](std::string *str, const auto &arg) {
-                           absl::StrAppend(str, arg.ToDatalogString());
-                         });
+    std::string result;
+    AppendDatalogFactsFileString(&result);
+    return result;
+  }
+
+  // Appends the line of an input relations file that holds this fact to
+  // `out`, without the trailing newline. The columns are separated by a bare
+  // `;`, the delimiter of the input relations, as any whitespace around it
+  // would become part of an unquoted symbol column.
+  void AppendDatalogFactsFileString(std::string *out) const {
+    AppendArguments(";", out, [out](const auto &arg) {
+      AppendFactsFileColumn(arg, out);
+    });
+  }
+
+  // Returns the arguments of this fact encoded with the given `encoder`, in
+  // the order of the columns of the relation.
+  std::vector<ValueEncoder::EncodedValue> EncodeRelationArguments(
+      ValueEncoder &encoder) const {
+    return std::apply(
+        [&encoder](const auto &...args) {
+          return std::vector<ValueEncoder::EncodedValue>{
+              args.Encode(encoder)...};
+        },
+        relation_arguments_);
   }
 
  private:
+  // Souffle reads a symbol that makes up a whole column verbatim, so such
+  // symbols must not be quoted. Symbols nested in records and ADTs are.
+  template <typename T>
+  static void AppendFactsFileColumn(const T &arg, std::string *out) {
+    if constexpr (std::is_base_of_v<Symbol, T>) {
+      absl::StrAppend(out, arg.value());
+    } else {
+      arg.AppendDatalogString(out);
+    }
+  }
+
+  // Calls `append_argument` on each argument in order, appending `separator`
+  // to `out` between them.
+  template <typename F>
+  void AppendArguments(absl::string_view separator, std::string *out,
+                       F append_argument) const {
+    std::apply(
+        [&](const auto &...args) {
+          size_t index = 0;
+          ((absl::StrAppend(out, index++ == 0 ? "" : separator),
+            append_argument(args)),
+           ...);
+        },
+        relation_arguments_);
+  }
+
   std::tuple<RelationParameterTypes...> relation_arguments_;
 };
 
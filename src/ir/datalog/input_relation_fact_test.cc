@@ -44,8 +44,9 @@ TEST_P(IsAccessPathFactTest, IsAccessPathFactTest) {
 
 TEST_P(IsAccessPathFactTest, ToDatalogFactsFileStringTest) {
   absl::string_view symbol_string = GetParam();
+  // Souffle reads symbols that make up a whole column verbatim.
   EXPECT_EQ(IsAccessPathFact(Symbol(symbol_string)).ToDatalogFactsFileString(),
-            absl::StrFormat(R"("%s")", symbol_string));
+            symbol_string);
 }
 
 static const absl::string_view kSampleAccessPathStrings[] = {"", "P1.foo",
@@ -82,7 +83,7 @@ TEST(OneOfEachFactTest, OneOfEachFactTest) {
   EXPECT_EQ(fact.ToDatalogString(),
             R"(oneOfEach(5, "foo", [3, "bar"], $Unit()).)");
   EXPECT_EQ(fact.ToDatalogFactsFileString(),
-            R"(5; "foo"; [3, "bar"]; $Unit())");
+            R"(5;foo;[3, "bar"];$Unit())");
 }
 
 }  // namespace raksha::ir::datalog
@@ -24,17 +24,13 @@
 
 namespace raksha::ir::datalog {
 
-class OperandList : public Record<Symbol /*operand*/, OperandList /*next*/> {
-  using Record::Record;
-};
+using OperandList = List<Symbol /*operand*/>;
 
-class ResultList : public Record<Symbol /*result*/, ResultList /*next*/> {
-  using Record::Record;
-};
+using ResultList = List<Symbol /*result*/>;
 
 using Operation =
-    Record<Symbol /*owner*/, Symbol /*operator*/, ResultList /*result*/,
-           OperandList /*operands*/, AttributeList /*attributes*/>;
+    InlineRecord<Symbol /*owner*/, Symbol /*operator*/, ResultList /*result*/,
+                 OperandList /*operands*/, AttributeList /*attributes*/>;
 
 class IsOperationFact : public InputRelationFact<Operation> {
  public:
@@ -48,6 +44,70 @@ class IsOperationFact : public InputRelationFact<Operation> {
   absl::string_view GetRelationName() const { return relation_name(); }
 };
 
+// The facts of the flat operation encoding. Rather than a single record per
+// operation, every operation gets an id and each of its fields is a separate
+// fact about that id. This spares Souffle from interning the nested lists of
+// an operation record and from unwinding them again with recursive rules.
+
+class IsOperationIdFact : public InputRelationFact<Symbol /*operation*/> {
+ public:
+  using InputRelationFact::InputRelationFact;
+  static constexpr absl::string_view relation_name() { return "isOperation"; }
+  absl::string_view GetRelationName() const { return relation_name(); }
+};
+
+class OperationHasActorFact
+    : public InputRelationFact<Symbol /*operation*/, Symbol /*actor*/> {
+ public:
+  using InputRelationFact::InputRelationFact;
+  static constexpr absl::string_view relation_name() {
+    return "operationHasActor";
+  }
+  absl::string_view GetRelationName() const { return relation_name(); }
+};
+
+class OperationHasOperatorFact
+    : public InputRelationFact<Symbol /*operation*/, Symbol /*operator*/> {
+ public:
+  using InputRelationFact::InputRelationFact;
+  static constexpr absl::string_view relation_name() {
+    return "operationHasOperator";
+  }
+  absl::string_view GetRelationName() const { return relation_name(); }
+};
+
+class OperationHasResultFact
+    : public InputRelationFact<Symbol /*operation*/, Symbol /*result*/> {
+ public:
+  using InputRelationFact::InputRelationFact;
+  static constexpr absl::string_view relation_name() {
+    return "operationHasResult";
+  }
+  absl::string_view GetRelationName() const { return relation_name(); }
+};
+
+class OperationHasOperandAtIndexFact
+    : public InputRelationFact<Symbol /*operation*/, Symbol /*operand*/,
+                               Number /*index*/> {
+ public:
+  using InputRelationFact::InputRelationFact;
+  static constexpr absl::string_view relation_name() {
+    return "operationHasOperandAtIndex";
+  }
+  absl::string_view GetRelationName() const { return relation_name(); }
+};
+
+class OperationHasAttributeValueFact
+    : public InputRelationFact<Symbol /*operation*/, Symbol /*attr_name*/,
+                               AttributePayload /*attr_payload*/> {
+ public:
+  using InputRelationFact::InputRelationFact;
+  static constexpr absl::string_view relation_name() {
+    return "operationHasAttributeValue";
+  }
+  absl::string_view GetRelationName() const { return relation_name(); }
+};
+
 }  // namespace raksha::ir::datalog
 
 #endif  // SRC_IR_DATALOG_OPERATION_H_
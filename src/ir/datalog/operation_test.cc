@@ -72,4 +72,27 @@ static IsOperationFactAndExpectedDatalog kSampleIsOperationFactsAndDatalog[] = {
 INSTANTIATE_TEST_SUITE_P(IsOperationFactTest, IsOperationFactTest,
                          ValuesIn(kSampleIsOperationFactsAndDatalog));
 
+TEST(FlatOperationFactTest, FlatFactsNameTheirRelation) {
+  EXPECT_EQ(IsOperationIdFact(Symbol("op0")).ToDatalogString(),
+            R"(isOperation("op0").)");
+  EXPECT_EQ(
+      OperationHasActorFact(Symbol("op0"), Symbol("UserA")).ToDatalogString(),
+      R"(operationHasActor("op0", "UserA").)");
+  EXPECT_EQ(OperationHasOperatorFact(Symbol("op0"), Symbol("sql.MergeOp"))
+                .ToDatalogString(),
+            R"(operationHasOperator("op0", "sql.MergeOp").)");
+  EXPECT_EQ(
+      OperationHasResultFact(Symbol("op0"), Symbol("out")).ToDatalogString(),
+      R"(operationHasResult("op0", "out").)");
+  EXPECT_EQ(OperationHasOperandAtIndexFact(Symbol("op0"), Symbol("input2"),
+                                           Number(1))
+                .ToDatalogFactsFileString(),
+            "op0;input2;1");
+  EXPECT_EQ(OperationHasAttributeValueFact(Symbol("op0"),
+                                           Symbol("literal_value"),
+                                           Attribute::String("number_5"))
+                .ToDatalogFactsFileString(),
+            R"(op0;literal_value;$StringAttributePayload("number_5"))");
+}
+
 }  // namespace raksha::ir::datalog
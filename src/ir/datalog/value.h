@@ -17,33 +17,77 @@
 #ifndef SRC_IR_DATALOG_VALUE_H_
 #define SRC_IR_DATALOG_VALUE_H_
 
+#include <array>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <tuple>
 #include <variant>
+#include <vector>
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
-#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 namespace raksha::ir::datalog {
 
+// An interface for lowering `Value`s directly into the in-memory
+// representation used by a Datalog engine (such as Souffle's `RamDomain`),
+// bypassing the textual form produced by `ToDatalogString`. Each method returns
+// the engine's encoding of the given value. Compound values are encoded
+// bottom-up, so the fields of records and the arguments of ADT branches are
+// handed over already encoded.
+class ValueEncoder {
+ public:
+  using EncodedValue = int64_t;
+
+  virtual ~ValueEncoder() {}
+
+  virtual EncodedValue EncodeNumber(int64_t number) = 0;
+  virtual EncodedValue EncodeFloat(double number) = 0;
+  virtual EncodedValue EncodeSymbol(absl::string_view symbol) = 0;
+  // Encodes the `nil` record.
+  virtual EncodedValue EncodeNil() = 0;
+  // Encodes a (non-nil) record with the given fields.
+  virtual EncodedValue EncodeRecord(absl::Span<const EncodedValue> fields) = 0;
+  // Encodes the ADT branch `branch_name` applied to the given arguments.
+  virtual EncodedValue EncodeAdtBranch(
+      absl::string_view branch_name,
+      absl::Span<const EncodedValue> arguments) = 0;
+};
+
 // The common supertype of any "fully fledged" Souffle value type. Anything
 // descending form `Value` should be able to be used in a `.type` declaration.
 // By this logic, `number`, `symbol`, any record, and any ADT are `Value`s, but
 // individual branches of an ADT are not.
 class Value {
  public:
-  virtual std::string ToDatalogString() const = 0;
+  // Appends the Datalog representation of this value to `out`. Compound values
+  // append their parts in place, so serializing a value does not build a
+  // string per part.
+  virtual void AppendDatalogString(std::string *out) const = 0;
+  virtual ValueEncoder::EncodedValue Encode(ValueEncoder &encoder) const = 0;
   virtual ~Value() {}
+
+  std::string ToDatalogString() const {
+    std::string result;
+    AppendDatalogString(&result);
+    return result;
+  }
 };
 
 // Corresponds to Souffle's `float` type.
-class Float : public Value {
+class Float final : public Value {
  public:
   explicit Float(double value) : float_value_(value) {}
 
-  std::string ToDatalogString() const override {
-    return absl::StrFormat(R"(%lg)", float_value_);
+  void AppendDatalogString(std::string *out) const override {
+    absl::StrAppendFormat(out, R"(%lg)", float_value_);
+  }
+
+  ValueEncoder::EncodedValue Encode(ValueEncoder &encoder) const override {
+    return encoder.EncodeFloat(float_value_);
   }
 
  private:
@@ -51,12 +95,16 @@ class Float : public Value {
 };
 
 // Corresponds to Souffle's `number` type.
-class Number : public Value {
+class Number final : public Value {
  public:
   explicit Number(int64_t value) : number_value_(value) {}
 
-  std::string ToDatalogString() const override {
-    return std::to_string(number_value_);
+  void AppendDatalogString(std::string *out) const override {
+    absl::StrAppend(out, number_value_);
+  }
+
+  ValueEncoder::EncodedValue Encode(ValueEncoder &encoder) const override {
+    return encoder.EncodeNumber(number_value_);
   }
 
  private:
@@ -64,14 +112,20 @@ class Number : public Value {
 };
 
 // Corresponds to Souffle's `symbol` type.
-class Symbol : public Value {
+class Symbol final : public Value {
  public:
   explicit Symbol(absl::string_view value) : symbol_value_(value) {}
 
-  std::string ToDatalogString() const override {
-    return absl::StrFormat(R"("%s")", symbol_value_);
+  void AppendDatalogString(std::string *out) const override {
+    absl::StrAppend(out, "\"", symbol_value_, "\"");
+  }
+
+  ValueEncoder::EncodedValue Encode(ValueEncoder &encoder) const override {
+    return encoder.EncodeSymbol(symbol_value_);
   }
 
+  absl::string_view value() const { return symbol_value_; }
+
  private:
   std::string symbol_value_;
 };
@@ -90,29 +144,146 @@ class Record : public Value {
             std::make_unique<std::tuple<RecordFieldValueTypes...>>(
                 std::forward<RecordFieldValueTypes>(args)...)) {}
 
-  std::string ToDatalogString() const override {
-    if (!record_arguments_) return "nil";
-    return absl::StrFormat(
-        "[%s]", absl::StrJoin(*record_arguments_, ", ",
-                              [](std::string *out, const auto &arg) {
-                                absl::StrAppend(out, arg.ToDatalogString());
-                              }));
+  void AppendDatalogString(std::string *out) const override {
+    if (!record_arguments_) {
+      out->append("nil");
+      return;
+    }
+    out->push_back('[');
+    std::apply(
+        [out](const auto &...fields) {
+          size_t index = 0;
+          ((out->append(index++ == 0 ? "" : ", "),
+            fields.AppendDatalogString(out)),
+           ...);
+        },
+        *record_arguments_);
+    out->push_back(']');
+  }
+
+  ValueEncoder::EncodedValue Encode(ValueEncoder &encoder) const override {
+    if (!record_arguments_) return encoder.EncodeNil();
+    std::array<ValueEncoder::EncodedValue, sizeof...(RecordFieldValueTypes)>
+        fields = std::apply(
+            [&encoder](const auto &...args) {
+              return std::array<ValueEncoder::EncodedValue,
+                                sizeof...(RecordFieldValueTypes)>{
+                  args.Encode(encoder)...};
+            },
+            *record_arguments_);
+    return encoder.EncodeRecord(fields);
   }
 
  private:
   std::unique_ptr<std::tuple<RecordFieldValueTypes...>> record_arguments_;
 };
 
+// A record of which the fields are stored inline. Unlike `Record`, it is never
+// `nil` and building one does not allocate, but it cannot be used for
+// recursive types. The fields are serialized and encoded through their static
+// types, so a record of final value types is written without virtual calls.
+template <class... RecordFieldValueTypes>
+class InlineRecord : public Value {
+ public:
+  explicit InlineRecord(RecordFieldValueTypes &&...args)
+      : record_arguments_(std::forward<RecordFieldValueTypes>(args)...) {}
+
+  void AppendDatalogString(std::string *out) const override {
+    out->push_back('[');
+    std::apply(
+        [out](const auto &...fields) {
+          size_t index = 0;
+          ((out->append(index++ == 0 ? "" : ", "),
+            fields.AppendDatalogString(out)),
+           ...);
+        },
+        record_arguments_);
+    out->push_back(']');
+  }
+
+  ValueEncoder::EncodedValue Encode(ValueEncoder &encoder) const override {
+    std::array<ValueEncoder::EncodedValue, sizeof...(RecordFieldValueTypes)>
+        fields = std::apply(
+            [&encoder](const auto &...args) {
+              return std::array<ValueEncoder::EncodedValue,
+                                sizeof...(RecordFieldValueTypes)>{
+                  args.Encode(encoder)...};
+            },
+            record_arguments_);
+    return encoder.EncodeRecord(fields);
+  }
+
+ private:
+  std::tuple<RecordFieldValueTypes...> record_arguments_;
+};
+
+// A Souffle linked list, that is, a chain of `[element, next]` records ending
+// in `nil`. It is written and encoded exactly like the equivalent chain of
+// `Record<T, List<T>>`s, but the elements are stored in a single vector rather
+// than in one heap allocated record each.
+template <class T>
+class List final : public Value {
+ public:
+  List() = default;
+  explicit List(std::vector<T> elements) : elements_(std::move(elements)) {}
+  // Builds the list `[head, tail]`. This mirrors the constructor of the
+  // equivalent record type; prefer the vector constructor for long lists, as
+  // every element is moved on each prepend.
+  List(T head, List tail) : elements_(std::move(tail.elements_)) {
+    elements_.insert(elements_.begin(), std::move(head));
+  }
+
+  void AppendDatalogString(std::string *out) const override {
+    for (const T &element : elements_) {
+      out->push_back('[');
+      element.AppendDatalogString(out);
+      out->append(", ");
+    }
+    out->append("nil");
+    out->append(elements_.size(), ']');
+  }
+
+  ValueEncoder::EncodedValue Encode(ValueEncoder &encoder) const override {
+    // Encode the elements front to back, like the equivalent chain of records
+    // does, before building the records from the back.
+    std::vector<ValueEncoder::EncodedValue> elements;
+    elements.reserve(elements_.size());
+    for (const T &element : elements_) {
+      elements.push_back(element.Encode(encoder));
+    }
+    ValueEncoder::EncodedValue list = encoder.EncodeNil();
+    for (auto it = elements.rbegin(); it != elements.rend(); ++it) {
+      list = encoder.EncodeRecord({*it, list});
+    }
+    return list;
+  }
+
+  const std::vector<T> &elements() const { return elements_; }
+
+ private:
+  std::vector<T> elements_;
+};
+
 class Adt : public Value {
  public:
   explicit Adt(absl::string_view branch_name) : branch_name_(branch_name) {}
 
-  std::string ToDatalogString() const {
-    return absl::StrFormat(
-        "$%s(%s)", branch_name_,
-        absl::StrJoin(arguments_, ", ", [](std::string *str, const auto &arg) {
-          absl::StrAppend(str, arg->ToDatalogString());
-        }));
+  void AppendDatalogString(std::string *out) const override {
+    absl::StrAppend(out, "$", branch_name_, "(");
+    for (size_t i = 0; i < arguments_.size(); ++i) {
+      if (i > 0) out->append(", ");
+      arguments_[i]->AppendDatalogString(out);
+    }
+    out->push_back(')');
+  }
+
+  ValueEncoder::EncodedValue Encode(ValueEncoder &encoder) const override {
+    std::vector<ValueEncoder::EncodedValue> arguments;
+    arguments.reserve(arguments_.size());
+    for (const std::unique_ptr<Value> &argument : arguments_) {
+      arguments.push_back(argument->Encode(encoder));
+    }
+    return encoder.EncodeAdtBranch(branch_name_, arguments);
   }
 
  protected:
@@ -17,9 +17,11 @@
 #include "src/ir/datalog/value.h"
 
 #include <limits>
+#include <vector>
 
 #include "fuzztest/fuzztest.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
 #include "src/common/testing/gtest.h"
 
@@ -31,6 +33,50 @@ using testing::Combine;
 using testing::TestWithParam;
 using testing::ValuesIn;
 
+// A `ValueEncoder` that renders every value into its Datalog string, so that
+// `Encode` can be checked against `ToDatalogString`.
+class DatalogStringEncoder : public ValueEncoder {
+ public:
+  const std::string &GetString(EncodedValue value) const {
+    return strings_.at(value);
+  }
+
+  EncodedValue EncodeNumber(int64_t number) override {
+    return AddString(std::to_string(number));
+  }
+  EncodedValue EncodeFloat(double number) override {
+    return AddString(absl::StrFormat("%lg", number));
+  }
+  EncodedValue EncodeSymbol(absl::string_view symbol) override {
+    return AddString(absl::StrFormat(R"("%s")", symbol));
+  }
+  EncodedValue EncodeNil() override { return AddString("nil"); }
+  EncodedValue EncodeRecord(absl::Span<const EncodedValue> fields) override {
+    return AddString(absl::StrFormat("[%s]", JoinStrings(fields)));
+  }
+  EncodedValue EncodeAdtBranch(
+      absl::string_view branch_name,
+      absl::Span<const EncodedValue> arguments) override {
+    return AddString(
+        absl::StrFormat("$%s(%s)", branch_name, JoinStrings(arguments)));
+  }
+
+ private:
+  EncodedValue AddString(std::string str) {
+    strings_.push_back(std::move(str));
+    return strings_.size() - 1;
+  }
+
+  std::string JoinStrings(absl::Span<const EncodedValue> values) const {
+    return absl::StrJoin(values, ", ",
+                         [this](std::string *out, EncodedValue value) {
+                           absl::StrAppend(out, GetString(value));
+                         });
+  }
+
+  std::vector<std::string> strings_;
+};
+
 class FloatTest : public TestWithParam<double> {};
 
 TEST_P(FloatTest, FloatTest) {
@@ -122,15 +168,23 @@ class NumList : public Record<Number, NumList> {
 struct NumListAndExpectedDatalog {
   const NumList *num_list_ptr;
   absl::string_view expected_datalog;
+  std::vector<int64_t> elements;
 };
 
 class NumListTest : public TestWithParam<NumListAndExpectedDatalog> {};
 
 TEST_P(NumListTest, NumListTest) {
-  const auto [num_list_ptr, expected_datalog] = GetParam();
+  const auto &[num_list_ptr, expected_datalog, elements] = GetParam();
   EXPECT_EQ(num_list_ptr->ToDatalogString(), expected_datalog);
 }
 
+TEST_P(NumListTest, EncodeMatchesDatalogString) {
+  const auto &[num_list_ptr, expected_datalog, elements] = GetParam();
+  DatalogStringEncoder encoder;
+  EXPECT_EQ(encoder.GetString(num_list_ptr->Encode(encoder)),
+            expected_datalog);
+}
+
 static const NumList kEmptyNumList;
 static const NumList kOneElementNumList = NumList(Number(5), NumList());
 static const NumList kTwoElementNumList(Number(-30),
@@ -138,13 +192,52 @@ static const NumList kTwoElementNumList(Number(-30),
 
 static NumListAndExpectedDatalog kListAndExpectedDatalog[] = {
     {.num_list_ptr = &kEmptyNumList, .expected_datalog = "nil"},
-    {.num_list_ptr = &kOneElementNumList, .expected_datalog = "[5, nil]"},
+    {.num_list_ptr = &kOneElementNumList,
+     .expected_datalog = "[5, nil]",
+     .elements = {5}},
     {.num_list_ptr = &kTwoElementNumList,
-     .expected_datalog = "[-30, [28, nil]]"}};
+     .expected_datalog = "[-30, [28, nil]]",
+     .elements = {-30, 28}}};
 
 INSTANTIATE_TEST_SUITE_P(NumListTest, NumListTest,
                          ValuesIn(kListAndExpectedDatalog));
 
+// A `List` is written and encoded like the equivalent chain of records.
+TEST_P(NumListTest, ListAgreesWithRecordChain) {
+  const NumListAndExpectedDatalog &param = GetParam();
+  std::vector<Number> elements;
+  for (int64_t element : param.elements) elements.push_back(Number(element));
+  List<Number> list(std::move(elements));
+  EXPECT_EQ(list.ToDatalogString(), param.expected_datalog);
+  DatalogStringEncoder encoder;
+  EXPECT_EQ(encoder.GetString(list.Encode(encoder)), param.expected_datalog);
+}
+
+TEST(ListTest, PrependingMatchesVectorConstruction) {
+  List<Symbol> prepended(Symbol("a"),
+                         List<Symbol>(Symbol("b"), List<Symbol>()));
+  std::vector<Symbol> elements;
+  elements.push_back(Symbol("a"));
+  elements.push_back(Symbol("b"));
+  List<Symbol> from_vector(std::move(elements));
+  EXPECT_EQ(prepended.ToDatalogString(), R"(["a", ["b", nil]])");
+  EXPECT_EQ(from_vector.ToDatalogString(), prepended.ToDatalogString());
+  EXPECT_EQ(prepended.elements().size(), 2);
+}
+
+TEST(InlineRecordTest, InlineRecordAgreesWithRecord) {
+  InlineRecord<Number, Symbol, List<Number>> inline_record(
+      Number(3), Symbol("x"), List<Number>(Number(4), List<Number>()));
+  Record<Number, Symbol, List<Number>> record(
+      Number(3), Symbol("x"), List<Number>(Number(4), List<Number>()));
+  EXPECT_EQ(inline_record.ToDatalogString(), R"([3, "x", [4, nil]])");
+  EXPECT_EQ(inline_record.ToDatalogString(), record.ToDatalogString());
+  DatalogStringEncoder encoder;
+  std::string encoded_inline_record =
+      encoder.GetString(inline_record.Encode(encoder));
+  EXPECT_EQ(encoded_inline_record, encoder.GetString(record.Encode(encoder)));
+}
+
 using NumberSymbolPair = Record<Number, Symbol>;
 using NumberSymbolPairPair = Record<NumberSymbolPair, NumberSymbolPair>;
 
@@ -223,6 +316,12 @@ TEST_P(AdtTest, AdtTest) {
   EXPECT_EQ(adt->ToDatalogString(), expected_datalog);
 }
 
+TEST_P(AdtTest, EncodeMatchesDatalogString) {
+  auto &[adt, expected_datalog] = GetParam();
+  DatalogStringEncoder encoder;
+  EXPECT_EQ(encoder.GetString(adt->Encode(encoder)), expected_datalog);
+}
+
 static const ArithmeticAdt kNull = ArithmeticAdt(NullBranch());
 static const ArithmeticAdt kFive = ArithmeticAdt(NumberBranch(Number(5)));
 static const ArithmeticAdt kTwo = ArithmeticAdt(NumberBranch(Number(2)));
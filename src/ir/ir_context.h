@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "src/ir/operator.h"
 #include "src/ir/storage.h"
 #include "src/ir/types/type_factory.h"
@@ -50,8 +51,8 @@ class IRContext {
   types::TypeFactory &type_factory() { return type_factory_; }
 
   // Expose the Operators for inspection.
-  const absl::flat_hash_map<std::string, std::unique_ptr<Operator>> &Operators()
-      const {
+  const absl::flat_hash_map<absl::string_view, std::unique_ptr<Operator>>
+      &Operators() const {
     return operators_.nodes();
   }
 
@@ -104,11 +105,10 @@ class IRContext {
    public:
     // Register a node and return the stored instance.
     const Node &RegisterNode(std::unique_ptr<Node> node) {
-      // Note: using node->name() here is ok because C++ list initialization
-      // guarantees that evaluation of initializers earlier in the list
-      // are sequenced before initializers later in the list.
-      auto ins_res =
-          nodes_.insert({std::string(node->name()), std::move(node)});
+      // The key views the name held by the node itself, which stays put as
+      // the node is owned through a `std::unique_ptr`.
+      absl::string_view node_name = node->name();
+      auto ins_res = nodes_.insert({node_name, std::move(node)});
       CHECK(ins_res.second) << "Cannot register duplicate " << kNodeKindName
                             << " with name '" << ins_res.first->first << "'.";
       return *ins_res.first->second.get();
@@ -126,13 +126,15 @@ class IRContext {
       return nodes_.find(node_name) != nodes_.end();
     }
 
-    const absl::flat_hash_map<std::string, std::unique_ptr<Node>> &nodes()
-        const {
+    const absl::flat_hash_map<absl::string_view, std::unique_ptr<Node>>
+        &nodes() const {
       return nodes_;
     }
 
    private:
-    absl::flat_hash_map<std::string, std::unique_ptr<Node>> nodes_;
+    // Registered nodes by name. Each node is the one interned instance of its
+    // name, so nodes can be compared and hashed by address.
+    absl::flat_hash_map<absl::string_view, std::unique_ptr<Node>> nodes_;
   };
 
   // List of registered operators.
@@ -95,10 +95,8 @@ class IRPrinter : public IRTraversingVisitor<IRPrinter> {
   Unit PreVisit(const Operation& operation) override {
     constexpr absl::string_view kOperationFormat = "%s = %s [%s](%s)";
 
-    // We want the attribute names to print in a stable order. This means that
-    // we cannot just print from the attribute map directly. Gather the names
-    // into a vector and sort that, then use the order in that vector to print
-    // the attributes.
+    // We want the attribute names to print in a stable order. The attributes
+    // of an operation are kept sorted by name, so they print in that order.
     std::string attributes_string = PrintNamedMapInNameOrder(
         operation.attributes(),
         [](const Attribute& attr) { return attr.ToString(); });
@@ -133,6 +131,18 @@ class IRPrinter : public IRTraversingVisitor<IRPrinter> {
     return result;
   }
 
+  // Returns the pretty-printed attributes, which are already sorted by name.
+  template <class F>
+  static std::string PrintNamedMapInNameOrder(
+      const NamedAttributeMap& map_to_print, F value_pretty_printer) {
+    return absl::StrJoin(
+        map_to_print, ", ",
+        [&](std::string* out, const NamedAttributeMap::value_type& attribute) {
+          absl::StrAppend(out, attribute.first, ": ",
+                          value_pretty_printer(attribute.second));
+        });
+  }
+
   // Returns a pretty-printed map where entries are sorted by the key.
   template <class T, class F>
   static std::string PrintNamedMapInNameOrder(
@@ -27,7 +27,7 @@ namespace raksha::ir {
 
 proto::Module IRToProto::ModuleToProto(const Module& module) {
   proto::Module module_proto;
-  for (const std::unique_ptr<Block>& block : module.blocks()) {
+  for (const ArenaUniquePtr<Block>& block : module.blocks()) {
     proto::BlockWithId* block_proto = module_proto.mutable_blocks()->Add();
     (*block_proto->mutable_block()) = BlockToProto(*block);
     block_proto->set_id(GetID(*block));
@@ -38,7 +38,7 @@ proto::Module IRToProto::ModuleToProto(const Module& module) {
 proto::Block IRToProto::BlockToProto(const Block& block) {
   proto::Block block_proto;
   // TODO(#619): Consider preserving inputs/outputs.
-  for (const std::unique_ptr<Operation>& operation : block.operations()) {
+  for (const ArenaUniquePtr<Operation>& operation : block.operations()) {
     proto::OperationWithId* operation_proto =
         block_proto.mutable_operations()->Add();
     (*operation_proto->mutable_operation()) = OperationToProto(*operation);
@@ -16,14 +16,22 @@
 
 #include "src/ir/ir_to_proto.h"
 
+#include <memory>
 #include <string>
 
+#include "absl/status/statusor.h"
 #include "google/protobuf/text_format.h"
 #include "google/protobuf/util/message_differencer.h"
 #include "src/common/testing/gtest.h"
+#include "src/ir/arena.h"
+#include "src/ir/attributes/attribute.h"
+#include "src/ir/attributes/int_attribute.h"
+#include "src/ir/block_builder.h"
+#include "src/ir/ir_context.h"
 #include "src/ir/ir_printer.h"
 #include "src/ir/proto/raksha_ir.pb.h"
 #include "src/ir/proto_to_ir.h"
+#include "src/ir/value.h"
 #include "src/parser/ir/ir_parser.h"
 
 namespace raksha::ir {
@@ -57,6 +65,15 @@ TEST_P(IrToProtoTest, RoundTripPreservesAllInformation) {
   proto::IrTranslationUnit recovered_translation_unit_proto =
       IRToProto::Convert(context1, *recovered.module);
 
+  IRContext context3;
+  absl::StatusOr<ProtoToIR::Result> recovered_from_binary =
+      ProtoToIR::ConvertBinary(
+          context3, orig_translation_unit_proto.SerializeAsString());
+  ASSERT_TRUE(recovered_from_binary.ok()) << recovered_from_binary.status();
+  EXPECT_EQ(IRPrinter::ToString(*recovered_from_binary->module,
+                                *recovered_from_binary->ssa_names),
+            input_program_text);
+
   google::protobuf::util::MessageDifferencer differencer;
   std::string difference = "<Compare not yet run>";
   differencer.ReportDifferencesToString(&difference);
@@ -86,6 +103,55 @@ INSTANTIATE_TEST_SUITE_P(IrToProtoTest, IrToProtoTest,
   }  // block b1
 }  // module m0
 )"));
+
+TEST(ProtoToIRTest, ConvertBinaryRejectsCorruptInput) {
+  IRContext context;
+  EXPECT_FALSE(ProtoToIR::ConvertBinary(context, "\xff\xff\xff").ok());
+}
+
+TEST(ProtoToIRTest, ParallelConversionAgreesWithSerialConversion) {
+  IRContext context;
+  const Operator& plus =
+      context.RegisterOperator(std::make_unique<Operator>("core.plus"));
+  ArenaPtr arena = Arena::Create();
+  Module module(arena);
+  // Chain the operations across blocks, so that blocks built by different
+  // threads refer to each other.
+  const Operation* previous = nullptr;
+  for (int block = 0; block < 40; ++block) {
+    BlockBuilder builder(arena);
+    for (int operation = 0; operation < 5; ++operation) {
+      ValueList inputs;
+      if (previous != nullptr) {
+        inputs.push_back(Value(value::OperationResult(*previous, 0)));
+      }
+      inputs.push_back(Value(value::Any()));
+      previous = &builder.AddOperation(
+          plus,
+          NamedAttributeMap{
+              {"index", Attribute::Create<Int64Attribute>(operation)}},
+          inputs);
+    }
+    module.AddBlock(builder.build());
+  }
+  proto::IrTranslationUnit translation_unit =
+      IRToProto::Convert(context, module);
+
+  IRContext serial_context;
+  ProtoToIR::Result serial =
+      ProtoToIR::Convert(serial_context, translation_unit);
+  const std::string serial_text =
+      IRPrinter::ToString(*serial.module, *serial.ssa_names);
+  for (size_t num_threads : {2, 4, 64}) {
+    IRContext parallel_context;
+    ProtoToIR::Result parallel =
+        ProtoToIR::Convert(parallel_context, translation_unit, num_threads);
+    EXPECT_EQ(IRPrinter::ToString(*parallel.module, *parallel.ssa_names),
+              serial_text)
+        << "with " << num_threads << " threads";
+  }
+}
+
 // TODO(#596): Add tests for IR with block arguments and returns.
 // TODO(#605): Add tests for IR with out of order declarations.
 }  // namespace
@@ -88,7 +88,7 @@ class IRTraversingVisitor
     Result pre_visit_result = PreVisit(module);
     Result fold_result = common::utils::fold(
         module.blocks(), std::move(pre_visit_result),
-        [this](Result acc, const std::unique_ptr<Block>& block) {
+        [this](Result acc, const ArenaUniquePtr<Block>& block) {
           return FoldResult(std::move(acc), block->Accept(*this));
         });
     return PostVisit(module, std::move(fold_result));
@@ -98,7 +98,7 @@ class IRTraversingVisitor
     Result pre_visit_result = PreVisit(block);
     Result fold_result = common::utils::fold(
         block.operations(), std::move(pre_visit_result),
-        [this](Result acc, const std::unique_ptr<Operation>& operation) {
+        [this](Result acc, const ArenaUniquePtr<Operation>& operation) {
           return FoldResult(std::move(acc), operation->Accept(*this));
         });
     return PostVisit(block, std::move(fold_result));
@@ -17,9 +17,14 @@
 #define SRC_IR_MODULE_H_
 
 #include <cstdint>
+#include <iterator>
+#include <memory>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "src/ir/arena.h"
 #include "src/ir/attributes/attribute.h"
 #include "src/ir/data_decl.h"
 #include "src/ir/ir_visitor.h"
@@ -32,8 +37,12 @@ namespace raksha::ir {
 
 class Module;
 class Block;
+class UseDefIndex;
 
-// An Operation represents a unit of execution.
+// An Operation represents a unit of execution. Operations can be allocated in
+// the `Arena` of the module that they are going to be part of. A few inputs
+// and attributes are stored inside the operation itself, so that most
+// operations take up a single allocation.
 class Operation {
  public:
   Operation(const Block* parent, const Operator& op,
@@ -41,7 +50,8 @@ class Operation {
       : parent_(parent),
         op_(std::addressof(op)),
         attributes_(std::move(attributes)),
-        inputs_(std::move(inputs)) {}
+        inputs_(std::make_move_iterator(inputs.begin()),
+                std::make_move_iterator(inputs.end())) {}
 
   Operation(const Operator& op, NamedAttributeMap attributes, ValueList inputs)
       : Operation(nullptr, op, attributes, inputs) {}
@@ -58,7 +68,7 @@ class Operation {
 
   const Operator& op() const { return *op_; }
   const Block* parent() const { return parent_; }
-  const ValueList& inputs() const { return inputs_; }
+  const OperationInputs& inputs() const { return inputs_; }
   const NamedAttributeMap& attributes() const { return attributes_; }
 
   const Value& GetInputValue(uint64_t index) const {
@@ -83,7 +93,9 @@ class Operation {
   Result Accept(IRVisitor<Derived, Result, true>& visitor) const {
     return visitor.Visit(*this);
   }
-  void AddInput(const Value& value) { inputs_.push_back(value); }
+  // Adds an input to the operation. If the operation is already part of a
+  // module, this invalidates the `UseDefIndex` of the module.
+  void AddInput(const Value& value);
   void AddAttribute(const std::string name, const Attribute& value) {
     attributes_.emplace(name, value);
   }
@@ -97,14 +109,15 @@ class Operation {
   // The attributes of the operation.
   NamedAttributeMap attributes_;
   // The inputs of the operation.
-  ValueList inputs_;
+  OperationInputs inputs_;
 };
 
-// A collection of operations.
+// A collection of operations. Blocks can be allocated in the `Arena` of the
+// module that they are going to be part of.
 class Block {
  public:
   // The type for a collection of `Operation` instances.
-  using OperationList = std::vector<std::unique_ptr<Operation>>;
+  using OperationList = std::vector<ArenaUniquePtr<Operation>>;
 
   Block() : parent_module_(nullptr) {}
 
@@ -156,27 +169,51 @@ class Block {
 // A class that contains a collection of blocks.
 class Module {
  public:
-  using BlockListType = std::vector<std::unique_ptr<Block>>;
+  using BlockListType = std::vector<ArenaUniquePtr<Block>>;
   using NamedStorageMap =
       absl::flat_hash_map<std::string, std::unique_ptr<Storage>>;
 
   Module() {}
+  // Creates a module whose blocks and operations may be allocated in `arena`.
+  // Building a large module in an arena replaces one heap allocation per node
+  // by bump allocations, and a single release of the arena on destruction.
+  explicit Module(ArenaPtr arena) : arena_(std::move(arena)) {}
   // Make the class move-only.
   Module(const Module&) = delete;
   Module& operator=(const Module&) = delete;
-  Module(Module&&) = default;
-  Module& operator=(Module&&) = default;
+  Module(Module&& other)
+      : arena_(std::move(other.arena_)),
+        blocks_(std::move(other.blocks_)),
+        named_storage_map_(std::move(other.named_storage_map_)) {
+    AdoptBlocks();
+  }
+  Module& operator=(Module&& other) {
+    // The blocks have to be released before the arena that holds them.
+    blocks_ = std::move(other.blocks_);
+    named_storage_map_ = std::move(other.named_storage_map_);
+    arena_ = std::move(other.arena_);
+    AdoptBlocks();
+    InvalidateUseDefIndex();
+    return *this;
+  }
   ~Module() = default;
 
+  // Returns the arena of this module, or nullptr if it has none.
+  Arena* arena() const { return arena_.get(); }
+
   // Adds a block to the module and returns a pointer to it.
-  const Block& AddBlock(std::unique_ptr<Block> block) {
+  const Block& AddBlock(ArenaUniquePtr<Block> block) {
     // Note: this check should be impossible due to this function taking a
     // `unique_ptr` to the `Block`. But it's a cheap thing to check, so might
     // as well just do it.
     CHECK(block->parent_module() == nullptr) << "Attempt to add a Block to two "
                                                 "different Modules!";
+    Arena* block_arena = block.get_deleter().arena();
+    CHECK(block_arena == nullptr || block_arena == arena_.get())
+        << "Attempt to add a Block from a different arena to a Module!";
     block->set_parent_module(*this);
     blocks_.push_back(std::move(block));
+    InvalidateUseDefIndex();
     return *blocks_.back();
   }
 
@@ -224,10 +261,41 @@ class Module {
   }
 
  private:
+  friend class Operation;
+  friend class UseDefIndex;
+
+  // Makes this module the parent of its blocks after they were moved here.
+  void AdoptBlocks() {
+    for (ArenaUniquePtr<Block>& block : blocks_) {
+      block->set_parent_module(*this);
+    }
+  }
+
+  // Drops the `UseDefIndex` of this module, if any, after it changed.
+  void InvalidateUseDefIndex() const {
+    absl::MutexLock lock(&use_def_index_mutex_);
+    use_def_index_.reset();
+  }
+
+  // Declared first so that it is destroyed after the blocks that it holds.
+  ArenaPtr arena_;
   BlockListType blocks_;
   NamedStorageMap named_storage_map_;
+  // The index of the uses and definitions of the values of this module. It is
+  // built on demand by `UseDefIndex::Get` and shared by all analyses of the
+  // module until the module changes.
+  mutable absl::Mutex use_def_index_mutex_;
+  mutable std::shared_ptr<const UseDefIndex> use_def_index_
+      ABSL_GUARDED_BY(use_def_index_mutex_);
 };
 
+inline void Operation::AddInput(const Value& value) {
+  inputs_.push_back(value);
+  if (parent_ != nullptr && parent_->parent_module() != nullptr) {
+    parent_->parent_module()->InvalidateUseDefIndex();
+  }
+}
+
 }  // namespace raksha::ir
 
 #endif  // SRC_IR_MODULE_H_
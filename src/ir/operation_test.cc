@@ -56,7 +56,7 @@ TEST_P(OperationTest, AccessorsAndToStringReturnCorrectValue) {
   EXPECT_EQ(operation.parent(), block);
   EXPECT_EQ(&operation.op(), op);
   EXPECT_EQ(operation.attributes(), attributes);
-  EXPECT_EQ(operation.inputs(), inputs);
+  EXPECT_THAT(operation.inputs(), testing::ElementsAreArray(inputs));
   EXPECT_EQ(IRPrinter::ToString(operation), string_reps);
 }
 
@@ -16,9 +16,13 @@
 
 #include "src/ir/proto_to_ir.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <optional>
+#include <thread>
 #include <variant>
+#include <vector>
 
 #include "src/ir/attributes/float_attribute.h"
 #include "src/ir/attributes/int_attribute.h"
@@ -27,9 +31,9 @@
 namespace raksha::ir {
 
 std::unique_ptr<Module> ProtoToIR::PreVisit(const proto::Module& module_proto) {
-  auto module = std::make_unique<Module>();
+  auto module = std::make_unique<Module>(arena_);
   for (const auto& block_it : module_proto.blocks()) {
-    blocks_.insert({block_it.id(), BlockBuilder()});
+    blocks_.insert({block_it.id(), BlockBuilder(arena_)});
     PreVisit(block_it.block());
   }
   return module;
@@ -43,7 +47,7 @@ void ProtoToIR::PreVisit(const proto::Block& block_proto) {
     CHECK(op != nullptr) << "Operator " << name << " was not registered.";
 
     // Register operation result values with 'SsaNames'.
-    auto operation = std::make_unique<Operation>(*op);
+    auto operation = MakeUniqueInArena<Operation>(arena_.get(), *op);
     // TODO(b/253252963) IR to proto conversion does no hold onto the mapping
     // between operator name and multi returns. "out.0" is a work around to pass
     // tests with single return operations.
@@ -169,9 +173,38 @@ void ProtoToIR::PostVisit(const proto::AttributePayload& attribute_payload) {
   // Nothing to do here.
 }
 
-void ProtoToIR::ToIR(const proto::Module& module_proto) {
+void ProtoToIR::ToIR(const proto::Module& module_proto, size_t num_threads) {
+  const auto& blocks = module_proto.blocks();
+  std::atomic<int> next_block = 0;
+  auto build_blocks = [&]() {
+    for (int block = next_block++; block < blocks.size();
+         block = next_block++) {
+      ToIR(blocks[block].id(), blocks[block].block());
+    }
+  };
+  // The calling thread is one of the threads.
+  num_threads = std::max<size_t>(
+      1, std::min<size_t>(num_threads, module_proto.blocks_size()));
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(build_blocks);
+  }
+  build_blocks();
+  for (std::thread& thread : threads) thread.join();
+}
+
+void ProtoToIR::RegisterValues(const proto::Module& module_proto) {
   for (const auto& block_it : module_proto.blocks()) {
-    ToIR(block_it.id(), block_it.block());
+    const Block& block = *blocks_.at(block_it.id()).GetBlockPtr();
+    for (const auto& result_it : block_it.block().results().values()) {
+      ssa_names_.GetOrCreateID(block.results().at(result_it.first));
+    }
+    for (const auto& operation_it : block_it.block().operations()) {
+      for (const Value& input : operations_.at(operation_it.id())->inputs()) {
+        ssa_names_.GetOrCreateID(input);
+      }
+    }
   }
 }
 
@@ -220,8 +253,7 @@ Value ProtoToIR::ToIR(const proto::Value& value_proto) {
     value = Value(ToIR(value_proto.block_argument_value()));
   }
   CHECK(value) << "Value not constructed due to unexpected variant of Value from IR.";
-  // Register the value with 'SsaNames'.
-  ssa_names_.GetOrCreateID(*value);
+  // The value is registered with 'SsaNames' by `RegisterValues`.
   return *value;
 }
 
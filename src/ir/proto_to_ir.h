@@ -16,8 +16,13 @@
 #ifndef SRC_IR_PROTO_TO_IR_H_
 #define SRC_IR_PROTO_TO_IR_H_
 
+#include <cstddef>
+#include <limits>
+
+#include "google/protobuf/arena.h"
 #include "google/protobuf/util/json_util.h"
 #include "absl/status/statusor.h"
+#include "src/ir/arena.h"
 #include "src/ir/attributes/attribute.h"
 #include "src/ir/block_builder.h"
 #include "src/ir/ir_context.h"
@@ -36,8 +41,12 @@ class ProtoToIR {
     std::unique_ptr<SsaNames> ssa_names;
   };
 
+  // The `num_threads` argument of the conversions is the number of threads
+  // that build the operations of the blocks of the module. It does not change
+  // the result.
   static absl::StatusOr<Result> Convert(
-      IRContext& context, absl::string_view irTranslationUnitJsonProto) {
+      IRContext& context, absl::string_view irTranslationUnitJsonProto,
+      size_t num_threads = 1) {
     proto::IrTranslationUnit irTranslationUnit;
     auto status = google::protobuf::util::JsonStringToMessage(irTranslationUnitJsonProto,
                                                     &irTranslationUnit);
@@ -46,11 +55,37 @@ class ProtoToIR {
       return absl::InvalidArgumentError("Json IR proto is corrupt");
     }
 
-    return Convert(context, irTranslationUnit);
+    return Convert(context, irTranslationUnit, num_threads);
+  }
+
+  // Converts an `IrTranslationUnit` in the protobuf wire format. This is much
+  // faster than going through JSON. The message is parsed straight from
+  // `irTranslationUnitBinaryProto` into a protobuf arena that is dropped as a
+  // whole once the IR is built.
+  static absl::StatusOr<Result> ConvertBinary(
+      IRContext& context, absl::string_view irTranslationUnitBinaryProto,
+      size_t num_threads = 1) {
+    if (irTranslationUnitBinaryProto.size() >
+        static_cast<size_t>(std::numeric_limits<int>::max())) {
+      return absl::InvalidArgumentError("Binary IR proto is too large");
+    }
+    google::protobuf::Arena proto_arena;
+    auto* irTranslationUnit =
+        google::protobuf::Arena::CreateMessage<proto::IrTranslationUnit>(
+            &proto_arena);
+    if (!irTranslationUnit->ParseFromArray(
+            irTranslationUnitBinaryProto.data(),
+            static_cast<int>(irTranslationUnitBinaryProto.size()))) {
+      LOG(ERROR) << "Binary IR proto is corrupt";
+      return absl::InvalidArgumentError("Binary IR proto is corrupt");
+    }
+
+    return Convert(context, *irTranslationUnit, num_threads);
   }
 
   static Result Convert(IRContext& context,
-                        const proto::IrTranslationUnit& root) {
+                        const proto::IrTranslationUnit& root,
+                        size_t num_threads = 1) {
     // Store the operators in the context.
     for (const auto& op : root.operators()) {
       auto name = op.name();
@@ -66,7 +101,8 @@ class ProtoToIR {
     // Construct objects to point to during construction.
     auto module = state.PreVisit(root.top_level_module());
     // Perform construction.
-    state.ToIR(root.top_level_module());
+    state.ToIR(root.top_level_module(), num_threads);
+    state.RegisterValues(root.top_level_module());
     // Move objects into their 'owning' objects.
     state.PostVisit(*module, root.top_level_module());
 
@@ -88,7 +124,7 @@ class ProtoToIR {
 
  private:
   ProtoToIR(IRContext& context, SsaNames& ssa_names)
-      : context_{context}, ssa_names_{ssa_names} {}
+      : context_{context}, ssa_names_{ssa_names}, arena_(Arena::Create()) {}
 
   // Disable copy (and move) semantics.
   ProtoToIR(const ProtoToIR&) = delete;
@@ -107,7 +143,10 @@ class ProtoToIR {
   void PreVisit(const proto::OperationResultValue&);
   void PreVisit(const proto::AttributePayload&);
 
-  void ToIR(const proto::Module& module_proto);
+  // Builds the contents of the blocks on `num_threads` threads. The blocks
+  // and operations have all been allocated by `PreVisit`, so the threads only
+  // look up the maps below and fill in distinct blocks and operations.
+  void ToIR(const proto::Module& module_proto, size_t num_threads);
   void ToIR(ID block_id, const proto::Block& block_proto);
   void ToIR(Operation& op, const proto::Operation& operation_proto);
   Value ToIR(const proto::Value& value);
@@ -116,6 +155,11 @@ class ProtoToIR {
   value::OperationResult ToIR(const proto::OperationResultValue&);
   Attribute ToIR(const proto::AttributePayload&);
 
+  // Registers the values built by `ToIR` with `ssa_names_`, in the order in
+  // which a single thread builds them, so that their ids do not depend on the
+  // number of threads.
+  void RegisterValues(const proto::Module& module_proto);
+
   void PostVisit(Module& module, const proto::Module& module_proto);
   void PostVisit(BlockBuilder& block, const proto::Block& block_proto);
   void PostVisit(Operation& op, const proto::Operation& operation_proto);
@@ -127,8 +171,12 @@ class ProtoToIR {
 
   const IRContext& context_;
   SsaNames& ssa_names_;
+  // The arena for all blocks and operations of the module, which takes it
+  // over. Declared before the blocks and operations under construction so
+  // that it outlives them.
+  ArenaPtr arena_;
   // TODO(#620): Consider an 'OperationBuilder'
-  absl::flat_hash_map<ID, std::unique_ptr<Operation>> operations_;
+  absl::flat_hash_map<ID, ArenaUniquePtr<Operation>> operations_;
   absl::flat_hash_map<ID, BlockBuilder> blocks_;
 };
 
@@ -0,0 +1,154 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/ir/use_def_index.h"
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "src/ir/ir_traversing_visitor.h"
+#include "src/ir/module.h"
+#include "src/ir/value.h"
+
+namespace raksha::ir {
+
+namespace {
+
+using NodeId = UseDefIndex::NodeId;
+using EdgeIndex = UseDefIndex::EdgeIndex;
+
+// An edge of the graph in terms of node ids.
+struct IdEdge {
+  NodeId source;
+  EdgeIndex index;
+  NodeId target;
+};
+
+// Collects the nodes and edges of a module, numbering the nodes in the order
+// they are encountered.
+class GraphCollectingVisitor
+    : public IRTraversingVisitor<GraphCollectingVisitor> {
+ public:
+  std::vector<UseDefIndex::Node>& nodes() { return nodes_; }
+  absl::flat_hash_map<UseDefIndex::Node, NodeId>& node_ids() {
+    return node_ids_;
+  }
+  const std::vector<IdEdge>& edges() const { return edges_; }
+
+ private:
+  Unit PreVisit(const Operation& operation) override {
+    // Add a node for the operation.
+    NodeId operation_id = AddNode(UseDefIndex::Node(&operation));
+
+    // Add a node for every input of the operation along with the edge
+    // input --index--> operation.
+    EdgeIndex input_index = 0;
+    for (const auto& input : operation.inputs()) {
+      NodeId input_id = AddNode(UseDefIndex::Node(input));
+      edges_.push_back({input_id, input_index, operation_id});
+      ++input_index;
+    }
+
+    // Add a node for every output of the operation along with the edge
+    // operation --index--> output.
+    for (uint64_t output_index = 0; output_index < operation.NumberOfOutputs();
+         ++output_index) {
+      NodeId output_id =
+          AddNode(UseDefIndex::Node(operation.GetOutputValue(output_index)));
+      edges_.push_back({operation_id, output_index, output_id});
+    }
+    return Unit();
+  }
+
+  // Returns the id of the node, numbering it if it is new.
+  NodeId AddNode(UseDefIndex::Node node) {
+    auto [entry, inserted] = node_ids_.insert({node, nodes_.size()});
+    if (inserted) nodes_.push_back(std::move(node));
+    return entry->second;
+  }
+
+  std::vector<UseDefIndex::Node> nodes_;
+  absl::flat_hash_map<UseDefIndex::Node, NodeId> node_ids_;
+  std::vector<IdEdge> edges_;
+};
+
+// Groups the given entries by the node returned by `get_node` into CSR form,
+// using a stable counting sort to preserve the relative order of entries of
+// the same node.
+template <typename Entry, typename GetNode, typename MakeCsrEntry>
+void BuildCsr(size_t number_of_nodes, const std::vector<IdEdge>& edges,
+              GetNode get_node, MakeCsrEntry make_csr_entry,
+              std::vector<size_t>& offsets, std::vector<Entry>& entries) {
+  offsets.assign(number_of_nodes + 1, 0);
+  for (const IdEdge& edge : edges) {
+    if (std::optional<NodeId> node = get_node(edge)) ++offsets[*node + 1];
+  }
+  for (size_t node = 0; node < number_of_nodes; ++node) {
+    offsets[node + 1] += offsets[node];
+  }
+  entries.resize(offsets.back());
+  std::vector<size_t> next_entry(offsets.begin(), offsets.end() - 1);
+  for (const IdEdge& edge : edges) {
+    if (std::optional<NodeId> node = get_node(edge)) {
+      entries[next_entry[*node]++] = make_csr_entry(edge);
+    }
+  }
+}
+
+}  // namespace
+
+std::shared_ptr<const UseDefIndex> UseDefIndex::Get(const Module& module) {
+  // The index is built while holding the lock, so that concurrent analyses of
+  // a module wait for a single build instead of each doing their own.
+  absl::MutexLock lock(&module.use_def_index_mutex_);
+  if (module.use_def_index_ == nullptr) {
+    module.use_def_index_ = std::make_shared<const UseDefIndex>(module);
+  }
+  return module.use_def_index_;
+}
+
+UseDefIndex::UseDefIndex(const Module& module) {
+  GraphCollectingVisitor visitor;
+  module.Accept(visitor);
+  nodes_ = std::move(visitor.nodes());
+  node_ids_ = std::move(visitor.node_ids());
+
+  BuildCsr(
+      nodes_.size(), visitor.edges(),
+      [](const IdEdge& edge) { return std::make_optional(edge.source); },
+      [](const IdEdge& edge) {
+        return IndexedNodeId{.index = edge.index, .node = edge.target};
+      },
+      out_edge_offsets_, out_edges_);
+
+  // Only the edges into operations are inputs. As the inputs of an operation
+  // are collected in operand order, the stable grouping keeps them in order.
+  BuildCsr(
+      nodes_.size(), visitor.edges(),
+      [this](const IdEdge& edge) -> std::optional<NodeId> {
+        if (!std::holds_alternative<const Operation*>(nodes_[edge.target]))
+          return std::nullopt;
+        return edge.target;
+      },
+      [](const IdEdge& edge) { return edge.source; }, input_offsets_,
+      inputs_);
+}
+
+}  // namespace raksha::ir
@@ -0,0 +1,125 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#ifndef SRC_IR_USE_DEF_INDEX_H_
+#define SRC_IR_USE_DEF_INDEX_H_
+
+#include <cstddef>
+#include <memory>
+#include <variant>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/types/span.h"
+#include "src/ir/module.h"
+#include "src/ir/value.h"
+
+namespace raksha::ir {
+
+// The uses and definitions of the values of a module: the nodes are the
+// operations and values of the module, and there is an edge from each input
+// value to the operation using it and from each operation to its results.
+//
+// The nodes are numbered densely in the order they are first encountered in
+// the module, and the edges are stored in compressed sparse row (CSR) form.
+//
+// A module keeps the index of its current contents, so that the analyses of a
+// module share one index instead of each scanning the module again; see
+// `UseDefIndex::Get`.
+class UseDefIndex {
+ public:
+  using EdgeIndex = size_t;
+  using NodeId = size_t;
+  using Node = std::variant<Value, const Operation*>;
+  // The target of an edge along with the index of the edge.
+  struct IndexedNodeId {
+    EdgeIndex index;
+    NodeId node;
+  };
+  using IndexedNodeIdIterator = std::vector<IndexedNodeId>::const_iterator;
+
+  // Returns the index of the current contents of `module`. The index is built
+  // on the first call and kept by the module until it changes, i.e., until a
+  // block is added to it or an input to one of its operations. An index that
+  // is still held after such a change no longer describes the module. This
+  // may be called from several threads at once.
+  static std::shared_ptr<const UseDefIndex> Get(const Module& module);
+
+  // Builds the index of `module` without keeping it in the module.
+  explicit UseDefIndex(const Module& module);
+
+  // Returns all the nodes, indexed by their id.
+  const std::vector<Node>& nodes() const { return nodes_; }
+
+  size_t NumberOfNodes() const { return nodes_.size(); }
+
+  // Returns the node with the given id.
+  const Node& GetNode(NodeId id) const {
+    CHECK(id < nodes_.size()) << "GetNode: node id out of range.";
+    return nodes_[id];
+  }
+
+  // Returns the id of the given node, which must be part of the module.
+  NodeId GetNodeId(const Node& node) const {
+    auto find_result = node_ids_.find(node);
+    CHECK(find_result != node_ids_.end()) << "GetNodeId: node not in graph.";
+    return find_result->second;
+  }
+
+  // Returns the targets of the out edges of the given node, in the order they
+  // were encountered in the module. For a value, these are the operations
+  // using it; for an operation, its results.
+  absl::Span<const IndexedNodeId> GetOutEdgeIds(NodeId source) const {
+    CHECK(source < nodes_.size()) << "GetOutEdgeIds: node id out of range.";
+    return absl::MakeConstSpan(out_edges_).subspan(
+        out_edge_offsets_[source],
+        out_edge_offsets_[source + 1] - out_edge_offsets_[source]);
+  }
+
+  // Returns the bounds of `GetOutEdgeIds(source)` as iterators.
+  IndexedNodeIdIterator GetOutEdgesBegin(NodeId source) const {
+    CHECK(source < nodes_.size()) << "GetOutEdges: source not found in graph.";
+    return out_edges_.begin() + out_edge_offsets_[source];
+  }
+  IndexedNodeIdIterator GetOutEdgesEnd(NodeId source) const {
+    return out_edges_.begin() + out_edge_offsets_[source + 1];
+  }
+
+  // Returns the ids of the inputs of the given operation, in the order of
+  // the operands. The result is empty for values.
+  absl::Span<const NodeId> GetInputIds(NodeId operation) const {
+    CHECK(operation < nodes_.size()) << "GetInputIds: node id out of range.";
+    return absl::MakeConstSpan(inputs_).subspan(
+        input_offsets_[operation],
+        input_offsets_[operation + 1] - input_offsets_[operation]);
+  }
+
+ private:
+  // The nodes, indexed by their id.
+  std::vector<Node> nodes_;
+  absl::flat_hash_map<Node, NodeId> node_ids_;
+  // The out edges of node `i` are `out_edges_[out_edge_offsets_[i]]` up to
+  // (excluding) `out_edges_[out_edge_offsets_[i + 1]]`.
+  std::vector<size_t> out_edge_offsets_;
+  std::vector<IndexedNodeId> out_edges_;
+  // The inputs of operation `i`, stored in the same way as the out edges.
+  std::vector<size_t> input_offsets_;
+  std::vector<NodeId> inputs_;
+};
+
+}  // namespace raksha::ir
+
+#endif  // SRC_IR_USE_DEF_INDEX_H_
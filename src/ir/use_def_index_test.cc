@@ -0,0 +1,103 @@
+//-----------------------------------------------------------------------------
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+#include "src/ir/use_def_index.h"
+
+#include <memory>
+#include <utility>
+
+#include "src/common/testing/gtest.h"
+#include "src/ir/block_builder.h"
+#include "src/ir/module.h"
+#include "src/ir/operator.h"
+#include "src/ir/value.h"
+
+namespace raksha::ir {
+namespace {
+
+using testing::ElementsAre;
+using testing::Field;
+using testing::IsEmpty;
+
+class UseDefIndexTest : public testing::Test {
+ protected:
+  UseDefIndexTest() : plus_("core.plus") {
+    BlockBuilder builder;
+    source_ = &builder.AddOperation(plus_, {}, {});
+    auto sink = std::make_unique<Operation>(
+        plus_, NamedAttributeMap(),
+        ValueList{source_->GetOutputValue(0), source_->GetOutputValue(0)});
+    sink_ = sink.get();
+    builder.AddOperation(std::move(sink));
+    module_.AddBlock(builder.build());
+  }
+
+  Operator plus_;
+  Module module_;
+  const Operation* source_;
+  Operation* sink_;
+};
+
+TEST_F(UseDefIndexTest, IndexesUsesAndInputs) {
+  UseDefIndex index(module_);
+  // The source operation, its result and the sink operation.
+  ASSERT_EQ(index.NumberOfNodes(), 4);
+  UseDefIndex::NodeId source_id = index.GetNodeId(source_);
+  UseDefIndex::NodeId result_id =
+      index.GetNodeId(source_->GetOutputValue(0));
+  UseDefIndex::NodeId sink_id = index.GetNodeId(sink_);
+  EXPECT_THAT(index.GetOutEdgeIds(result_id),
+              ElementsAre(Field(&UseDefIndex::IndexedNodeId::node, sink_id),
+                          Field(&UseDefIndex::IndexedNodeId::node, sink_id)));
+  EXPECT_THAT(index.GetInputIds(sink_id), ElementsAre(result_id, result_id));
+  EXPECT_THAT(index.GetInputIds(source_id), IsEmpty());
+}
+
+TEST_F(UseDefIndexTest, GetReusesIndexOfUnchangedModule) {
+  std::shared_ptr<const UseDefIndex> index = UseDefIndex::Get(module_);
+  EXPECT_EQ(UseDefIndex::Get(module_), index);
+}
+
+TEST_F(UseDefIndexTest, AddBlockInvalidatesIndex) {
+  std::shared_ptr<const UseDefIndex> index = UseDefIndex::Get(module_);
+  BlockBuilder builder;
+  const Operation& operation = builder.AddOperation(plus_, {}, {});
+  module_.AddBlock(builder.build());
+
+  std::shared_ptr<const UseDefIndex> new_index = UseDefIndex::Get(module_);
+  EXPECT_NE(new_index, index);
+  EXPECT_EQ(new_index->NumberOfNodes(), index->NumberOfNodes() + 2);
+  EXPECT_THAT(new_index->GetInputIds(new_index->GetNodeId(&operation)),
+              IsEmpty());
+}
+
+TEST_F(UseDefIndexTest, AddInputInvalidatesIndex) {
+  std::shared_ptr<const UseDefIndex> index = UseDefIndex::Get(module_);
+  sink_->AddInput(Value(value::Any()));
+
+  std::shared_ptr<const UseDefIndex> new_index = UseDefIndex::Get(module_);
+  EXPECT_NE(new_index, index);
+  EXPECT_EQ(new_index->GetInputIds(new_index->GetNodeId(sink_)).size(), 3);
+}
+
+TEST_F(UseDefIndexTest, MovedModuleInvalidatesItsIndex) {
+  Module moved_module(std::move(module_));
+  std::shared_ptr<const UseDefIndex> index = UseDefIndex::Get(moved_module);
+  sink_->AddInput(Value(value::Any()));
+  EXPECT_NE(UseDefIndex::Get(moved_module), index);
+}
+
+}  // namespace
+}  // namespace raksha::ir
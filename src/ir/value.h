@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/strings/str_format.h"
 #include "src/common/utils/iterator_range.h"
 
@@ -178,7 +179,11 @@ class Value {
 };
 
 using ValueList = std::vector<Value>;
-using ValueRange = utils::iterator_range<ValueList::const_iterator>;
+// The inputs of an operation. Most operations have at most three inputs, which
+// are then stored inside the operation instead of in an allocation of their
+// own.
+using OperationInputs = absl::InlinedVector<Value, 3>;
+using ValueRange = utils::iterator_range<OperationInputs::const_iterator>;
 using IndexedValueMap = absl::flat_hash_map<std::string, Value>;
 using IndexedValueListMap = absl::flat_hash_map<std::string, ValueList>;
 
@@ -33,10 +33,17 @@
 #include <vector>
 
 #include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "src/common/utils/filesystem.h"
 #include "src/common/utils/fold.h"
 #include "src/common/utils/map_iter.h"
 #include "src/common/utils/overloaded.h"
 #include "src/common/utils/types.h"
+#include "src/ir/arena.h"
 #include "src/ir/attributes/attribute.h"
 #include "src/ir/attributes/float_attribute.h"
 #include "src/ir/attributes/int_attribute.h"
@@ -56,11 +63,15 @@ namespace raksha::parser::ir {
 using ir_parser_generator::IrBaseVisitor;
 using ir_parser_generator::IrLexer;
 using ir_parser_generator::IrParser;
+using raksha::ir::Arena;
+using raksha::ir::ArenaPtr;
+using raksha::ir::ArenaUniquePtr;
 using raksha::ir::Attribute;
 using raksha::ir::BlockBuilder;
 using raksha::ir::FloatAttribute;
 using raksha::ir::Int64Attribute;
 using raksha::ir::IRContext;
+using raksha::ir::MakeUniqueInArena;
 using raksha::ir::Module;
 using raksha::ir::NamedAttributeMap;
 using raksha::ir::Operation;
@@ -114,7 +125,7 @@ class IrVisitor : public IrBaseVisitor {
  public:
   explicit IrVisitor()
       : result_{.context = std::make_unique<IRContext>(),
-                .module = std::make_unique<Module>(),
+                .module = std::make_unique<Module>(Arena::Create()),
                 .ssa_names = std::make_unique<SsaNames>()} {}
 
   Any visitStringLiteral(
@@ -165,18 +176,20 @@ class IrVisitor : public IrBaseVisitor {
     if (text.back() == 'l') {
       text = text.substr(0, text.size() - 1);
     }
-    bool conversion_succeeds = absl::SimpleAtod(text, &parsed_float);
-    CHECK(conversion_succeeds == true);
+    if (!absl::SimpleAtod(text, &parsed_float)) {
+      RecordError(absl::StrCat("Invalid float literal: ", text));
+    }
     return Attribute::Create<FloatAttribute>(parsed_float);
   }
 
   Any visitNumAttribute(
       IrParser::NumAttributeContext* num_attribute_context) override {
     int64_t parsed_int = 0;
-    bool conversion_succeeds = absl::SimpleAtoi(
-        ABSL_DIE_IF_NULL(num_attribute_context)->numLiteral->getText(),
-        &parsed_int);
-    CHECK(conversion_succeeds == true);
+    std::string text =
+        ABSL_DIE_IF_NULL(num_attribute_context)->numLiteral->getText();
+    if (!absl::SimpleAtoi(text, &parsed_int)) {
+      RecordError(absl::StrCat("Invalid number literal: ", text));
+    }
     return Attribute::Create<Int64Attribute>(parsed_int);
   }
 
@@ -205,8 +218,10 @@ class IrVisitor : public IrBaseVisitor {
               CheckAnyCast<std::pair<std::string, Attribute>>(
                   context->accept(this));
           auto insert_result = attribute_map.insert(name_attribute_pair);
-          CHECK(insert_result.second) << "Multiple attributes with name: "
-                                      << insert_result.first->first;
+          if (!insert_result.second) {
+            RecordError(absl::StrCat("Multiple attributes with name: ",
+                                     insert_result.first->first));
+          }
           return attribute_map;
         });
   }
@@ -230,8 +245,9 @@ class IrVisitor : public IrBaseVisitor {
   }
 
   Any visitBlock(IrParser::BlockContext* block_context) override {
-    BlockBuilder block_builder;
-    std::vector<std::pair<std::unique_ptr<Operation>, std::vector<ValueId>>>
+    // Blocks and operations are allocated in the arena of the module.
+    BlockBuilder block_builder(ArenaPtr(result_.module->arena()));
+    std::vector<std::pair<ArenaUniquePtr<Operation>, std::vector<ValueId>>>
         operations_and_inputs;
     absl::flat_hash_map<std::string, Value> temporary_name_to_value;
 
@@ -251,9 +267,9 @@ class IrVisitor : public IrBaseVisitor {
           MaybeRegisterOperator(operation_result.operator_name,
                                 operation_result.op_result_ids.size());
       operations_and_inputs.push_back(
-          {std::make_unique<Operation>(nullptr, op,
-                                       std::move(operation_result.attributes),
-                                       ValueList()),
+          {MakeUniqueInArena<Operation>(
+               block_builder.arena(), nullptr, op,
+               std::move(operation_result.attributes), ValueList()),
            std::move(operation_result.input_ids)});
       const Operation& operation = *operations_and_inputs.back().first;
       for (uint64_t index = 0; index < operation_result.op_result_ids.size();
@@ -266,11 +282,16 @@ class IrVisitor : public IrBaseVisitor {
         auto insert_result = temporary_name_to_value.insert(
             {std::get<TemporaryId>(id).name,
              raksha::ir::Value::MakeOperationResultValue(operation, index)});
-        CHECK(insert_result.second)
-            << "Found temporary name which was assigned to twice: "
-            << insert_result.first->first;
+        if (!insert_result.second) {
+          RecordError(
+              absl::StrCat("Found temporary name which was assigned to twice: ",
+                           insert_result.first->first));
+        }
       }
     }
+    // The operations of an erroneous block may not fit together, so do not
+    // go on building them.
+    if (!status_.ok()) return Unit();
 
     // Now that we have collected all temporary values in one structure, add
     // all of them to `SsaNames`.
@@ -282,17 +303,21 @@ class IrVisitor : public IrBaseVisitor {
     // to the block.
     for (auto& [operation, inputs] : operations_and_inputs) {
       ValueList input_list = utils::MapIter<Value>(
-          inputs, [&temporary_name_to_value](const ValueId& id) {
+          inputs, [this, &temporary_name_to_value](const ValueId& id) {
             return std::visit(
                 utils::overloaded{
                     [](AnyId any_id) {
                       return Value(raksha::ir::value::Any());
                     },
-                    [&temporary_name_to_value](TemporaryId temporary_id) {
+                    [this, &temporary_name_to_value](
+                        TemporaryId temporary_id) {
                       auto find_result =
                           temporary_name_to_value.find(temporary_id.name);
-                      CHECK(find_result != temporary_name_to_value.end())
-                          << "Value not found!";
+                      if (find_result == temporary_name_to_value.end()) {
+                        RecordError(absl::StrCat("Value not found: %",
+                                                 temporary_id.name));
+                        return Value(raksha::ir::value::Any());
+                      }
                       return find_result->second;
                     }},
                 id);
@@ -302,6 +327,7 @@ class IrVisitor : public IrBaseVisitor {
       }
       block_builder.AddOperation(std::move(operation));
     }
+    if (!status_.ok()) return Unit();
     result_.module->AddBlock(block_builder.build());
     return Unit();
   }
@@ -318,12 +344,23 @@ class IrVisitor : public IrBaseVisitor {
     return Unit();
   }
 
-  IrProgramParserResult TakeResult() { return std::move(result_); }
+  // Returns the result of the parse, or the first error found in the
+  // program, such as a use of an undefined value.
+  absl::StatusOr<IrProgramParserResult> TakeResult() {
+    if (!status_.ok()) return status_;
+    return std::move(result_);
+  }
 
  private:
+  // Records `message` as an error of the program unless an earlier error has
+  // been recorded.
+  void RecordError(absl::string_view message) {
+    if (status_.ok()) status_ = absl::InvalidArgumentError(message);
+  }
+
   // A helper function that idempotently registers an operator and returns a
-  // reference to it. Will fault if the operator has an inconsistent number of
-  // return values.
+  // reference to it. Records an error if the operator has an inconsistent
+  // number of return values.
   const Operator& MaybeRegisterOperator(absl::string_view operator_name,
                                         size_t num_results) {
     IRContext& context = *result_.context;
@@ -333,10 +370,12 @@ class IrVisitor : public IrBaseVisitor {
     } else {
       const Operator& op =
           *ABSL_DIE_IF_NULL(context.GetOperator(operator_name));
-      CHECK(op.number_of_return_values() == num_results)
-          << "Operator has different number of return values in different "
-             "instances "
-          << operator_name;
+      if (op.number_of_return_values() != num_results) {
+        RecordError(absl::StrCat(
+            "Operator has different number of return values in different "
+            "instances ",
+            operator_name));
+      }
       return op;
     }
   }
@@ -348,12 +387,171 @@ class IrVisitor : public IrBaseVisitor {
   }
 
   IrProgramParserResult result_;
+  absl::Status status_;
 };
+
+constexpr absl::string_view kSyntaxErrorMessage =
+    "Encountered syntax errors in IR parser, stopping!";
+
+bool IsIdStart(char c) {
+  return absl::ascii_isalpha(c) || c == '_' || c == '/' || c == '.';
+}
+
+bool IsIdChar(char c) { return IsIdStart(c) || absl::ascii_isdigit(c); }
+
+// Returns the position of the first `{` or `}` at or after `pos` in `text`
+// that is a token of its own rather than a part of a comment or of a string
+// literal, or `npos` if there is none. The text is split into tokens the way
+// `IrLexer` splits it, as far as finding braces needs: `//` and `/*` only
+// start a comment at the start of a token, and not, e.g., inside an `ID`.
+size_t FindNextBrace(absl::string_view text, size_t pos) {
+  auto skip_while = [&](auto predicate) {
+    while (pos < text.size() && predicate(text[pos])) ++pos;
+  };
+  auto skip_past = [&](absl::string_view terminator) {
+    size_t end = text.find(terminator, pos);
+    pos = end == absl::string_view::npos ? text.size()
+                                         : end + terminator.size();
+  };
+  while (pos < text.size()) {
+    char c = text[pos];
+    if (c == '{' || c == '}') return pos;
+    if (absl::StartsWith(text.substr(pos), "//")) {
+      pos += 2;
+      skip_past("\n");
+    } else if (absl::StartsWith(text.substr(pos), "/*")) {
+      pos += 2;
+      skip_past("*/");
+    } else if (c == '"') {
+      ++pos;
+      skip_past("\"");
+    } else if (IsIdStart(c)) {
+      skip_while(IsIdChar);
+    } else if (c == '%') {
+      ++pos;
+      if (pos < text.size() && IsIdStart(text[pos])) {
+        skip_while(IsIdChar);
+      } else {
+        skip_while(absl::ascii_isdigit);
+      }
+    } else if (absl::ascii_isdigit(c)) {
+      // A number may go on as a float literal. Its tail has to be skipped as
+      // a whole, as a `.` in it would otherwise start an `ID`.
+      skip_while(absl::ascii_isdigit);
+      if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        skip_while(absl::ascii_isdigit);
+      }
+      if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        size_t exponent = pos + 1;
+        if (exponent < text.size() &&
+            (text[exponent] == '+' || text[exponent] == '-')) {
+          ++exponent;
+        }
+        if (exponent < text.size() && absl::ascii_isdigit(text[exponent])) {
+          pos = exponent;
+          skip_while(absl::ascii_isdigit);
+        }
+      }
+      if (pos < text.size() && text[pos] == 'l') ++pos;
+    } else {
+      ++pos;
+    }
+  }
+  return absl::string_view::npos;
+}
+
+absl::Status SyntaxError() {
+  return absl::InvalidArgumentError(kSyntaxErrorMessage);
+}
+
+// Returns the tokens of `text`, or an error if it has lexical errors.
+absl::StatusOr<std::vector<std::unique_ptr<antlr4::Token>>> Tokenize(
+    absl::string_view text) {
+  antlr4::ANTLRInputStream input(text);
+  IrLexer lexer(&input);
+  std::vector<std::unique_ptr<antlr4::Token>> tokens = lexer.getAllTokens();
+  if (lexer.getNumberOfSyntaxErrors() != 0) return SyntaxError();
+  return tokens;
+}
+
+// Returns whether `text` consists of nothing but comments and whitespace.
+bool HasNoTokens(absl::string_view text) {
+  absl::StatusOr<std::vector<std::unique_ptr<antlr4::Token>>> tokens =
+      Tokenize(text);
+  return tokens.ok() && tokens->empty();
+}
+
+// Parses `block_text`, which must hold exactly one block, and adds the block
+// to the module of `ir_visitor`. The parse tree of the block is gone once
+// this returns.
+absl::Status ParseBlock(absl::string_view block_text, IrVisitor& ir_visitor) {
+  antlr4::ANTLRInputStream input(block_text);
+  IrLexer lexer(&input);
+  antlr4::CommonTokenStream tokens(&lexer);
+  IrParser parser(&tokens);
+  IrParser::BlockContext& block_context = *ABSL_DIE_IF_NULL(parser.block());
+  if (parser.getNumberOfSyntaxErrors() != 0 ||
+      tokens.LA(1) != antlr4::Token::EOF) {
+    return SyntaxError();
+  }
+  ir_visitor.visitBlock(&block_context);
+  return absl::OkStatus();
+}
+
+// Parses a program one block at a time. The text of each block is found
+// without parsing by looking for the braces that close the blocks, as the
+// braces of a block cannot nest.
+absl::StatusOr<IrProgramParserResult> ParseProgramBlockByBlock(
+    absl::string_view prog_text) {
+  size_t module_open = FindNextBrace(prog_text, 0);
+  if (module_open == absl::string_view::npos ||
+      prog_text[module_open] != '{') {
+    return SyntaxError();
+  }
+  absl::StatusOr<std::vector<std::unique_ptr<antlr4::Token>>> header =
+      Tokenize(prog_text.substr(0, module_open + 1));
+  if (!header.ok()) return header.status();
+  if (header->size() != 3 || (*header)[0]->getType() != IrLexer::MODULE ||
+      (*header)[1]->getType() != IrLexer::ID) {
+    return SyntaxError();
+  }
+
+  IrVisitor ir_visitor;
+  size_t block_start = module_open + 1;
+  while (true) {
+    size_t block_open = FindNextBrace(prog_text, block_start);
+    if (block_open == absl::string_view::npos) return SyntaxError();
+    if (prog_text[block_open] == '}') {
+      // This closes the module, so only comments may be left around it.
+      if (!HasNoTokens(
+              prog_text.substr(block_start, block_open - block_start)) ||
+          !HasNoTokens(prog_text.substr(block_open + 1))) {
+        return SyntaxError();
+      }
+      break;
+    }
+    size_t block_close = FindNextBrace(prog_text, block_open + 1);
+    if (block_close == absl::string_view::npos ||
+        prog_text[block_close] != '}') {
+      return SyntaxError();
+    }
+    absl::Status block_status = ParseBlock(
+        prog_text.substr(block_start, block_close + 1 - block_start),
+        ir_visitor);
+    if (!block_status.ok()) return block_status;
+    block_start = block_close + 1;
+  }
+  return ir_visitor.TakeResult();
+}
+
 }  // namespace
 
-/// This function produces an abstract syntax tree (AST) rooted with a
-/// program node when given the textual representation of a program.
-IrProgramParserResult ParseProgram(absl::string_view prog_text) {
+absl::StatusOr<IrProgramParserResult> TryParseProgram(
+    absl::string_view prog_text, ParseMode mode) {
+  if (mode == ParseMode::kBlockByBlock) {
+    return ParseProgramBlockByBlock(prog_text);
+  }
   // Provide the input text in a stream
   antlr4::ANTLRInputStream input(prog_text);
   // Creates a lexer from input
@@ -366,8 +564,7 @@ IrProgramParserResult ParseProgram(absl::string_view prog_text) {
   IrParser::IrProgramContext& program_context =
       *ABSL_DIE_IF_NULL(parser.irProgram());
 
-  CHECK(parser.getNumberOfSyntaxErrors() == 0)
-      << "Encountered syntax errors in IR parser, stopping!";
+  if (parser.getNumberOfSyntaxErrors() != 0) return SyntaxError();
 
   IrVisitor ir_visitor;
   ir_visitor.visitIrProgram(&program_context);
@@ -375,4 +572,22 @@ IrProgramParserResult ParseProgram(absl::string_view prog_text) {
   return ir_visitor.TakeResult();
 }
 
+/// This function produces an abstract syntax tree (AST) rooted with a
+/// program node when given the textual representation of a program.
+IrProgramParserResult ParseProgram(absl::string_view prog_text,
+                                   ParseMode mode) {
+  absl::StatusOr<IrProgramParserResult> result =
+      TryParseProgram(prog_text, mode);
+  CHECK(result.ok()) << result.status().message();
+  return *std::move(result);
+}
+
+absl::StatusOr<IrProgramParserResult> ParseProgramFile(
+    const std::filesystem::path& path, ParseMode mode) {
+  absl::StatusOr<common::utils::MappedFile> file =
+      common::utils::MappedFile::Open(path);
+  if (!file.ok()) return file.status();
+  return TryParseProgram(file->contents(), mode);
+}
+
 }  // namespace raksha::parser::ir
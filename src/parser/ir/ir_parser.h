@@ -20,8 +20,11 @@
 #ifndef SRC_PARSER_IR_IR_PARSER_H_
 #define SRC_PARSER_IR_IR_PARSER_H_
 
+#include <filesystem>
 #include <string>
 
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "src/ir/ir_context.h"
 #include "src/ir/module.h"
 #include "src/ir/ssa_names.h"
@@ -34,7 +37,34 @@ struct IrProgramParserResult {
   std::unique_ptr<raksha::ir::SsaNames> ssa_names;
 };
 
-IrProgramParserResult ParseProgram(absl::string_view prog_text);
+// How the text of a program is turned into a module.
+enum class ParseMode {
+  // Builds the parse tree of the whole program, then the module from it.
+  kWholeProgram,
+  // Parses the program one top-level block at a time. The operations of each
+  // block are built as soon as it is parsed, and its parse tree is discarded
+  // before the next block is parsed, so that peak memory is bounded by the
+  // largest block rather than by the whole program. The resulting module and
+  // names are the same as with `kWholeProgram`.
+  kBlockByBlock,
+};
+
+// Parses the program in `prog_text`. Dies if the program is malformed.
+IrProgramParserResult ParseProgram(
+    absl::string_view prog_text, ParseMode mode = ParseMode::kWholeProgram);
+
+// Parses the program in `prog_text`. Returns an error if the program has
+// syntax errors or is otherwise malformed, e.g., if it uses a value that it
+// does not define.
+absl::StatusOr<IrProgramParserResult> TryParseProgram(
+    absl::string_view prog_text, ParseMode mode = ParseMode::kWholeProgram);
+
+// Parses the program in the file at `path`. The file is mapped into memory
+// rather than read, and is parsed block by block unless `mode` says otherwise.
+// Returns an error if the file cannot be read or the program is malformed.
+absl::StatusOr<IrProgramParserResult> ParseProgramFile(
+    const std::filesystem::path& path,
+    ParseMode mode = ParseMode::kBlockByBlock);
 
 }  // namespace raksha::parser::ir
 
@@ -16,7 +16,13 @@
 //-------------------------------------------------------------------------------
 #include "src/parser/ir/ir_parser.h"
 
+#include <filesystem>
+#include <fstream>
+#include <tuple>
+
+#include "absl/status/statusor.h"
 #include "src/common/testing/gtest.h"
+#include "src/common/utils/filesystem.h"
 #include "src/ir/ir_printer.h"
 
 namespace raksha::parser::ir {
@@ -33,6 +39,13 @@ TEST_P(IrParserRoundtripTest, SimpleTestOperation) {
             input_program_text);
 }
 
+TEST_P(IrParserRoundtripTest, BlockByBlockParseAgreesWithWholeParse) {
+  auto input_program_text = GetParam();
+  auto result = ParseProgram(input_program_text, ParseMode::kBlockByBlock);
+  EXPECT_EQ(IRPrinter::ToString(*result.module, *result.ssa_names),
+            input_program_text);
+}
+
 INSTANTIATE_TEST_SUITE_P(IrParserRoundtripTest, IrParserRoundtripTest,
                          ::testing::Values(
                              R"(module m0 {
@@ -303,4 +316,109 @@ TEST(IrParserSyntaxErrorDeathTest, IrParserSyntaxErrorDeathTest) {
   EXPECT_DEATH(ParseProgram("This is not a valid IR program."),
                ".*Encountered syntax errors in IR parser, stopping!.*");
 }
+
+TEST(IrParserBlockByBlockTest, FindsBlocksAroundCommentsAndIds) {
+  auto input_program_text = R"(module m0 {  /* } { */
+  block a//b {  // }
+    %0 = a//b.c [s: "}"]()
+    %1 = core.plus [](%0)// {
+  }  // block a//b
+  block b1 {
+  }
+}  // module m0
+)";
+  auto result = ParseProgram(input_program_text, ParseMode::kBlockByBlock);
+  EXPECT_EQ(IRPrinter::ToString(*result.module, *result.ssa_names),
+            R"(module m0 {
+  block b0 {
+    %0 = a//b.c [s: "}"]()
+    %1 = core.plus [](%0)
+  }  // block b0
+  block b1 {
+  }  // block b1
+}  // module m0
+)");
+}
+
+class IrParserBlockByBlockSyntaxErrorDeathTest
+    : public testing::TestWithParam<absl::string_view> {};
+
+TEST_P(IrParserBlockByBlockSyntaxErrorDeathTest, DiesOnSyntaxErrors) {
+  EXPECT_DEATH(ParseProgram(GetParam(), ParseMode::kBlockByBlock),
+               ".*Encountered syntax errors in IR parser, stopping!.*");
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    IrParserBlockByBlockSyntaxErrorDeathTest,
+    IrParserBlockByBlockSyntaxErrorDeathTest,
+    ::testing::Values("This is not a valid IR program.",
+                      "module m0 { block b0 { }",
+                      "module m0 { block b0 { } } block b1 { }",
+                      "module m0 { block b0 { block b1 { } } }",
+                      "module m0 { block b0 { %0 = core.plus []() %1 } }",
+                      "module m0 { %0 = core.plus []() }",
+                      "module { block b0 { } }"));
+
+class IrTryParseProgramTest
+    : public testing::TestWithParam<std::tuple<ParseMode, absl::string_view>> {
+};
+
+TEST_P(IrTryParseProgramTest, ReturnsErrorsOnMalformedPrograms) {
+  const auto& [mode, program_text] = GetParam();
+  absl::StatusOr<IrProgramParserResult> result =
+      TryParseProgram(program_text, mode);
+  EXPECT_EQ(result.status().code(), absl::StatusCode::kInvalidArgument);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    IrTryParseProgramTest, IrTryParseProgramTest,
+    ::testing::Combine(
+        ::testing::Values(ParseMode::kWholeProgram, ParseMode::kBlockByBlock),
+        ::testing::Values(
+            "This is not a valid IR program.", "module m0 { block b0 { }",
+            "module m0 { block b0 { %0 = core.plus []() %1 } }",
+            "module m0 { block b0 { %0 = core.plus [](%1) } }",
+            "module m0 { block b0 { %0 = core.plus []() %0 = core.plus []() "
+            "} }",
+            "module m0 { block b0 { %0 = core.plus [a: 1, a: 2]() } }",
+            "module m0 { block b0 { %0 = core.plus [a: "
+            "99999999999999999999]() } }",
+            "module m0 { block b0 { %0 = core.pair []() %1, %2 = core.pair "
+            "[]() } }")));
+
+TEST(IrTryParseProgramTest, ParsesWellFormedPrograms) {
+  absl::StatusOr<IrProgramParserResult> result =
+      TryParseProgram("module m0 { block b0 { %0 = core.plus []() } }");
+  ASSERT_TRUE(result.ok()) << result.status();
+  EXPECT_EQ(result->module->blocks().size(), 1);
+}
+
+TEST(IrParseProgramFileTest, ParsesMappedFile) {
+  absl::string_view program_text = R"(module m0 {
+  block b0 {
+    %0 = core.plus []()
+  }  // block b0
+  block b1 {
+    %1 = core.plus [access: "private"](%1, <<ANY>>)
+  }  // block b1
+}  // module m0
+)";
+  absl::StatusOr<std::filesystem::path> directory =
+      common::utils::CreateTemporaryDirectory();
+  ASSERT_TRUE(directory.ok()) << directory.status();
+  std::filesystem::path path = *directory / "program.ir";
+  std::ofstream(path) << program_text;
+
+  for (ParseMode mode : {ParseMode::kWholeProgram, ParseMode::kBlockByBlock}) {
+    absl::StatusOr<IrProgramParserResult> result = ParseProgramFile(path, mode);
+    ASSERT_TRUE(result.ok()) << result.status();
+    EXPECT_EQ(IRPrinter::ToString(*result->module, *result->ssa_names),
+              program_text);
+  }
+  std::filesystem::remove_all(*directory);
+}
+
+TEST(IrParseProgramFileTest, FailsOnMissingFile) {
+  EXPECT_FALSE(ParseProgramFile("/nonexistent/program.ir").ok());
+}
 }  // namespace raksha::parser::ir
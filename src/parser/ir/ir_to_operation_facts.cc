@@ -17,25 +17,32 @@
 #include <filesystem>
 #include <fstream>
 #include <iostream>
-#include <sstream>
 #include <string>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/flags/usage.h"
-#include "absl/strings/str_join.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "src/backends/policy_engine/souffle/binary_facts.h"
 #include "src/backends/policy_engine/souffle/datalog_lowering_visitor.h"
+#include "src/backends/policy_engine/souffle/raksha_datalog_facts.h"
 #include "src/parser/ir/ir_parser.h"
 
 ABSL_FLAG(std::string, ir_file, "", "The file containing the IR program.");
 ABSL_FLAG(std::string, out, "",
           "The file to which we should write the resulting isOperation facts.");
+ABSL_FLAG(bool, binary, false,
+          "Write the facts in the binary facts format rather than as a text "
+          ".facts file.");
 
 namespace raksha::parser::ir {
 namespace {
 
+using ::raksha::backends::policy_engine::souffle::BinaryFactsWriter;
 using ::raksha::backends::policy_engine::souffle::DatalogLoweringVisitor;
+using ::raksha::backends::policy_engine::souffle::WriteFactsFileLines;
 
 constexpr char kUsageMessage[] =
     "This tool takes a Raksha IR file and generates an `isOperation.facts` "
@@ -52,35 +59,43 @@ int MainInner(int argc, char** argv) {
     return 1;
   }
 
-  std::ifstream ir_stream(ir_path);
-  if (!ir_stream) {
-    LOG(ERROR) << "Error reading IR file " << ir_path << ":" << strerror(errno);
+  absl::StatusOr<IrProgramParserResult> result = ParseProgramFile(ir_path);
+  if (!result.ok()) {
+    LOG(ERROR) << "Error reading IR file " << ir_path << ": "
+               << result.status();
     return 1;
   }
-
-  std::ostringstream string_stream;
-  string_stream << ir_stream.rdbuf();
-
-  IrProgramParserResult result = ParseProgram(string_stream.str());
-  DatalogLoweringVisitor datalog_lowering_visitor(std::move(*result.ssa_names));
-  result.module->Accept(datalog_lowering_visitor);
+  DatalogLoweringVisitor datalog_lowering_visitor(
+      std::move(*result->ssa_names));
+  result->module->Accept(datalog_lowering_visitor);
 
   std::filesystem::path out_path =
       std::filesystem::path(absl::GetFlag(FLAGS_out));
+  if (absl::GetFlag(FLAGS_binary)) {
+    BinaryFactsWriter writer;
+    writer.AddFacts(absl::MakeConstSpan(
+        datalog_lowering_visitor.datalog_facts().is_operation_facts()));
+    absl::Status status = writer.WriteToFile(out_path);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+      return 1;
+    }
+    return 0;
+  }
   std::ofstream out_stream(out_path,
                            std::ios::out | std::ios::trunc | std::ios::binary);
   if (!out_stream) {
     LOG(ERROR) << "Error creating " << out_path << ":" << strerror(errno);
     return 1;
   }
-  out_stream
-      << absl::StrJoin(
-             datalog_lowering_visitor.datalog_facts().is_operation_facts(),
-             "\n",
-             [](std::string* out, const auto& arg) {
-               absl::StrAppend(out, arg.ToDatalogFactsFileString());
-             })
-      << "\n";
+  WriteFactsFileLines(
+      absl::MakeConstSpan(
+          datalog_lowering_visitor.datalog_facts().is_operation_facts()),
+      out_stream);
+  if (!out_stream.flush()) {
+    LOG(ERROR) << "Error writing " << out_path << ":" << strerror(errno);
+    return 1;
+  }
   return 0;
 }
 